@@ -1,10 +1,22 @@
 #include "LuTopologyGenerator.h"
+#include "../multi/components.h"
+#include "../multi/removalProfile.h"
+#include "../multi/ballSearch.h"
+#include "../multi/cores.h"
+#include "../multi/triangles.h"
+#include "../multi/hopDistances.h"
+#include "../multi/degreeStats.h"
+#include "../multi/parallel.h"
 #include <queue>
 #include <algorithm>
 #include <string>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
+#include <fstream>
 #include <iostream>
+#include <glob.h>
 
 #define WHITE 0
 #define GRAY 1
@@ -15,26 +27,107 @@ using namespace std;
 typedef hash_map<int, multiNode*> node_hash_t;
 typedef hash_map<int, multiEdge*> edge_hash_t;
 
+// Settings shared by every file analyzed in a run.
+
+typedef struct {
+
+   // Number of highest-degree nodes, and sizes of the neighborhoods
+   // around them, to remove from the giant component.  Each neighborhood
+   // size gives one record.
+
+   int topCount;
+   vector<int> neighborhoodSizes;
+
+   // If [maxNeighborhoodSize] isn't negative, also profile the removal of
+   // every neighborhood size and number of nodes up to these.
+
+   int maxTopCount;
+   int maxNeighborhoodSize;
+
+   // Field separator for records.
+
+   const char* separator;
+
+   // If [cores] is set, end each record with the maximum coreness in G and
+   // the sizes of its k-cores, k = 1 .. that maximum, joined by ';'.  If
+   // [coreFiles] is set, also write each node's coreness to the file
+   // <graph file>.core, one "ID coreness" line per node.
+
+   bool cores;
+   bool coreFiles;
+
+   // If [clustering] is set, end each record [after any core fields] with
+   // the number of triangles in G, its global clustering coefficient and
+   // its average local clustering coefficient.
+
+   bool clustering;
+
+   // If [distanceSources] is positive, end each record [after any
+   // clustering fields] with estimates from that many BFS sources in the
+   // giant component: the average distance and the 90% effective
+   // diameter, each followed by the bounds of its 95% confidence interval,
+   // and the fraction of pairs at each distance 1, 2, .. joined by ';'.
+
+   int distanceSources;
+
+   // If [degrees] is set, end each record [after any distance fields] with
+   // the maximum degree in G and a discrete power-law fit to its degree
+   // distribution: the exponent, its standard error, the smallest degree
+   // fitted, the number of nodes fitted and the Kolmogorov-Smirnov
+   // distance [all -1 if there's too little to fit].
+
+   bool degrees;
+
+   // If [replayLogs] is set, replay the binary update log <graph file>.log
+   // [see updateLog.h] onto each graph before analyzing it.
+
+   bool replayLogs;
+
+} analysisSettings;
+
 
 void indexComponents(multiGraphManager* mgm,
       hash_map<int, hash_set<int> >& componentHash);
 
 bool indexComponentsAndCheckCycles(multiGraphManager* mgm,
-      hash_map<int, hash_set<int> >& componentHash, hash_set<int>& cyclicComponents);
+      componentIndex& components, vector<int>& nodeIDs);
    
-void countHighestDegreeNodes(multiGraphManager* mgm, int N, queue<int>& highestDegreeNodes);
+void extractComponent(multiGraphManager* mgm, const componentIndex& components,
+      const vector<int>& nodeIDs, int targetComponent);
 
-void extractComponent(multiGraphManager* mgm, hash_set<int> targetComponent);
+void identifyNeighborhood(const frozenGraph& frozen, ballSearch& search, int centerID, int size,
+      vector<int>& storage);
 
-void identifyNeighborhood(multiGraphManager* mgm, int centerID, int size, vector<int>& storage);
+void sweepNeighborhoodRemoval(multiGraphManager* mgm, int maxTopCount,
+      int maxNeighborhoodSize, ostream& out);
 
 bool isForest(multiGraphManager* mgm);
 
 bool isInTreeComponent(int node, multiGraphManager* mgm);
 
 int countComponentsWithCycles(multiGraphManager* mgm, hash_map<int, hash_set<int> > components);
-int countExtraEdges(          multiGraphManager* mgm, hash_map<int, hash_set<int> > components,
-      hash_set<int> cyclicComponents);
+
+void analyzeFile(char* filename, char* scratchFilename, const analysisSettings& settings,
+      vector<string>& records, string& sweep);
+
+void appendComponentFields(const componentIndex& components, const char* separator,
+      string& record);
+
+void appendCoreFields(char* filename, multiGraphManager* mgm, const analysisSettings& settings,
+      string& coreFields);
+
+void appendClusteringFields(multiGraphManager* mgm, const analysisSettings& settings,
+      string& clusteringFields);
+
+void appendDistanceFields(const frozenGraph& giant, const analysisSettings& settings,
+      string& distanceFields);
+
+void appendDegreeFields(multiGraphManager* mgm, const analysisSettings& settings,
+      string& degreeFields);
+
+void takeFlags(int& argc, char* argv[], analysisSettings& settings);
+
+int runBatch(int argc, char* argv[], analysisSettings& settings);
 
 template <class T>
 string to_string(T t) {
@@ -49,12 +142,28 @@ string to_string(T t) {
 
 int main(int argc, char* argv[]) {
 
+   analysisSettings settings;
+   
+   settings.cores = false;
+   settings.coreFiles = false;
+   settings.clustering = false;
+   settings.distanceSources = 0;
+   settings.degrees = false;
+   settings.replayLogs = false;
+   
+   takeFlags(argc, argv, settings);
+   
+   // Batch mode: analyze many files at once.  [See runBatch.]
+   
+   if ( argc > 1 && strcmp(argv[1], "-batch") == 0 ) {
+      
+      return runBatch(argc, argv, settings);
+   }
+   
    char* outputfilename = "main.xml";
    char* betaArg = argv[1];
    int i = atoi(argv[2]);
    
-   multiGraphManager* mgm = new multiGraphManager(outputfilename);
-   
    // Node size for graph.
    
    int n = 20000;
@@ -77,24 +186,26 @@ int main(int argc, char* argv[]) {
    
    int neighborhoodSize = atoi(argv[3]);
    
-   // Initialize reusable data structures.
+   // Optionally, also profile the giant component under removal of every
+   // neighborhood size up to [maxNeighborhoodSize] around every number of
+   // highest-degree nodes up to [maxTopCount].
    
-   bool atEnd;
-   bool forest;
+   int maxNeighborhoodSize = ( argc > 4 ) ? atoi(argv[4]) : -1;
+   int maxTopCount = ( argc > 5 ) ? atoi(argv[5]) : topCount;
+   
+   settings.topCount = topCount;
+   settings.neighborhoodSizes.push_back(neighborhoodSize);
+   settings.maxTopCount = maxTopCount;
+   settings.maxNeighborhoodSize = maxNeighborhoodSize;
+   settings.separator = " ";
+   
+   // Initialize reusable data structures.
    
    string filename = "";
    char* final_filename;
 
-   hash_map<int, hash_set<int> > components;
-   hash_map<int, hash_set<int> >::iterator compIter;
-   
-   hash_set<int> cyclicComponents;
-   
-   vector< pair<int, int> > sortedComponentIndices;
-   vector< pair<int, int> >::iterator sortedComponentIndicesIter;
-   
-   vector<int> unionOfNeighborhoods;
-   vector<int>::iterator unionIter;
+   vector<string> records;
+   string sweep;
    
    // Run through all the files conforming to current settings & send
    // all analysis to cout.
@@ -139,589 +250,739 @@ int main(int argc, char* argv[]) {
 
 	      cerr << "Processing file " << final_filename << endl;
          
-	      mgm->processFile(final_filename);
+	      analyzeFile(final_filename, outputfilename, settings, records, sweep);
 	 
+         if ( records.empty() ) {
+            return 1;
+         }
+         
          cout << n << " " << dummyString[0] << "." << dummyString[2] << " ";
          cout << (i+1) << " ";
          
-         // Index components and check for cycles.
-
-         forest = indexComponentsAndCheckCycles(mgm, components, cyclicComponents);
+         cout << records[0] << endl;
          
-         // Reverse-sort component indices by size.
-
-         compIter = components.begin();
+         cout << sweep;
          
-         while ( compIter != components.end() ) {
+//      } // end for (each random instance at this setting)
+//
+//     beta += 0.1;
+//   }
 
-            pair<int, int> element;
-            
-            element.first = compIter->second.size();
-            element.second = compIter->first;
+   return 0;
+}
 
-            sortedComponentIndices.push_back(element);
-            compIter++;
-         }
-         
-         sort(sortedComponentIndices.begin(), sortedComponentIndices.end(),
-               greater< pair<int, int> >());
+
+// ---------------------------------SUBROUTINES-------------------------------------
+// 
+// Analyze one graph file: index the components of G, then cut G down to
+// its giant component and, for each neighborhood size, index the
+// components of G' = the giant component minus the neighborhoods around
+// its [topCount] highest-degree nodes.  Each neighborhood size gives one
+// record in [records]:
+// 
+//   components size_1 .. size_10 forest cyclic diameter
+//   neighborhoodSize topCount components' nodes' size'_1 .. size'_10
+//   diameter' forest' cyclic' extraEdges'
+// 
+// with fields joined by the settings' separator.  The giant component is
+// loaded and indexed only once, however many neighborhood sizes there
+// are; each G' is a frozen copy, so the giant component itself is never
+// touched.  [scratchFilename] is the output file for the graph manager.
+// The graph file may be XML or any format multiGraphManager::loadFile()
+// knows by its extension; if it can't be read, [records] is left empty.
+
+void analyzeFile(char* filename, char* scratchFilename, const analysisSettings& settings,
+      vector<string>& records, string& sweep) {
+   
+   const char* separator = settings.separator;
+   
+   multiGraphManager* mgm = new multiGraphManager(scratchFilename);
+   
+   records.clear();
+   sweep = "";
+   
+   if ( !mgm->loadFile(filename) ) {
+      
+      cerr << "Can't read " << filename << "; skipping it" << endl;
+      delete mgm;
+      return;
+   }
+   
+   if ( settings.replayLogs ) {
+      
+      string logFilename = string(filename) + ".log";
+      
+      if ( mgm->replayLog(logFilename.c_str()) < 0 ) {
          
-         // Print the number of components in G.
+         cerr << "Can't replay " << logFilename << endl;
+      }
+   }
+   
+   // Index components and check for cycles.
+   
+   componentIndex components;
+   vector<int> componentNodeIDs;
+   vector<int> sortedComponentIndices;
+   
+   bool forest = indexComponentsAndCheckCycles(mgm, components, componentNodeIDs);
+   
+   // Core decomposition of G, if asked for.
+   
+   string coreFields;
+   
+   appendCoreFields(filename, mgm, settings, coreFields);
+   
+   // Triangles and clustering in G, if asked for.
+   
+   string clusteringFields;
+   
+   appendClusteringFields(mgm, settings, clusteringFields);
+   
+   // Degree distribution of G, if asked for.
+   
+   string degreeFields;
+   
+   appendDegreeFields(mgm, settings, degreeFields);
+   
+   components.bySize(sortedComponentIndices);
+   
+   // Number of components in G, and sizes of the 10 largest.
+   
+   string graphFields = to_string<int>(components.size());
+   
+   appendComponentFields(components, separator, graphFields);
+   
+   if (forest) {
+      
+      graphFields += string(separator) + "1" + separator + "0";
+      
+   } else {
+      
+      graphFields += string(separator) + "0" + separator
+         + to_string<int>(components.cyclicSize());
+   }
+   
+   // Delete all vertices not in the giant component from the current graph.
+   
+   if ( components.size() > 0 ) {
+      
+      extractComponent(mgm, components, componentNodeIDs, sortedComponentIndices[0]);
+   }
+   
+   // The giant component's diameter.
+   // Currently disabled as it's slow and I need data.
+   
+   graphFields += string(separator) + "-1";
+   
+   // Identify the [topCount] highest-degree nodes.
+   
+   vector<int> centers;
+   topDegreeNodes(mgm->G, settings.topCount, centers);
+   
+   frozenGraph giant(mgm->G);
+   ballSearch search(giant);
+   
+   // Hop distances in the giant component, if asked for.
+   
+   string distanceFields;
+   
+   appendDistanceFields(giant, settings, distanceFields);
+   
+   for ( unsigned int r = 0; r < settings.neighborhoodSizes.size(); r++ ) {
+      
+      int neighborhoodSize = settings.neighborhoodSizes[r];
+      
+      string record = graphFields;
+      
+      record += separator + to_string<int>(neighborhoodSize)
+         + separator + to_string<int>(settings.topCount);
+      
+      // Remove the union of the neighborhoods around the selected
+      // high-degree vertices.
+      
+      vector<int> unionOfNeighborhoods;
+      
+      for ( unsigned int j = 0; j < centers.size(); j++ ) {
          
-         cout << components.size();
+         identifyNeighborhood(giant, search, centers[j], neighborhoodSize, unionOfNeighborhoods);
+      }
+      
+      vector<bool> keep( giant.nodeSize(), true );
+      
+      for ( unsigned int j = 0; j < unionOfNeighborhoods.size(); j++ ) {
          
-         // Print sizes for the 10 largest components.
+         keep[ giant.indexOf(unionOfNeighborhoods[j]) ] = false;
+      }
+      
+      frozenGraph remaining(giant, keep);
+      componentIndex remainingComponents;
+      
+      findComponents(remaining, remainingComponents);
+      
+      // Number of components in G', number of nodes left, and sizes of the
+      // 10 largest components.
+      
+      record += separator + to_string<int>(remainingComponents.size())
+         + separator + to_string<int>(remaining.nodeSize());
+      
+      appendComponentFields(remainingComponents, separator, record);
+      
+      // The largest remaining component's diameter.
+      // Currently disabled since it's slow and I need data.
+      
+      record += string(separator) + "-1";
+      
+      if ( remainingComponents.cyclicSize() == 0 ) {
          
-         sortedComponentIndicesIter = sortedComponentIndices.begin();
+         record += string(separator) + "1" + separator + "0" + separator + "0";
          
-         atEnd = false;
+      } else {
          
-         for ( int j = 0; j < 10; j++ ) {
-            
-            if ( sortedComponentIndicesIter == sortedComponentIndices.end() ) {
-            
-               atEnd = true;
-            }
-            
-            if ( !atEnd ) {
-            
-               cout << " " << components[(*sortedComponentIndicesIter).second].size();
-               
-            } else {
-               
-               cout << " NA";
-            }
-               
-            sortedComponentIndicesIter++;
-         }
+         record += separator + string("0")
+            + separator + to_string<int>(remainingComponents.cyclicSize())
+            + separator + to_string<long long>(remainingComponents.extraEdges());
+      }
+      
+      records.push_back(record + coreFields + clusteringFields + distanceFields
+         + degreeFields);
+   }
+   
+   if ( settings.maxNeighborhoodSize >= 0 ) {
+      
+      ostringstream out;
+      
+      sweepNeighborhoodRemoval(mgm, settings.maxTopCount, settings.maxNeighborhoodSize, out);
+      
+      sweep = out.str();
+   }
+   
+   delete mgm;
+}
+
+
+// Append the sizes of the 10 largest components to [record], or NA for
+// each that doesn't exist.
+
+void appendComponentFields(const componentIndex& components, const char* separator,
+      string& record) {
+   
+   vector<int> sortedComponentIndices;
+   
+   components.bySize(sortedComponentIndices);
+   
+   for ( int j = 0; j < 10; j++ ) {
+      
+      record += separator;
+      
+      if ( j < components.size() ) {
          
-         // (Deprecated.  'forest' is now set by indexComponentsAndCheckCycles above.)
-         // 
-         // forest = isForest(mgm);
+         record += to_string<int>(components.nodeCount[sortedComponentIndices[j]]);
          
-         if (forest) {
+      } else {
          
-            cout << " 1 0";
+         record += "NA";
+      }
+   }
+}
+
+
+// Find the coreness of every node in G and, per the settings, fill
+// [coreFields] with the fields to end each record with and write the
+// per-node coreness file.
+
+void appendCoreFields(char* filename, multiGraphManager* mgm, const analysisSettings& settings,
+      string& coreFields) {
+   
+   coreFields = "";
+   
+   if ( !settings.cores && !settings.coreFiles ) {
+      return;
+   }
+   
+   frozenGraph frozen(mgm->G);
+   coreIndex cores;
+   
+   findCores(frozen, cores);
+   
+   if ( settings.cores ) {
+      
+      coreFields += settings.separator + to_string<int>(cores.maxCore());
+      coreFields += settings.separator;
+      
+      for ( int k = 1; k <= cores.maxCore(); k++ ) {
          
-         } else {
-            
-            cout << " 0";
-            cout << " " << cyclicComponents.size();
+         if ( k > 1 ) {
+            coreFields += ";";
          }
          
-         // ------------------------------------------------------------------
+         coreFields += to_string<int>(cores.coreSize(k));
+      }
+   }
+   
+   if ( settings.coreFiles ) {
+      
+      string coreFilename = string(filename) + ".core";
+      ofstream out(coreFilename.c_str());
+      
+      for ( int j = 0; j < frozen.nodeSize(); j++ ) {
          
+         out << frozen.ids[j] << " " << cores.coreness[j] << "\n";
+      }
+   }
+}
 
-         // Delete all vertices not in the giant component from the current graph.
-         
-         extractComponent(mgm, components[sortedComponentIndices[0].second]);
-         
-         // Output the giant component's diameter.
-         // Currently disabled as it's slow and I need data.
-	 
-         // cout << " " << mgm->hopDiameter();
-            cout << " " << -1;
-         
-         // Remove the [topCount] highest-degree vertices from the giant component
-         // along with all vertices at a distance <= [neighborhoodSize] from it.
-         
-         cout << " " << neighborhoodSize << " " << topCount;
-         
-         // First, identify the [topCount] highest-degree nodes.
-         
-         // [Note: I didn't declare [highestDegreeNodes] at the top because it
-         // doesn't appear to have a 'clear()' function and this seemed the
-         // easiest equivalent.
-         
-         queue<int> highestDegreeNodes;
-         countHighestDegreeNodes(mgm, topCount, highestDegreeNodes);
-         
-         // Next, identify a [neighborhoodSize]-sized neighborhood around
-         // each.
-         
-         while ( !(highestDegreeNodes.empty()) ) {
 
-            int currentNode = highestDegreeNodes.front();
-	    
-            identifyNeighborhood(mgm, currentNode, neighborhoodSize, unionOfNeighborhoods);
+// Count the triangles in G and, if asked for, fill [clusteringFields]
+// with the fields to end each record with.
 
-            highestDegreeNodes.pop();
-         }
-         
-      	 // Finally, delete all vertices in the union of neighborhoods around
-      	 // the selected high-degree vertices.
-	 
-	      unionIter = unionOfNeighborhoods.begin();
-	 
-	      while ( unionIter != unionOfNeighborhoods.end() ) {
-	    
-	         mgm->deleteNode(*unionIter);
+void appendClusteringFields(multiGraphManager* mgm, const analysisSettings& settings,
+      string& clusteringFields) {
+   
+   clusteringFields = "";
+   
+   if ( !settings.clustering ) {
+      return;
+   }
+   
+   frozenGraph frozen(mgm->G);
+   triangleIndex triangles;
+   
+   countTriangles(frozen, triangles);
+   
+   clusteringFields += settings.separator + to_string<long long>(triangles.total);
+   clusteringFields += settings.separator + to_string<double>(triangles.globalClustering());
+   clusteringFields += settings.separator + to_string<double>(triangles.averageClustering());
+}
 
-	         unionIter++;
-	      }
-	 
-         // Index remaining components and check for cycles.
 
-         components.clear();
-         cyclicComponents.clear();
-         forest = indexComponentsAndCheckCycles(mgm, components, cyclicComponents);
-         
-         // Reverse-sort remaining component indices by size.
-         
-         sortedComponentIndices.clear();
-         compIter = components.begin();
+// Sample hop distances in the giant component and, if asked for, fill
+// [distanceFields] with the fields to end each record with.  The sources
+// are drawn with a fixed seed, so reruns agree.
+
+void appendDistanceFields(const frozenGraph& giant, const analysisSettings& settings,
+      string& distanceFields) {
+   
+   distanceFields = "";
+   
+   if ( settings.distanceSources <= 0 ) {
+      return;
+   }
+   
+   hopDistanceSample sample;
+   
+   sampleHopDistances(giant, settings.distanceSources, 1, 0.9, sample);
+   
+   distanceFields += settings.separator + to_string<double>(sample.averageDistance);
+   distanceFields += settings.separator + to_string<double>(sample.averageLow);
+   distanceFields += settings.separator + to_string<double>(sample.averageHigh);
+   distanceFields += settings.separator + to_string<double>(sample.effectiveDiameter);
+   distanceFields += settings.separator + to_string<double>(sample.effectiveLow);
+   distanceFields += settings.separator + to_string<double>(sample.effectiveHigh);
+   distanceFields += settings.separator;
+   
+   for ( int d = 1; d <= sample.maxDistance(); d++ ) {
+      
+      if ( d > 1 ) {
+         distanceFields += ";";
+      }
+      
+      distanceFields += to_string<double>(sample.fraction(d));
+   }
+}
+
+
+// Fit a power law to the degree distribution of G and, if asked for, fill
+// [degreeFields] with the fields to end each record with.
+
+void appendDegreeFields(multiGraphManager* mgm, const analysisSettings& settings,
+      string& degreeFields) {
+   
+   degreeFields = "";
+   
+   if ( !settings.degrees ) {
+      return;
+   }
+   
+   vector<int> histogram;
+   powerLawFit fit;
+   
+   degreeHistogram(mgm->G, histogram);
+   
+   degreeFields += settings.separator + to_string<int>((int) histogram.size() - 1);
+   
+   if ( !fitPowerLaw(histogram, fit) ) {
+      
+      for ( int j = 0; j < 5; j++ ) {
+         degreeFields += string(settings.separator) + "-1";
+      }
+      
+      return;
+   }
+   
+   degreeFields += settings.separator + to_string<double>(fit.alpha);
+   degreeFields += settings.separator + to_string<double>(fit.alphaError);
+   degreeFields += settings.separator + to_string<int>(fit.xmin);
+   degreeFields += settings.separator + to_string<int>(fit.tailSize);
+   degreeFields += settings.separator + to_string<double>(fit.distance);
+}
+
+
+// Pull the optional flags [-cores, -coreFiles, -clustering, -distances[=N], -degrees,
+// -log] out of the argument list, wherever they are, and note them in [settings].
+// -distances alone samples DISTANCE_SOURCES sources.
+
+void takeFlags(int& argc, char* argv[], analysisSettings& settings) {
+   
+   int kept = 1;
+   
+   for ( int j = 1; j < argc; j++ ) {
+      
+      if ( strcmp(argv[j], "-cores") == 0 ) {
          
-         while ( compIter != components.end() ) {
-            
-            pair<int, int> element;
-               
-            element.first = compIter->second.size();
-            element.second = compIter->first;
-            
-            sortedComponentIndices.push_back(element);
-            compIter++;
-         }
+         settings.cores = true;
          
-         sort(sortedComponentIndices.begin(), sortedComponentIndices.end(),
-               greater< pair<int, int> >());
+      } else if ( strcmp(argv[j], "-coreFiles") == 0 ) {
          
-         // Print the number of components in G'.
+         settings.coreFiles = true;
          
-         cout << " " << components.size() << " " << mgm->nodeSize();
+      } else if ( strcmp(argv[j], "-clustering") == 0 ) {
          
-         // Print the sizes of the 10 largest components in G'.
+         settings.clustering = true;
          
-         sortedComponentIndicesIter = sortedComponentIndices.begin();
-                  
-         atEnd = false;
-                  
-         for ( int j = 0; j < 10; j++ ) {
-            
-            if ( sortedComponentIndicesIter == sortedComponentIndices.end() ) {
-            
-               atEnd = true;
-            }
-            
-            if ( !atEnd ) {
-            
-               cout << " " << components[(*sortedComponentIndicesIter).second].size();
-               
-            } else {
-               
-               cout << " NA";
-            }
-            
-            sortedComponentIndicesIter++;
-         }
+      } else if ( strcmp(argv[j], "-distances") == 0 ) {
          
-         // Output the largest remaining component's diameter.
-         // Currently disabled since it's slow and I need data.
-	 
-         // cout << " " << mgm->hopDiameter();
-            cout << " " << -1;
+         settings.distanceSources = DISTANCE_SOURCES;
          
-         // (Deprecated.  'forest' is set by indexComponentsAndCheckCycles above.)
-         // 
-         // forest = isForest(mgm);
+      } else if ( strncmp(argv[j], "-distances=", 11) == 0 ) {
          
-         if (forest) {
+         settings.distanceSources = atoi(argv[j] + 11);
          
-            cout << " 1 0 0";
+      } else if ( strcmp(argv[j], "-degrees") == 0 ) {
          
-         } else {
+         settings.degrees = true;
          
-            cout << " 0";
-            
-            cout << " " << cyclicComponents.size();
-            
-	         cout << " " << countExtraEdges(mgm, components, cyclicComponents);
-         }
+      } else if ( strcmp(argv[j], "-log") == 0 ) {
          
-         // Reset data structures for use with the next graph data-file
-         // & start a new output line.
+         settings.replayLogs = true;
          
-         components.clear();
-         cyclicComponents.clear();
-         sortedComponentIndices.clear();
-         unionOfNeighborhoods.clear();
-
-         cout << endl;
+      } else {
          
-//      } // end for (each random instance at this setting)
-//
-//     beta += 0.1;
-//   }
-
-   delete mgm;
-
-   return 0;
+         argv[kept++] = argv[j];
+      }
+   }
+   
+   argc = kept;
 }
 
 
-// ---------------------------------SUBROUTINES-------------------------------------
+// ---------------------------------BATCH MODE-------------------------------------
 // 
-// File all vertex indices into their respective components, and at the same
-// time check for any cycles.  Return value is TRUE if the input graph is a forest
-// (counting self-loops and parallel edges as cycles, since had the graph been simple,
-// each such edge almost certainly would have created a cycle anyway), FALSE otherwise.
+// Usage: analyze -batch <pattern|manifest> <neighborhood sizes> [threads]
+//        [-cores] [-coreFiles] [-clustering] [-distances[=N]] [-degrees] [-log]
+// 
+// Analyze every file matching a shell pattern such as 'N_20000_beta_*.xml',
+// or every file listed [one per line] in a manifest, for each of the
+// comma-separated neighborhood sizes, e.g. '0,1,2,3'.  Files are spread
+// across [threads] threads [by default, one per processor], and cout gets
+// a single CSV table with one row per file and neighborhood size.  The
+// -cores, -coreFiles, -clustering, -distances, -degrees and -log flags
+// work as in single-file mode.
 
-bool indexComponentsAndCheckCycles(multiGraphManager* mgm,
-         hash_map<int, hash_set<int> >& componentHash, hash_set<int>& cyclicComponents) {
-   
-   hash_map<int, int> color;
-   int componentIndex = 0;
-   bool cycle = false;
+// One worker's view of the batch.  Workers take the next unclaimed file
+// until there are none left, and file each file's records under its
+// position in the list.
 
-   // Initialize data structures for BFS.
+typedef struct {
 
-   hash_map<int, multiNode* >::iterator nodeIter = mgm->G->nodes.begin();
+   const vector<string>* files;
+   vector< vector<string> >* records;
+   int* nextFile;
 
-   while ( nodeIter != mgm->G->nodes.end() ) {
+   const analysisSettings* settings;
+   string scratchFilename;
 
-      color[nodeIter->first] = WHITE;
-      nodeIter++;
-   }
+} batchJob;
+
+void* batchMain(void* arg) {
    
-   queue<int> Q;
-   int currentVertex;
-   vector<int> neighborList;
-   vector<int>::iterator neighborIter;
+   batchJob* job = (batchJob*) arg;
    
-   // Grow a BFS from each unseen vertex, marking vertices as they're
-   // observed & indexing component membership.
-
-   nodeIter = mgm->G->nodes.begin();
-
-   while ( nodeIter != mgm->G->nodes.end() ) {
+   string sweep;
+   
+   while ( true ) {
       
-      // If we haven't seen this node yet, grow a BFS from it & index its
-      // containing component, checking for cycles.
+      int f = __atomic_fetch_add(job->nextFile, 1, __ATOMIC_RELAXED);
       
-      if ( color[nodeIter->first] == WHITE ) {
-
-          color[nodeIter->first] = GRAY;
-          Q.push(nodeIter->first);
-          componentHash[componentIndex].insert(nodeIter->first);
-
-          while ( !(Q.empty()) ) {
-
-             currentVertex = Q.front();
-             mgm->G->nodes[currentVertex]->getNeighbors(neighborList);
-
-             neighborIter = neighborList.begin();
-
-             while ( neighborIter != neighborList.end() ) {
-
-                if ( color[*neighborIter] == WHITE ) {
-
-                  color[*neighborIter] = GRAY;
-                  Q.push(*neighborIter);
-                  componentHash[componentIndex].insert(*neighborIter);
-                  
-                } else {
-                  
-               // Deprecated; we used to ignore loops.    
-               // if ( color[*neighborIter] == GRAY && *neighborIter != currentVertex ) {
-                  
-                  if ( color[*neighborIter] == GRAY ) {
-                     
-                     // We've seen this guy already, and so there's a cycle here.
-                     
-                     cycle = true;
-                     cyclicComponents.insert(componentIndex);
-                  }
-                }
-
-                neighborIter++;
-
-             } // end while ( we're scanning the neighbors of the current vertex )
-
-             color[currentVertex] = BLACK;
-             Q.pop();
-
-          } // end while( we're still scanning the current component )
-
-          componentIndex++;
+      if ( f >= (int) job->files->size() ) {
+         break;
+      }
+      
+      char* filename = (char*) (*(job->files))[f].c_str();
+      
+      cerr << "Processing file " << filename << endl;
+      
+      analyzeFile(filename, (char*) job->scratchFilename.c_str(), *(job->settings),
+            (*(job->records))[f], sweep);
+   }
+   
+   return NULL;
+}
 
-      } // end if ( we haven't seen this node yet )
 
-      nodeIter++;
+// Fill [files] from a shell pattern, if [source] has wildcards, or else from
+// a manifest file.  Returns false if the manifest can't be read.
 
-   } // end [outer] while ( we're scanning through all nodes looking for new
-     // components )
-     
-   return !(cycle);
+bool listFiles(const char* source, vector<string>& files) {
+   
+   if ( strpbrk(source, "*?[") != NULL ) {
+      
+      glob_t matches;
+      
+      if ( glob(source, 0, NULL, &matches) == 0 ) {
+         
+         for ( size_t j = 0; j < matches.gl_pathc; j++ ) {
+            
+            files.push_back(matches.gl_pathv[j]);
+         }
+      }
+      
+      globfree(&matches);
+      
+      return true;
+   }
+   
+   ifstream manifest(source);
+   
+   if ( !manifest ) {
+      return false;
+   }
+   
+   string line;
+   
+   while ( getline(manifest, line) ) {
+      
+      // Trim trailing whitespace [including DOS line ends]; skip blank lines
+      // and comments.
+      
+      line.erase(line.find_last_not_of(" \t\r") + 1);
+      
+      if ( !line.empty() && line[0] != '#' ) {
+         
+         files.push_back(line);
+      }
+   }
+   
+   return true;
 }
 
 
-// Remove all vertices _not_ in "targetComponent" from mgm.
-
-void extractComponent(multiGraphManager* mgm, hash_set<int> targetComponent) {
+int runBatch(int argc, char* argv[], analysisSettings& settings) {
    
-   hash_map<int, int> color;
-   hash_map<int, multiNode*>::iterator iter = mgm->G->nodes.begin();
-   vector<int> indices;
+   if ( argc < 4 ) {
+      
+      cerr << "Usage: analyze -batch <pattern|manifest> <neighborhood sizes> [threads]" << endl;
+      return 1;
+   }
    
-   // First, grab all IDs of all nodes in mgm.  Do this so as to avoid
-   // screwing up the iterator when we delete nodes (in the second pass).
-   // Mark each initially to be WHITE.
+   vector<string> files;
    
-   while ( iter != mgm->G->nodes.end() ) {
+   if ( !listFiles(argv[2], files) ) {
       
-      indices.push_back(iter->first);
-      color[iter->first] = WHITE;
+      cerr << "Can't read manifest " << argv[2] << endl;
+      return 1;
+   }
+   
+   settings.topCount = 1;
+   settings.maxTopCount = 1;
+   settings.maxNeighborhoodSize = -1;
+   settings.separator = ",";
+   
+   // Parse the neighborhood sizes.
+   
+   istringstream sizes(argv[3]);
+   string size;
+   
+   while ( getline(sizes, size, ',') ) {
       
-      iter++;
+      settings.neighborhoodSizes.push_back(atoi(size.c_str()));
    }
    
-   // Mark all the nodes in targetComponent to be BLACK.
+   int threads = ( argc > 4 ) ? atoi(argv[4]) : jobCount(files.size(), 1);
    
-   std::hash_set<int>::iterator targetIter = targetComponent.begin();
+   if ( threads < 1 ) {
+      threads = 1;
+   }
+   
+   // Each worker gets its own graph manager, and so its own scratch output
+   // file, removed at the end.
+   
+   vector< vector<string> > records( files.size() );
+   int nextFile = 0;
+   
+   vector<batchJob> jobs( threads );
    
-   while ( targetIter != targetComponent.end() ) {
+   for ( int j = 0; j < threads; j++ ) {
       
-      color[*targetIter] = BLACK;
+      jobs[j].files = &files;
+      jobs[j].records = &records;
+      jobs[j].nextFile = &nextFile;
+      jobs[j].settings = &settings;
+      jobs[j].scratchFilename = "analyze_scratch_" + to_string<int>(j) + ".xml";
+   }
+   
+   runJobs(jobs, batchMain);
+   
+   for ( int j = 0; j < threads; j++ ) {
       
-      targetIter++;
+      remove(jobs[j].scratchFilename.c_str());
+      remove((jobs[j].scratchFilename + ".idx").c_str());
    }
    
-   // Delete all non-BLACK nodes.
+   // Write the table.
    
-   vector<int>::iterator vectorIter = indices.begin();
+   cout << "file,components";
    
-   while ( vectorIter != indices.end() ) {
-      
-      if ( color[*vectorIter] == WHITE ) {
-	 
-         mgm->deleteNode(*vectorIter);
-      }
-
-      vectorIter++;
+   for ( int j = 1; j <= 10; j++ ) {
+      cout << ",size_" << j;
    }
-}
-
-
-// Identify the [upper_limit] highest-degree nodes.
-
-void countHighestDegreeNodes(multiGraphManager* mgm, int N, queue<int>& highestDegreeNodes) {
    
-   int upper_limit = N;
-   vector<int> degreeVector;
-   int nodeCount = 0;
-
-   hash_map<int, hash_set<int> >::iterator iter = mgm->G->degreeHash.begin();
+   cout << ",forest,cyclic,diameter,neighborhoodSize,topCount"
+        << ",remainingComponents,remainingNodes";
    
-   while ( iter != mgm->G->degreeHash.end() ) {
-
-      degreeVector.push_back( iter->first );
-      iter++;
+   for ( int j = 1; j <= 10; j++ ) {
+      cout << ",remainingSize_" << j;
    }
-
-   sort(degreeVector.begin(), degreeVector.end(), greater<int>());
    
-   vector<int>::iterator vectorIter = degreeVector.begin();
+   cout << ",remainingDiameter,remainingForest,remainingCyclic,remainingExtraEdges";
    
-   int currentDegree = *vectorIter;
+   if ( settings.cores ) {
+      cout << ",maxCore,coreSizes";
+   }
    
-   while ( vectorIter != degreeVector.end() && nodeCount < upper_limit ) {
-
-      std::hash_set<int>::iterator nodeIter = mgm->G->degreeHash[currentDegree].begin();
-      
-      if ( mgm->G->degreeHash[currentDegree].size() <= (upper_limit - nodeCount) ) {
+   if ( settings.clustering ) {
+      cout << ",triangles,globalClustering,averageClustering";
+   }
+   
+   if ( settings.distanceSources > 0 ) {
+      cout << ",averageDistance,averageDistanceLow,averageDistanceHigh"
+           << ",effectiveDiameter,effectiveDiameterLow,effectiveDiameterHigh"
+           << ",distanceFractions";
+   }
+   
+   if ( settings.degrees ) {
+      cout << ",maxDegree,degreeExponent,degreeExponentError,degreeMin,degreeTail"
+           << ",degreeDistance";
+   }
+   
+   cout << endl;
+   
+   for ( unsigned int f = 0; f < files.size(); f++ ) {
       
-         while ( nodeIter != mgm->G->degreeHash[currentDegree].end() ) {
-            
-            highestDegreeNodes.push(*nodeIter);
-            nodeIter++;
-            nodeCount++;
-         }
+      for ( unsigned int r = 0; r < records[f].size(); r++ ) {
          
-      } else {
-         
-         while ( nodeCount < upper_limit ) {
-            
-            highestDegreeNodes.push(*nodeIter);
-            nodeIter++;
-            nodeCount++;
-         }
+         cout << files[f] << "," << records[f][r] << endl;
       }
-
-      currentDegree = *(++vectorIter);
-
-   } // end while ( outer loop iterating across available degrees )
+   }
    
+   return 0;
 }
 
 
-// Identify a radius-[size] neighborhood from around node [centerID].
-
-void identifyNeighborhood(multiGraphManager* mgm, int centerID, int size, vector<int>& storage) {
+// File all vertex indices into their respective components, and at the same
+// time check for any cycles.  Return value is TRUE if the input graph is a forest
+// (counting self-loops and parallel edges as cycles, since had the graph been simple,
+// each such edge almost certainly would have created a cycle anyway), FALSE otherwise.
+//
+// Components are labelled by union-find over a frozen copy of the graph, so
+// 'components' is indexed by dense node index; 'nodeIDs' maps those back to
+// node IDs.
 
-   // [WHITE: unprocessed.  GRAY: needs processing.]
-   // [BLACK: done, leave it alone.]
-   
-   hash_map<int, int> color;
-   hash_map<int, int> level;
-   
-   queue<int> neighborhood;
-   
-   // Initialize maps; color everyone WHITE & set everyone's depth level to
-   // fake-infinity.
+bool indexComponentsAndCheckCycles(multiGraphManager* mgm,
+         componentIndex& components, vector<int>& nodeIDs) {
    
-   hash_map<int, multiNode*>::iterator nodeIter = mgm->G->nodes.begin();
-
-   while ( nodeIter != mgm->G->nodes.end() ) {
-
-      color[nodeIter->first] = WHITE;
-      level[nodeIter->first] = mgm->nodeSize() + 1;
+   frozenGraph frozen(mgm->G);
 
-      nodeIter++;
-   }
+   findComponents(frozen, components);
+   nodeIDs.swap(frozen.ids);
+     
+   return components.cyclicSize() == 0;
+}
 
-   color[centerID] = GRAY;
-   level[centerID] = 0;
-   neighborhood.push(centerID);
 
-   while ( !(neighborhood.empty()) ) {
-      
-      int currentNode = neighborhood.front();
-      color[currentNode] = BLACK;
+// Remove all vertices _not_ in component "targetComponent" from mgm.
 
-      vector<int> neighborList;
-      vector<int>::iterator neighborIter;
-      
-      // Grab the neighbors of the current node.
-      
-      mgm->G->nodes[currentNode]->getNeighbors(neighborList);
-      neighborIter = neighborList.begin();
-      
-      // For each neighbor,
+void extractComponent(multiGraphManager* mgm, const componentIndex& components,
+      const vector<int>& nodeIDs, int targetComponent) {
+   
+   vector<int> outside;
+   
+   for ( unsigned int i = 0; i < nodeIDs.size(); i++ ) {
       
-      while ( neighborIter != neighborList.end() ) {
-	      
-         // If we care about this neighbor of the current node,
-
-         if ( color[*neighborIter] == WHITE && level[currentNode] < size ) {
-
-            // Mark it for neighborhood-inclusion and further investigation.
-
-            color[*neighborIter] = GRAY;
-            level[*neighborIter] = level[currentNode] + 1;
-            neighborhood.push(*neighborIter);
-         }
-
-         neighborIter++;
+      if ( components.label[i] != targetComponent ) {
+         
+         outside.push_back(nodeIDs[i]);
       }
-      
-      neighborhood.pop();
    }
-
-   // Now that we've colored the neighborhood, just go through and save
-   // it node-by-node.
    
-   hash_map<int, int>::iterator colorIter = color.begin();
+   mgm->G->deleteNodes(outside);
+}
 
-   while( colorIter != color.end() ) {
-      
-      if ( colorIter->second != WHITE ) {
 
-         storage.push_back(colorIter->first);
-      }
+// Identify a radius-[size] neighborhood from around node [centerID], and
+// append the IDs of its nodes to [storage].
 
-      colorIter++;
+void identifyNeighborhood(const frozenGraph& frozen, ballSearch& search, int centerID, int size,
+      vector<int>& storage) {
+
+   vector<int> ball;
+   
+   search.find(frozen.indexOf(centerID), size, ball);
+   
+   for ( unsigned int j = 0; j < ball.size(); j++ ) {
+      
+      storage.push_back(frozen.ids[ball[j]]);
    }
 }
 
 
-// Count the number of 'extra' edges in the input graph, i.e. for each connected
-// component C which isn't a tree,
-// 
-//   Count the difference |E(C)| - (|V(C)| - 1).
+// For each number t <= [maxTopCount] of highest-degree nodes and each
+// neighborhood size r <= [maxNeighborhoodSize], write the line
 // 
-// NOTE: THIS IS DESTRUCTIVE.
+//   profile t r removed components largest
 // 
-// We consider self-loops and parallel edges to be cycles.  (see comment preceding indexComponentsAndCheckCycles.)
+// describing what's left of G after deleting every node within r hops of
+// the t highest-degree nodes.  G itself is left alone: each t takes one
+// reverse-deletion pass, which covers every r at once.
 
-int countExtraEdges(multiGraphManager* mgm, hash_map<int, hash_set<int> > components, hash_set<int> cyclicComponents) {
+void sweepNeighborhoodRemoval(multiGraphManager* mgm, int maxTopCount,
+      int maxNeighborhoodSize, ostream& out) {
    
-   int finalCount = 0;
-   int incrementEdges = 0;
-   int edgesInComponent = 0;
-   std::hash_set<int>::iterator currentComponentNodeIter;
-
-   std::hash_set<int>::iterator cyclicIter = cyclicComponents.begin();
+   frozenGraph frozen(mgm->G);
    
-   // DEPRECATED: We used to remove loops.  Now we don't.
-
-   /*
-
-   // Iterate through each component which has been identified as having
-   // a (non-self-loop) cycle, and actually remove all self-loops.
+   vector<int> highestDegreeNodes;
+   topDegreeNodes(mgm->G, maxTopCount, highestDegreeNodes);
    
-   // For each component containing a (non-self-loop) cycle,
+   vector<int> centers;
+   vector<int> order;
+   vector<int> ballEnds;
+   removalProfile profile;
    
-   while( cyclicIter != cyclicComponents.end() ) {
+   for ( unsigned int t = 0; t < highestDegreeNodes.size(); t++ ) {
       
-      currentComponentNodeIter = components[*cyclicIter].begin();
-      
-      // For each node in this component,
-      
-      while ( currentComponentNodeIter != components[*cyclicIter].end() ) {
-         
-         // While this node still has an attached loop,
-         
-         while ( mgm->G->nodes[*currentComponentNodeIter]->hasNeighbor(*currentComponentNodeIter) ) {
-            
-            // Remove the loop.
-            
-            vector<int> neighbors;
-            mgm->G->nodes[*currentComponentNodeIter]->getNeighbors(neighbors);
-            
-            mgm->G->deleteEdge(*currentComponentNodeIter, *currentComponentNodeIter);
-         }
-         
-         currentComponentNodeIter++;
-      }
-
-      cyclicIter++;
-   }
-   
-   // Reset the cyclic-components iterator.
-   
-   cyclicIter = cyclicComponents.begin();
-   
-   */
-   
-   // For each component which contains a cycle,
-   
-   while ( cyclicIter != cyclicComponents.end() ) {
-         
-      // Count the edges in the current component by summing node degrees &
-      // dividing by 2.
+      centers.push_back(frozen.indexOf(highestDegreeNodes[t]));
       
-      currentComponentNodeIter = components[*cyclicIter].begin();
+      nestedBalls(frozen, centers, maxNeighborhoodSize, order, ballEnds);
+      profileRemovals(frozen, order, profile);
       
-      while ( currentComponentNodeIter != components[*cyclicIter].end() ) {
+      for ( int r = 0; r <= maxNeighborhoodSize; r++ ) {
          
-         edgesInComponent += mgm->G->nodes[*currentComponentNodeIter]->getDegree();
+         int removed = ballEnds[r];
          
-         currentComponentNodeIter++;
+         out << "profile " << centers.size() << " " << r << " " << removed
+             << " " << profile.componentCount[removed]
+             << " " << profile.largest[removed] << endl;
       }
-      
-      edgesInComponent /= 2;
-      
-      // Calculate, for the current component C, |E(C)| - (|C|-1)
-      
-      incrementEdges = edgesInComponent - (components[*cyclicIter].size() - 1);
-      
-      finalCount += incrementEdges;
-      
-      edgesInComponent = 0;
-      
-      cyclicIter++;
    }
-   
-   return finalCount;
 }
 
 
@@ -927,8 +1188,8 @@ int countComponentsWithCycles(multiGraphManager* mgm, hash_map<int, hash_set<int
 // 
 // Is the node argument inside a component which is a tree?
 // IGNORE SELF-LOOPS.
-// (Removed.  countExtraEdges manages this function on its own now, with help
-//  from cyclicComponents.)
+// (Removed.  componentIndex::isCyclic() answers this for every component at
+//  once.)
 
 bool isInTreeComponent(int centerNode, multiGraphManager* mgm) {
 
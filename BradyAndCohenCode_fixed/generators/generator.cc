@@ -1,8 +1,11 @@
 #include "LuTopologyGenerator.h"
+#include "../multi/degreeStats.h"
 #include <queue>
 #include <algorithm>
 #include <string>
 #include <cstdlib>
+#include <cstring>
+#include <cmath>
 #include <sstream>
 #include <iostream>
 
@@ -10,6 +13,11 @@
 #define GRAY 1
 #define BLACK 2
 
+// Largest gap between beta and the fitted degree exponent of a generated
+// graph that passes without a warning.
+
+#define BETA_TOLERANCE 0.1
+
 
 typedef hash_map<int, multiNode*> node_hash_t;
 typedef hash_map<int, multiEdge*> edge_hash_t;
@@ -40,7 +48,16 @@ string to_string(T t) {
       return oss.str();
 }
 
-int main() {
+// Usage: generate [-record | -log]
+//
+// With -record, each file gets the generated edges as an update sequence,
+// recorded as they're added [and serialized on a writer thread of their
+// own], instead of a snapshot of the finished graph.  With -log, they go
+// to a binary update log, <file>.log, instead [see updateLog.h], and the
+// file itself holds only the empty graph; analyze -log and route -log
+// replay the log on top of it.
+
+int main(int argc, char* argv[]) {
    cout<< "start"<<endl;
    multiGraphManager* mgm;
    LuTopologyGenerator* ltg;
@@ -68,6 +85,21 @@ int main() {
    
    int filecount = 30;
 
+   bool recordUpdates = false;
+   bool logUpdates = false;
+
+   for ( i = 1; i < argc; i++ ) {
+
+      if ( strcmp(argv[i], "-record") == 0 ) {
+         recordUpdates = true;
+      } else if ( strcmp(argv[i], "-log") == 0 ) {
+         recordUpdates = true;
+         logUpdates = true;
+      } else {
+         cerr << "Unknown option " << argv[i] << endl;
+         return 1;
+      }
+   }
    
    while ( beta < 3.0 ) {
 
@@ -102,12 +134,54 @@ int main() {
          final_filename = (char *) filename.c_str();
 
          mgm = new multiGraphManager(n, final_filename);
+         mgm->enableBackgroundWriter();
+
+         if ( logUpdates && !mgm->recordToLog( (filename + ".log").c_str() ) ) {
+
+            cerr << "Can't open " << filename << ".log" << endl;
+            return 1;
+         }
+
+         if ( recordUpdates ) {
+            mgm->enableAsyncRecording();
+            mgm->record();
+         }
 
          ltg = new LuTopologyGenerator(mgm, n, beta);
 
-         mgm->snapshot();
+         if ( recordUpdates ) {
+            mgm->pause();
+         } else {
+            mgm->snapshot();
+         }
 
          cout << "Finished file " << final_filename << ".\n";
+
+         // Check the degree distribution against beta.  The fit runs over
+         // the degree histogram, not the nodes, so it costs next to
+         // nothing.
+
+         vector<int> histogram;
+         powerLawFit fit;
+
+         degreeHistogram(mgm->G, histogram);
+
+         if ( fitPowerLaw(histogram, fit) ) {
+
+            cout << "Degree exponent " << fit.alpha << " +/- " << fit.alphaError
+                 << " for degree >= " << fit.xmin << " [KS distance "
+                 << fit.distance << "].\n";
+
+            if ( fabs(fit.alpha - beta) > BETA_TOLERANCE ) {
+               cerr << "Warning: " << final_filename << " has degree exponent "
+                    << fit.alpha << ", not beta = " << beta << ".\n";
+            }
+
+         } else {
+
+            cerr << "Warning: too few nodes in " << final_filename
+                 << " to fit a degree exponent.\n";
+         }
         delete mgm;
       } // end for (each random instance at this setting)
       
@@ -0,0 +1,135 @@
+// percolator.cc: Robustness curves for a recorded graph.
+//
+// Usage: percolate file strategy [points] [runs|radius] [seed]
+//
+//    file:     A recorded XML file, or an edge list [.edges], METIS
+//              [.metis] or Matrix Market [.mtx] file.
+//    strategy: random, degree, adaptive, balls [site percolation], or bond.
+//    points:   Number of evenly spaced removal fractions to report [100].
+//    runs:     Random orders to average over, for random and bond [100].
+//    radius:   Neighborhood radius around each hub, for balls [1].
+//    seed:     Seed for the random orders [the current time].
+//
+// Writes one line per point:
+//
+//    fraction removed components largest
+//
+// For the random strategies, 'fraction' is the probability of each node
+// [or edge] being removed and the rest are expectations; otherwise it's the
+// fraction of nodes removed along the order.
+
+#include "LuTopologyGenerator.h"
+#include "../multi/frozenGraph.h"
+#include "../multi/percolation.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+
+   if ( argc < 3 ) {
+
+      cerr << "Usage: percolate file strategy [points] [runs|radius] [seed]"
+           << endl;
+      return 1;
+   }
+
+   char* strategyArg = argv[2];
+
+   int points = ( argc > 3 ) ? atoi(argv[3]) : 100;
+   int seed = ( argc > 5 ) ? atoi(argv[5]) : time(0);
+
+   bool bond = ( strcmp(strategyArg, "bond") == 0 );
+   bool random = bond || ( strcmp(strategyArg, "random") == 0 );
+
+   int runs = ( argc > 4 ) ? atoi(argv[4]) : 100;
+   int radius = ( argc > 4 ) ? atoi(argv[4]) : 1;
+
+   removalStrategy strategy;
+
+   if ( random ) {
+
+      strategy = REMOVE_RANDOM;
+
+   } else if ( strcmp(strategyArg, "degree") == 0 ) {
+
+      strategy = REMOVE_DEGREE;
+
+   } else if ( strcmp(strategyArg, "adaptive") == 0 ) {
+
+      strategy = REMOVE_ADAPTIVE_DEGREE;
+
+   } else if ( strcmp(strategyArg, "balls") == 0 ) {
+
+      strategy = REMOVE_BALLS;
+
+   } else {
+
+      cerr << "Unknown strategy " << strategyArg << endl;
+      return 1;
+   }
+
+   if ( points < 1 ) {
+      points = 1;
+   }
+
+   multiGraphManager* mgm = new multiGraphManager();
+
+   cerr << "Processing file " << argv[1] << endl;
+
+   if ( !mgm->loadFile(argv[1]) ) {
+
+      cerr << "Can't read " << argv[1] << endl;
+      return 1;
+   }
+
+   frozenGraph frozen(mgm->G);
+
+   delete mgm;
+
+   if ( random ) {
+
+      // Average over random orders, then read the curve off at each
+      // removal probability.
+
+      vector<double> meanLargest;
+      vector<double> meanComponents;
+
+      randomPercolation(frozen, bond, runs, seed, meanLargest, meanComponents);
+
+      int size = meanLargest.size() - 1;
+
+      for ( int j = 0; j <= points; j++ ) {
+
+         double q = (double) j / points;
+
+         cout << q << " " << q * size
+              << " " << atRemovalProbability(meanComponents, q)
+              << " " << atRemovalProbability(meanLargest, q) << endl;
+      }
+
+   } else {
+
+      vector<int> order;
+      removalProfile profile;
+
+      removalOrder(frozen, strategy, order, seed, radius);
+      profileRemovals(frozen, order, profile);
+
+      int size = order.size();
+
+      for ( int j = 0; j <= points; j++ ) {
+
+         int removed = (long long) size * j / points;
+
+         cout << (double) removed / ( size > 0 ? size : 1 ) << " " << removed
+              << " " << profile.componentCount[removed]
+              << " " << profile.largest[removed] << endl;
+      }
+   }
+
+   return 0;
+}
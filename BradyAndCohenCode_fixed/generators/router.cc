@@ -0,0 +1,295 @@
+// router.cc: Compact routing tables for a recorded graph.
+//
+// Usage: route [-log] file core [pairs]
+//
+//    file: A recorded XML file, or an edge list [.edges], METIS [.metis]
+//       or Matrix Market [.mtx] file.
+//    -log: Replay the binary update log <file>.log [see updateLog.h]
+//       onto the graph after reading it.
+//    core: How to choose the landmarks: a number k for the k highest-degree
+//       nodes, "practical:tau" for the ceil(n^gamma) highest, or
+//       "theoretical:tau" for those above the degree threshold, or
+//       "tz:seed" for Thorup and Zwick's sampling [see coreSelection.h],
+//       where n is the number of nodes in the file and tau the exponent
+//       it was generated with.
+//    pairs: Number of random pairs of distinct nodes to route between and
+//       measure the stretch of, or 0 for all ordered pairs.  Random pairs
+//       are also put to the distance oracle.
+//
+// Cuts the graph down to its giant component, as the simulator does,
+// builds the routing tables, packs them, and writes two lines:
+//
+//    nodes landmarks tableMean tableVariance tableMax bytesMean
+//       bytesVariance bytesMax arenaBytes
+//    histogram
+//
+// where tableMean and the rest count entries per table, bytesMean and the
+// rest count the bytes each packed table takes, arenaBytes counts all the
+// packed tables together, and the histogram gives the number of tables
+// taking 0 bytes, then 1, 2-3, 4-7 and so on.  Given pairs, it goes on
+// to write
+//
+//    pairs failures stretchMean stretchVariance stretchMax hopsMean
+//    histogram
+//
+// where the histogram gives the number of pairs with stretch in [1, 1.05),
+// [1.05, 1.1) and so on.  Given a number of random pairs, it then writes
+//
+//    oracleBytes queriesPerSecond estimateMean estimateMax exactFraction
+//
+// for the distance oracle: its size, how fast it answers the pairs all at
+// once, the mean and largest ratio of its estimates to the true distances,
+// and the fraction of pairs it gets exactly.
+
+#include "LuTopologyGenerator.h"
+#include "../multi/frozenGraph.h"
+#include "../multi/components.h"
+#include "../multi/coreSelection.h"
+#include "../multi/routingScheme.h"
+#include "../multi/routingTables.h"
+#include "../multi/routingQueries.h"
+#include "../multi/exactDistances.h"
+#include "../multi/distanceOracle.h"
+#include "../rand/randomc.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/time.h>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+
+   bool replayLog = false;
+
+   if ( argc > 1 && strcmp(argv[1], "-log") == 0 ) {
+
+      replayLog = true;
+      argc--;
+      argv++;
+   }
+
+   if ( argc < 3 ) {
+
+      cerr << "Usage: route [-log] file core [pairs]" << endl;
+      return 1;
+   }
+
+   coreSelection selection(coreFixed, 0);
+
+   if ( !coreSelection::parse(argv[2], selection) ) {
+
+      cerr << "Unknown core " << argv[2] << endl;
+      return 1;
+   }
+
+   multiGraphManager* mgm = new multiGraphManager();
+
+   cerr << "Processing file " << argv[1] << endl;
+
+   if ( !mgm->loadFile(argv[1]) ) {
+
+      cerr << "Can't read " << argv[1] << endl;
+      return 1;
+   }
+
+   if ( replayLog ) {
+
+      string logFilename = string(argv[1]) + ".log";
+
+      if ( mgm->replayLog(logFilename.c_str()) < 0 ) {
+
+         cerr << "Can't replay " << logFilename << endl;
+         return 1;
+      }
+   }
+
+   int generated = mgm->G->nodeSize();
+
+   // Delete everything outside the giant component.
+
+   {
+      frozenGraph whole(mgm->G);
+      componentIndex components;
+      vector<int> order;
+      vector<int> outside;
+
+      findComponents(whole, components);
+      components.bySize(order);
+
+      for ( int i = 0; i < whole.nodeSize(); i++ ) {
+
+         if ( components.label[i] != order[0] ) {
+            outside.push_back(whole.ids[i]);
+         }
+      }
+
+      mgm->G->deleteNodes(outside);
+   }
+
+   vector<int> landmarkIDs;
+   selection.select(mgm->G, generated, landmarkIDs);
+
+   frozenGraph frozen(mgm->G);
+
+   delete mgm;
+
+   vector<int> landmarks;
+
+   for ( unsigned int i = 0; i < landmarkIDs.size(); i++ ) {
+      landmarks.push_back( frozen.indexOf(landmarkIDs[i]) );
+   }
+
+   // Only the packed tables outlive the scheme.
+
+   routingTables* tables;
+   distanceOracle* oracle = NULL;
+
+   int pairCount = ( argc > 3 ) ? atoi(argv[3]) : -1;
+
+   {
+      routingScheme scheme(frozen, landmarks);
+
+      tables = new routingTables(scheme);
+
+      if ( pairCount > 0 ) {
+         oracle = new distanceOracle(frozen, scheme);
+      }
+   }
+
+   // Table sizes.
+
+   int n = tables->nodeSize();
+   double sum = 0.0;
+   double squares = 0.0;
+   int largest = 0;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      int size = tables->tableSize(v);
+
+      sum += size;
+      squares += (double) size * size;
+      largest = max(largest, size);
+   }
+
+   double mean = ( n > 0 ) ? sum / n : 0.0;
+   double variance = ( n > 1 ) ? (squares - sum * mean) / (n - 1) : 0.0;
+
+   double bytesMean;
+   double bytesVariance;
+   long long bytesLargest;
+   vector<int> histogram;
+
+   tables->byteStats(bytesMean, bytesVariance, bytesLargest);
+   tables->byteHistogram(histogram);
+
+   cout << n << " " << landmarks.size() << " " << mean << " " << variance
+        << " " << largest << " " << bytesMean << " " << bytesVariance
+        << " " << bytesLargest << " " << tables->arenaBytes() << endl;
+
+   for ( unsigned int k = 0; k < histogram.size(); k++ ) {
+      cout << ( k > 0 ? " " : "" ) << histogram[k];
+   }
+
+   cout << endl;
+
+   // Stretch.
+
+   vector<int> sources;
+   vector<int> targets;
+
+   if ( pairCount > 0 && n > 1 ) {
+
+      TRandomMersenne generator(1);
+
+      for ( int i = 0; i < pairCount; i++ ) {
+
+         int s = generator.IRandom(0, n - 1);
+         int t = generator.IRandom(0, n - 2);
+
+         sources.push_back(s);
+         targets.push_back( ( t >= s ) ? t + 1 : t );
+      }
+   }
+
+   // Shortest distances between the random pairs, for the stretch and the
+   // oracle both.
+
+   vector<int> exact;
+
+   if ( pairCount > 0 ) {
+      pairDistances(frozen, sources, targets, exact);
+   }
+
+   if ( pairCount >= 0 ) {
+
+      stretchSummary summary;
+
+      if ( pairCount == 0 ) {
+         measureAllStretch(frozen, *tables, summary);
+      } else {
+         measureStretch(*tables, sources, targets, exact, summary);
+      }
+
+      cout << summary.pairs << " " << summary.failures << " "
+           << summary.mean << " " << summary.variance << " "
+           << summary.largest << " " << summary.meanHops << endl;
+
+      for ( unsigned int k = 0; k < summary.histogram.size(); k++ ) {
+         cout << ( k > 0 ? " " : "" ) << summary.histogram[k];
+      }
+
+      cout << endl;
+   }
+
+   // Distance oracle.
+
+   if ( oracle != NULL ) {
+
+      vector<int> estimates;
+      struct timeval start;
+      struct timeval end;
+
+      gettimeofday(&start, NULL);
+      oracle->estimates(sources, targets, estimates);
+      gettimeofday(&end, NULL);
+
+      double seconds = (end.tv_sec - start.tv_sec)
+                       + (end.tv_usec - start.tv_usec) / 1e6;
+
+      double ratioSum = 0.0;
+      double ratioLargest = 0.0;
+      int measured = 0;
+      int exactCount = 0;
+
+      for ( unsigned int i = 0; i < sources.size(); i++ ) {
+
+         if ( exact[i] <= 0 || estimates[i] < 0 ) {
+            continue;
+         }
+
+         double ratio = (double) estimates[i] / exact[i];
+
+         ratioSum += ratio;
+         ratioLargest = max(ratioLargest, ratio);
+         measured++;
+
+         if ( estimates[i] == exact[i] ) {
+            exactCount++;
+         }
+      }
+
+      cout << oracle->bytes() << " "
+           << ( seconds > 0.0 ? sources.size() / seconds : 0.0 ) << " "
+           << ( measured > 0 ? ratioSum / measured : 0.0 ) << " "
+           << ratioLargest << " "
+           << ( measured > 0 ? (double) exactCount / measured : 0.0 ) << endl;
+
+      delete oracle;
+   }
+
+   delete tables;
+
+   return 0;
+}
@@ -0,0 +1,1229 @@
+// verifier.cc: Brute-force checks of the analyses whose fast paths are too
+// clever to trust on their own.
+//
+// Usage: verify [graphs] [seed]
+//
+//    graphs: Number of random graphs to check each analysis on [20].
+//    seed:   Seed for the random graphs [1].
+//
+// Graphs are random multigraphs with heavy-tailed degrees [edges join
+// nodes drawn with probability falling off as a power of their index], so
+// there are hubs, loops and parallel edges, and every few graphs is big
+// enough to take the parallel paths.  For each, it checks
+//
+//    - cores: the sequential and parallel peelings against each other,
+//      and on small graphs against peeling by repeated deletion;
+//    - triangles: the triangles through each node against intersecting
+//      sorted neighbor sets with the standard library;
+//    - routing tables: every port in the packed tables against the
+//      routingScheme they were packed from, so bit fields that straddle
+//      words are read back;
+//    - percolation [small graphs only]: the removal profiles along every
+//      removal order, and along a random edge order, against finding the
+//      components from scratch after each removal; the degree orders
+//      against scanning for the highest degree; and nested balls against
+//      distances from the centers;
+//    - updates [small graphs only]: random updates [by ID and at random,
+//      on nodes that may be gone, with loops and runs longer than the
+//      writer builds] logged and replayed onto a second copy, which should
+//      end up the same down to the node IDs and the time; and
+//    - formats: the graph, less a few nodes, written as an edge list, in
+//      METIS and in Matrix Market and read back, which should give it
+//      renumbered densely, loops and parallel edges included.
+//
+// Apart from the graphs, it checks
+//
+//    - blocks: blockCodec's packing and unpacking, on each graph's edge
+//      list as text and on random blocks [random bytes, zeros, short
+//      repeats, and far-back copies], from empty up to an output block;
+//      and
+//    - doubles: outputBuffer's hand-rolled putDouble against snprintf's
+//      "%g", on edge cases [rounding ties, powers of ten and their
+//      neighbors, the switches to scientific notation at 1e-5 and 1e6,
+//      negatives, zeros and infinities] and on random values.
+//
+// Writes one line per check, "check cases mismatches", where the cases are
+// graphs, blocks or values, and exits with 1 if there were any mismatches.
+
+#include "../multi/frozenGraph.h"
+#include "../multi/cores.h"
+#include "../multi/triangles.h"
+#include "../multi/percolation.h"
+#include "../multi/removalProfile.h"
+#include "../multi/routingScheme.h"
+#include "../multi/routingTables.h"
+#include "../multi/outputBuffer.h"
+#include "../multi/blockCodec.h"
+#include "../multi/updateRecorder.h"
+#include "../multi/updateLog.h"
+#include "../multi/graphFormats.h"
+#include "../rand/randomc.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <float.h>
+#include <math.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Nodes in a small graph, and in a big one [every BIG_EVERY graphs].
+
+#define SMALL_NODES 300
+#define BIG_NODES 200000
+#define BIG_EVERY 5
+
+// Random updates logged per node.  Only small graphs get them: building
+// the extra multiGraphs would dwarf everything else on a big one.
+
+#define UPDATES_PER_NODE 4
+
+// Random blocks for the codec check, per graph, on top of the graph's
+// edge list as text.
+
+#define BLOCKS_PER_GRAPH 8
+
+// Random values for the doubles check, per graph.
+
+#define DOUBLES_PER_GRAPH 1000
+
+// Make an empty scratch file, and put its name in 'name' [at least
+// SCRATCH_NAME_SIZE bytes].  Returns false if it couldn't be made.
+
+#define SCRATCH_NAME_SIZE 32
+
+bool scratchFile( char* name ) {
+
+   strcpy(name, "/tmp/verifyXXXXXX");
+
+   int descriptor = mkstemp(name);
+
+   if ( descriptor < 0 ) {
+      return false;
+   }
+
+   close(descriptor);
+
+   return true;
+}
+
+// Endpoints for a random multigraph on n nodes with about 'degree' n / 2
+// edges.
+
+void randomEndpoints( TRandomMersenne& generator, int n, double degree,
+                      vector<int>& endpoints ) {
+
+   // Draw endpoints by inverting the cumulative weights (i + 1)^-0.7.
+
+   vector<double> cumulative( n );
+   double total = 0.0;
+
+   for ( int i = 0; i < n; i++ ) {
+      total += pow(i + 1.0, -0.7);
+      cumulative[i] = total;
+   }
+
+   long long edges = (long long) (degree * n / 2);
+
+   endpoints.clear();
+
+   for ( long long e = 0; e < 2 * edges; e++ ) {
+
+      double x = generator.Random() * total;
+
+      endpoints.push_back( min( (int) (lower_bound(cumulative.begin(),
+                                                   cumulative.end(), x)
+                                       - cumulative.begin()), n - 1 ) );
+   }
+}
+
+multiGraph* graphFromEndpoints( int n, const vector<int>& endpoints ) {
+
+   multiGraph* G = new multiGraph(n);
+
+   G->addEdges(endpoints);
+
+   return G;
+}
+
+// Count the nodes on which two graphs differ, in ID or in their sorted
+// neighbor lists [by ID].  Graphs of different sizes differ everywhere.
+
+long long compareGraphs( const frozenGraph& a, const frozenGraph& b ) {
+
+   int n = a.nodeSize();
+
+   if ( n != b.nodeSize() || a.edgeSize() != b.edgeSize() ) {
+      return max( max(n, b.nodeSize()), 1 );
+   }
+
+   long long mismatches = 0;
+   vector<int> neighbors_a;
+   vector<int> neighbors_b;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      neighbors_a.clear();
+      neighbors_b.clear();
+
+      for ( int j = a.offsets[v]; j < a.offsets[v + 1]; j++ ) {
+         neighbors_a.push_back( a.ids[ a.adjacency[j] ] );
+      }
+
+      for ( int j = b.offsets[v]; j < b.offsets[v + 1]; j++ ) {
+         neighbors_b.push_back( b.ids[ b.adjacency[j] ] );
+      }
+
+      sort( neighbors_a.begin(), neighbors_a.end() );
+      sort( neighbors_b.begin(), neighbors_b.end() );
+
+      if ( a.ids[v] != b.ids[v] || neighbors_a != neighbors_b ) {
+         mismatches++;
+      }
+   }
+
+   return mismatches;
+}
+
+// Coreness by deleting nodes of degree below k until there are none, for
+// k = 1, 2, ...
+
+void bruteCores( const frozenGraph& frozen, vector<int>& coreness ) {
+
+   int n = frozen.nodeSize();
+
+   vector<int> degree( n );
+   vector<bool> gone( n, false );
+   int left = n;
+
+   for ( int v = 0; v < n; v++ ) {
+      degree[v] = frozen.offsets[v + 1] - frozen.offsets[v];
+   }
+
+   coreness.assign(n, 0);
+
+   for ( int k = 0; left > 0; k++ ) {
+
+      bool deleted = true;
+
+      while ( deleted ) {
+
+         deleted = false;
+
+         for ( int v = 0; v < n; v++ ) {
+
+            if ( gone[v] || degree[v] >= k ) {
+               continue;
+            }
+
+            gone[v] = true;
+            coreness[v] = k - 1;
+            left--;
+            deleted = true;
+
+            for ( int j = frozen.offsets[v]; j < frozen.offsets[v + 1]; j++ ) {
+               degree[ frozen.adjacency[j] ]--;
+            }
+         }
+      }
+   }
+}
+
+long long checkCores( const frozenGraph& frozen ) {
+
+   coreIndex sequential;
+   coreIndex parallel;
+
+   peelCores(frozen, sequential);
+   peelCoresParallel(frozen, parallel);
+
+   long long mismatches = 0;
+
+   for ( int v = 0; v < frozen.nodeSize(); v++ ) {
+
+      if ( sequential.coreness[v] != parallel.coreness[v] ) {
+         mismatches++;
+      }
+   }
+
+   if ( sequential.shellSize != parallel.shellSize ) {
+      mismatches++;
+   }
+
+   if ( frozen.nodeSize() <= SMALL_NODES ) {
+
+      vector<int> coreness;
+
+      bruteCores(frozen, coreness);
+
+      for ( int v = 0; v < frozen.nodeSize(); v++ ) {
+
+         if ( coreness[v] != sequential.coreness[v] ) {
+            mismatches++;
+         }
+      }
+   }
+
+   return mismatches;
+}
+
+// Largest component and number of components of what's left of the graph
+// with only the 'present' nodes and edges, by breadth-first search from
+// scratch.  [Both 0 if there are no nodes.]
+
+void bruteComponents( const frozenGraph& frozen, const vector<bool>& present,
+                      const vector<bool>& edgePresent, int& largest,
+                      int& count ) {
+
+   int n = frozen.nodeSize();
+
+   vector< vector<int> > neighbors( n );
+
+   for ( int e = 0; e < frozen.edgeSize(); e++ ) {
+
+      int node_1 = frozen.endpoints[2 * e];
+      int node_2 = frozen.endpoints[2 * e + 1];
+
+      if ( edgePresent[e] && present[node_1] && present[node_2] ) {
+         neighbors[node_1].push_back(node_2);
+         neighbors[node_2].push_back(node_1);
+      }
+   }
+
+   vector<bool> seen( n, false );
+   vector<int> queue;
+
+   largest = 0;
+   count = 0;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      if ( !present[v] || seen[v] ) {
+         continue;
+      }
+
+      seen[v] = true;
+      queue.assign(1, v);
+
+      for ( unsigned int i = 0; i < queue.size(); i++ ) {
+
+         for ( unsigned int j = 0; j < neighbors[ queue[i] ].size(); j++ ) {
+
+            int w = neighbors[ queue[i] ][j];
+
+            if ( !seen[w] ) {
+               seen[w] = true;
+               queue.push_back(w);
+            }
+         }
+      }
+
+      largest = max(largest, (int) queue.size());
+      count++;
+   }
+}
+
+// Check a removal profile against recomputing the components after every
+// removal, of a node [or, with 'bond', an edge].  Returns 1 if the order
+// isn't a list of distinct nodes [edges] or the profile is off anywhere.
+
+long long checkProfile( const frozenGraph& frozen, const vector<int>& order,
+                        bool bond ) {
+
+   int size = bond ? frozen.edgeSize() : frozen.nodeSize();
+
+   vector<bool> present( frozen.nodeSize(), true );
+   vector<bool> edgePresent( frozen.edgeSize(), true );
+   vector<bool>& removed = bond ? edgePresent : present;
+
+   for ( unsigned int i = 0; i < order.size(); i++ ) {
+
+      if ( order[i] < 0 || order[i] >= size || !removed[ order[i] ] ) {
+         return 1;
+      }
+
+      removed[ order[i] ] = false;
+   }
+
+   removed.assign(size, true);
+
+   removalProfile profile;
+
+   if ( bond ) {
+      profileEdgeRemovals(frozen, order, profile);
+   } else {
+      profileRemovals(frozen, order, profile);
+   }
+
+   if ( profile.size() != (int) order.size() + 1
+         || (int) profile.componentCount.size() != profile.size() ) {
+      return 1;
+   }
+
+   for ( unsigned int k = 0; k <= order.size(); k++ ) {
+
+      int largest;
+      int count;
+
+      bruteComponents(frozen, present, edgePresent, largest, count);
+
+      if ( profile.largest[k] != largest
+            || profile.componentCount[k] != count ) {
+         return 1;
+      }
+
+      if ( k < order.size() ) {
+         removed[ order[k] ] = false;
+      }
+   }
+
+   return 0;
+}
+
+// Highest degree first, in the original graph or [if 'adaptive'] in what's
+// left, found by scanning every node for every removal.  Ties go to the
+// lowest index.
+
+void bruteDegreeOrder( const frozenGraph& frozen, bool adaptive,
+                       vector<int>& order ) {
+
+   int n = frozen.nodeSize();
+
+   vector<bool> removed( n, false );
+
+   order.clear();
+
+   for ( int i = 0; i < n; i++ ) {
+
+      int best = -1;
+      int bestDegree = -1;
+
+      for ( int v = 0; v < n; v++ ) {
+
+         if ( removed[v] ) {
+            continue;
+         }
+
+         int degree = 0;
+
+         for ( int j = frozen.offsets[v]; j < frozen.offsets[v + 1]; j++ ) {
+
+            if ( !adaptive || !removed[ frozen.adjacency[j] ] ) {
+               degree++;
+            }
+         }
+
+         if ( degree > bestDegree ) {
+            best = v;
+            bestDegree = degree;
+         }
+      }
+
+      removed[best] = true;
+      order.push_back(best);
+   }
+}
+
+// Check nestedBalls against hop distances from the nearest center, found
+// by relaxing every edge until nothing changes.  Returns 1 on any
+// difference.
+
+long long checkNestedBalls( const frozenGraph& frozen,
+                            const vector<int>& centers, int maxRadius ) {
+
+   int n = frozen.nodeSize();
+
+   vector<int> order;
+   vector<int> ballEnds;
+
+   nestedBalls(frozen, centers, maxRadius, order, ballEnds);
+
+   vector<int> distance( n, n );
+
+   for ( unsigned int i = 0; i < centers.size(); i++ ) {
+      distance[ centers[i] ] = 0;
+   }
+
+   for ( bool changed = true; changed; ) {
+
+      changed = false;
+
+      for ( int e = 0; e < frozen.edgeSize(); e++ ) {
+
+         int node_1 = frozen.endpoints[2 * e];
+         int node_2 = frozen.endpoints[2 * e + 1];
+         int shorter = min(distance[node_1], distance[node_2]) + 1;
+
+         if ( shorter < distance[node_1] || shorter < distance[node_2] ) {
+
+            distance[node_1] = min(distance[node_1], shorter);
+            distance[node_2] = min(distance[node_2], shorter);
+            changed = true;
+         }
+      }
+   }
+
+   if ( (int) ballEnds.size() != maxRadius + 1
+         || (int) order.size() != ballEnds[maxRadius] ) {
+      return 1;
+   }
+
+   vector<bool> listed( n, false );
+
+   for ( int r = 0, i = 0; r <= maxRadius; r++ ) {
+
+      int within = 0;
+
+      for ( int v = 0; v < n; v++ ) {
+
+         if ( distance[v] <= r ) {
+            within++;
+         }
+      }
+
+      if ( ballEnds[r] != within ) {
+         return 1;
+      }
+
+      for ( ; i < ballEnds[r]; i++ ) {
+
+         if ( listed[ order[i] ] || distance[ order[i] ] > r ) {
+            return 1;
+         }
+
+         listed[ order[i] ] = true;
+      }
+   }
+
+   return 0;
+}
+
+// Site percolation along every removal order, a prefix of the random one,
+// and bond percolation along a random edge order, each against
+// recomputing the components after every removal; the degree orders
+// against picking each node by scanning; and nested balls around a few
+// centers against their distances.  Small graphs only: the brute force is
+// quadratic.
+
+long long checkPercolation( TRandomMersenne& generator,
+                            const frozenGraph& frozen ) {
+
+   int n = frozen.nodeSize();
+
+   removalStrategy strategies[] = { REMOVE_RANDOM, REMOVE_DEGREE,
+                                    REMOVE_ADAPTIVE_DEGREE, REMOVE_BALLS };
+
+   long long mismatches = 0;
+   vector<int> order;
+   vector<int> expected;
+
+   for ( int s = 0; s < 4; s++ ) {
+
+      removalOrder(frozen, strategies[s], order, generator.IRandom(0, 1000),
+                   generator.IRandom(0, 3));
+
+      if ( (int) order.size() != n ) {
+         mismatches++;
+      }
+
+      mismatches += checkProfile(frozen, order, false);
+
+      if ( strategies[s] == REMOVE_RANDOM ) {
+
+         order.resize( generator.IRandom(0, n) );
+         mismatches += checkProfile(frozen, order, false);
+      }
+
+      if ( strategies[s] == REMOVE_DEGREE
+            || strategies[s] == REMOVE_ADAPTIVE_DEGREE ) {
+
+         bruteDegreeOrder(frozen, strategies[s] == REMOVE_ADAPTIVE_DEGREE,
+                          expected);
+
+         if ( order != expected ) {
+            mismatches++;
+         }
+      }
+   }
+
+   // Edges in a random order.
+
+   order.resize( frozen.edgeSize() );
+
+   for ( int e = 0; e < frozen.edgeSize(); e++ ) {
+      order[e] = e;
+   }
+
+   for ( int e = frozen.edgeSize() - 1; e > 0; e-- ) {
+      swap( order[e], order[ generator.IRandom(0, e) ] );
+   }
+
+   mismatches += checkProfile(frozen, order, true);
+
+   // A few centers, repeats allowed.
+
+   vector<int> centers;
+
+   for ( int i = generator.IRandom(1, 4); i > 0; i-- ) {
+      centers.push_back( generator.IRandom(0, n - 1) );
+   }
+
+   mismatches += checkNestedBalls(frozen, centers, generator.IRandom(0, 4));
+
+   return mismatches;
+}
+
+long long checkTriangles( const frozenGraph& frozen ) {
+
+   int n = frozen.nodeSize();
+
+   triangleIndex index;
+
+   countTriangles(frozen, index);
+
+   // Distinct neighbors of each node, other than itself, sorted.
+
+   vector< vector<int> > neighbors( n );
+
+   for ( int v = 0; v < n; v++ ) {
+
+      for ( int j = frozen.offsets[v]; j < frozen.offsets[v + 1]; j++ ) {
+
+         if ( frozen.adjacency[j] != v ) {
+            neighbors[v].push_back(frozen.adjacency[j]);
+         }
+      }
+
+      sort( neighbors[v].begin(), neighbors[v].end() );
+      neighbors[v].erase( unique(neighbors[v].begin(), neighbors[v].end()),
+                          neighbors[v].end() );
+   }
+
+   // Each triangle through v is an edge v-w with a common neighbor, and
+   // is seen twice that way.
+
+   long long mismatches = 0;
+   long long total = 0;
+   vector<int> common;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      long long through = 0;
+
+      for ( unsigned int i = 0; i < neighbors[v].size(); i++ ) {
+
+         int w = neighbors[v][i];
+
+         common.clear();
+         set_intersection( neighbors[v].begin(), neighbors[v].end(),
+                           neighbors[w].begin(), neighbors[w].end(),
+                           back_inserter(common) );
+
+         through += common.size();
+      }
+
+      through /= 2;
+      total += through;
+
+      if ( through != index.triangles[v]
+            || (int) neighbors[v].size() != index.degree[v] ) {
+         mismatches++;
+      }
+   }
+
+   if ( total / 3 != index.total ) {
+      mismatches++;
+   }
+
+   return mismatches;
+}
+
+long long checkTables( const frozenGraph& frozen, int landmarkCount ) {
+
+   int n = frozen.nodeSize();
+
+   // Landmarks: the highest-index nodes have the lowest weights, so take
+   // the lowest indices, which are the hubs.
+
+   vector<int> landmarks;
+
+   for ( int i = 0; i < landmarkCount && i < n; i++ ) {
+      landmarks.push_back(i);
+   }
+
+   routingScheme scheme(frozen, landmarks);
+   routingTables tables(scheme);
+
+   long long mismatches = 0;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      for ( unsigned int i = 0; i < landmarks.size(); i++ ) {
+
+         if ( tables.landmarkPort(v, i)
+               != scheme.landmarkPorts[ (long long) i * n + v ] ) {
+            mismatches++;
+         }
+      }
+
+      for ( int j = 0; j < scheme.ballSize(v); j++ ) {
+
+         int target = scheme.ballNodes[ scheme.ballOffsets[v] + j ];
+
+         if ( tables.ballPort(v, j) != scheme.ballPorts[ scheme.ballOffsets[v] + j ]
+               || tables.tablePort(v, target) != scheme.tablePort(v, target) ) {
+            mismatches++;
+         }
+      }
+
+      if ( tables.tableSize(v) != scheme.tableSize(v) ) {
+         mismatches++;
+      }
+   }
+
+   return mismatches;
+}
+
+// Apply random updates to G, logging each by its outcome the way
+// multiGraphManager does.  'pairs' holds the endpoints of edges that may
+// still be there, for deletions by endpoints; IDs drawn at random may name
+// nodes that are gone, and such updates should change nothing either way.
+
+void randomUpdates( TRandomMersenne& generator, multiGraph* G, int count,
+                    vector<int>& pairs, updateLogWriter& log ) {
+
+   updateRecord update;
+
+   for ( int i = 0; i < count; ) {
+
+      // Runs of one kind of update, so the log gets runs longer than one.
+
+      int kind = generator.IRandom(0, 6);
+      int length = generator.IRandom(1, 8);
+
+      for ( int r = 0; r < length && i < count; r++, i++ ) {
+
+         int next = max(G->getNodeIndex(), 1);
+
+         switch ( kind ) {
+
+         case 0:
+
+            initUpdate(update, UPDATE_ADD_NODE);
+            G->addNode();
+            break;
+
+         case 1:
+
+            initUpdate(update, UPDATE_DELETE_NODE);
+            update.node_1 = generator.IRandom(0, next - 1);
+            G->deleteNode(update.node_1);
+            break;
+
+         case 2:
+
+            initUpdate(update, UPDATE_DELETE_RANDOM_NODE);
+            update._node_1 = G->deleteRandomNode();
+            break;
+
+         case 3:
+
+            // Loops too, now and then.
+
+            initUpdate(update, UPDATE_ADD_EDGE);
+            update.node_1 = generator.IRandom(0, next - 1);
+            update.node_2 = generator.IRandom(0, 9)
+                            ? generator.IRandom(0, next - 1) : update.node_1;
+
+            if ( G->addEdge(update.node_1, update.node_2) != -1 ) {
+               pairs.push_back(update.node_1);
+               pairs.push_back(update.node_2);
+            }
+            break;
+
+         case 4:
+
+            initUpdate(update, UPDATE_DELETE_EDGE);
+
+            if ( !pairs.empty() ) {
+
+               int e = generator.IRandom(0, pairs.size() / 2 - 1);
+
+               update.node_1 = pairs[2 * e];
+               update.node_2 = pairs[2 * e + 1];
+            }
+
+            G->deleteEdge(update.node_1, update.node_2);
+            break;
+
+         case 5: {
+
+            initUpdate(update, UPDATE_DELETE_RANDOM_EDGE);
+
+            vector<int> ends = G->deleteRandomEdge();
+
+            if ( ends.size() == 2 ) {
+               update._node_1 = ends[0];
+               update._node_2 = ends[1];
+            }
+            break;
+         }
+
+         default:
+
+            initUpdate(update, UPDATE_INC_TIME);
+            G->incTime();
+            break;
+         }
+
+         log.write(update);
+      }
+   }
+}
+
+// Apply random updates to one copy of the graph, logging them, and replay
+// the log onto another; the two should end up the same, down to the node
+// IDs and the time.
+
+long long checkUpdateLog( TRandomMersenne& generator, int n,
+                          const vector<int>& endpoints ) {
+
+   char name[SCRATCH_NAME_SIZE];
+   updateLogWriter log;
+
+   if ( !scratchFile(name) || !log.open(name) ) {
+      return 1;
+   }
+
+   multiGraph* G = graphFromEndpoints(n, endpoints);
+   multiGraph* replayed = graphFromEndpoints(n, endpoints);
+   vector<int> pairs( endpoints );
+
+   randomUpdates(generator, G, UPDATES_PER_NODE * n, pairs, log);
+
+   // Finish with a run longer than the writer will build, so it's split.
+
+   updateRecord update;
+
+   initUpdate(update, UPDATE_INC_TIME);
+
+   for ( int i = 0; i <= UPDATE_LOG_MAX_RUN; i++ ) {
+
+      G->incTime();
+      log.write(update);
+   }
+
+   log.close();
+
+   long long mismatches = 0;
+
+   if ( replayUpdateLog(name, replayed) < 0 ) {
+      mismatches++;
+   }
+
+   unlink(name);
+
+   if ( G->getTime() != replayed->getTime() ) {
+      mismatches++;
+   }
+
+   frozenGraph frozen(G);
+   frozenGraph frozenReplay(replayed);
+
+   delete G;
+   delete replayed;
+
+   return mismatches + compareGraphs(frozen, frozenReplay);
+}
+
+// Pack a block into a frame and unpack it again.  The frame has to fit
+// the bound, its header has to give both lengths, a block that didn't
+// shrink has to be stored as is, and the round trip has to give the block
+// back.  Returns 1 if any of that fails.
+
+long long checkBlock( const char* data, int length ) {
+
+   vector<char> frame( PACKED_BLOCK_BOUND(length) );
+   vector<char> unpacked( length + 1 );
+
+   int frameSize = packBlock(data, length, &frame[0]);
+   int rawLength;
+   int packedLength;
+
+   readBlockHeader(&frame[0], rawLength, packedLength);
+
+   if ( frameSize > (int) frame.size() || rawLength != length
+         || packedLength != frameSize - BLOCK_HEADER_SIZE
+         || packedLength > length ) {
+      return 1;
+   }
+
+   if ( packedLength == length
+         && !equal(data, data + length, &frame[BLOCK_HEADER_SIZE]) ) {
+      return 1;
+   }
+
+   if ( !unpackBlock(&frame[BLOCK_HEADER_SIZE], packedLength, &unpacked[0],
+                     rawLength)
+         || !equal(data, data + length, &unpacked[0]) ) {
+      return 1;
+   }
+
+   return 0;
+}
+
+// Fill a block of 'length' bytes of one of four kinds: random bytes,
+// zeros, a short random pattern repeated [so matches overlap themselves],
+// or literals mixed with copies from up to 100000 bytes back [past the
+// reach of a 2-byte offset].
+
+void randomBlock( TRandomMersenne& generator, int length,
+                  vector<char>& data ) {
+
+   int kind = generator.IRandom(0, 3);
+   int period = generator.IRandom(1, 8);
+
+   data.assign(length, 0);
+
+   for ( int i = 0; i < length; ) {
+
+      if ( kind == 0 || (kind == 2 && i < period) ) {
+
+         data[i++] = (char) generator.IRandom(0, 255);
+
+      } else if ( kind == 1 ) {
+
+         i++;
+
+      } else if ( kind == 2 ) {
+
+         data[i] = data[i - period];
+         i++;
+
+      } else if ( i == 0 || generator.IRandom(0, 1) ) {
+
+         // A few literals, from a small alphabet so they match too.
+
+         for ( int j = generator.IRandom(1, 20); j > 0 && i < length; j-- ) {
+            data[i++] = (char) ('a' + generator.IRandom(0, 3));
+         }
+
+      } else {
+
+         int offset = generator.IRandom(1, min(i, 100000));
+
+         for ( int j = generator.IRandom(1, 300); j > 0 && i < length; j-- ) {
+            data[i] = data[i - offset];
+            i++;
+         }
+      }
+   }
+}
+
+// Pack and unpack the graph's edge list as text, in output-sized blocks,
+// and some random blocks.  'blocks' counts the blocks checked.
+
+long long checkCodec( TRandomMersenne& generator, const frozenGraph& frozen,
+                      long long& blocks ) {
+
+   string text;
+   char line[32];
+
+   for ( int e = 0; e < frozen.edgeSize(); e++ ) {
+
+      snprintf(line, sizeof(line), "%d %d\n", frozen.endpoints[2 * e],
+               frozen.endpoints[2 * e + 1]);
+      text += line;
+   }
+
+   long long mismatches = 0;
+
+   for ( unsigned int start = 0; start < text.size();
+         start += OUTPUT_BLOCK_SIZE ) {
+
+      int length = min( (int) (text.size() - start), OUTPUT_BLOCK_SIZE );
+
+      mismatches += checkBlock(text.data() + start, length);
+      blocks++;
+   }
+
+   vector<char> data;
+
+   for ( int i = 0; i < BLOCKS_PER_GRAPH; i++ ) {
+
+      // Half the blocks are tiny, down to empty.
+
+      int length = generator.IRandom(0, 1)
+                   ? generator.IRandom(0, 32)
+                   : generator.IRandom(0, OUTPUT_BLOCK_SIZE);
+
+      randomBlock(generator, length, data);
+
+      mismatches += checkBlock(data.empty() ? "" : &data[0], length);
+      blocks++;
+   }
+
+   return mismatches;
+}
+
+// Count the nodes whose sorted neighbor lists [by dense index] differ
+// between 'frozen' and the graph on 'numNodes' nodes with these endpoints.
+// Graphs of different sizes differ everywhere.
+
+long long compareEndpoints( const frozenGraph& frozen, int numNodes,
+                            const vector<int>& endpoints ) {
+
+   int n = frozen.nodeSize();
+
+   if ( n != numNodes || 2 * frozen.edgeSize() != (int) endpoints.size() ) {
+      return max( max(n, numNodes), 1 );
+   }
+
+   // Neighbor lists from the endpoints, with loops listed twice as in
+   // frozenGraph.
+
+   vector< vector<int> > neighbors( n );
+
+   for ( unsigned int i = 0; i + 1 < endpoints.size(); i += 2 ) {
+
+      if ( endpoints[i] < 0 || endpoints[i] >= n
+            || endpoints[i + 1] < 0 || endpoints[i + 1] >= n ) {
+         return n;
+      }
+
+      neighbors[ endpoints[i] ].push_back(endpoints[i + 1]);
+      neighbors[ endpoints[i + 1] ].push_back(endpoints[i]);
+   }
+
+   long long mismatches = 0;
+   vector<int> expected;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      expected.assign( frozen.adjacency.begin() + frozen.offsets[v],
+                       frozen.adjacency.begin() + frozen.offsets[v + 1] );
+
+      sort( expected.begin(), expected.end() );
+      sort( neighbors[v].begin(), neighbors[v].end() );
+
+      if ( expected != neighbors[v] ) {
+         mismatches++;
+      }
+   }
+
+   return mismatches;
+}
+
+// Delete a few nodes from G, so its IDs aren't dense, then write it in
+// each format and read it back.  What's read should be G renumbered
+// densely in order of ID, every loop and parallel edge included.  Returns
+// the number of nodes that differ, over the three formats.
+
+long long checkFormats( TRandomMersenne& generator, multiGraph* G ) {
+
+   vector<int> targets;
+
+   for ( int i = G->getNodeIndex() / 100; i >= 0; i-- ) {
+      targets.push_back( generator.IRandom(0, G->getNodeIndex() - 1) );
+   }
+
+   G->deleteNodes(targets);
+
+   frozenGraph frozen(G);
+
+   graphFormat formats[] = { FORMAT_EDGE_LIST, FORMAT_METIS,
+                             FORMAT_MATRIX_MARKET };
+
+   long long mismatches = 0;
+
+   for ( int f = 0; f < 3; f++ ) {
+
+      char name[SCRATCH_NAME_SIZE];
+      int numNodes;
+      vector<int> endpoints;
+
+      if ( !scratchFile(name) ) {
+
+         mismatches += max(frozen.nodeSize(), 1);
+         continue;
+      }
+
+      if ( !writeGraphFile(name, formats[f], G)
+            || !readGraphFile(name, formats[f], numNodes, endpoints) ) {
+
+         unlink(name);
+         mismatches += max(frozen.nodeSize(), 1);
+         continue;
+      }
+
+      unlink(name);
+
+      mismatches += compareEndpoints(frozen, numNodes, endpoints);
+   }
+
+   return mismatches;
+}
+
+// Write each value with putDouble, one per line, and compare the lines
+// with "%g".  Fails every value if the scratch file can't be made.
+
+long long checkDoubles( const vector<double>& values ) {
+
+   char name[SCRATCH_NAME_SIZE];
+
+   if ( !scratchFile(name) ) {
+      return values.size();
+   }
+
+   outputBuffer out;
+
+   if ( !out.open(name) ) {
+
+      unlink(name);
+      return values.size();
+   }
+
+   for ( unsigned int i = 0; i < values.size(); i++ ) {
+      out << values[i] << '\n';
+   }
+
+   out.close();
+
+   FILE* in = fopen(name, "r");
+   long long mismatches = 0;
+   char line[64];
+   char expected[64];
+
+   for ( unsigned int i = 0; i < values.size(); i++ ) {
+
+      snprintf(expected, sizeof(expected), "%g\n", values[i]);
+
+      if ( in == NULL || fgets(line, sizeof(line), in) == NULL
+            || strcmp(line, expected) != 0 ) {
+         mismatches++;
+      }
+   }
+
+   if ( in != NULL ) {
+      fclose(in);
+   }
+
+   unlink(name);
+
+   return mismatches;
+}
+
+// The values for checkDoubles: edge cases, then 'count' random values of
+// every magnitude, some cut to seven significant digits so the sixth is
+// often a tie.
+
+void doubleValues( TRandomMersenne& generator, int count,
+                   vector<double>& values ) {
+
+   double edges[] = { 0.0, -0.0, 1.0, -1.0, 0.5, 0.125, 2.5, -2.5,
+                      123456.5, 123457.5, 1234565, 1234575, -1234565,
+                      999999, 999999.4, 999999.5, 999999.6, 1e6, -1e6,
+                      1e6 + 0.5, 1000005, 1000015, 9999995, 0.0001,
+                      0.00001, 0.000099999, 0.0000999995, 0.00009999949,
+                      1e-5, -1e-5, 1e-4, -1e-4, 99999.95, 1e100, 1e-100,
+                      1e300, 1e-300, DBL_MAX, -DBL_MAX, DBL_MIN, 5e-324,
+                      HUGE_VAL, -HUGE_VAL };
+
+   values.assign(edges, edges + sizeof(edges) / sizeof(edges[0]));
+
+   // Powers of ten and their neighbors on either side.
+
+   for ( int p = -20; p <= 20; p++ ) {
+
+      double power = pow(10.0, p);
+
+      values.push_back(power);
+      values.push_back(-power);
+      values.push_back( nextafter(power, 0.0) );
+      values.push_back( nextafter(power, HUGE_VAL) );
+   }
+
+   for ( int i = 0; i < count; i++ ) {
+
+      double value;
+
+      if ( generator.IRandom(0, 1) ) {
+         value = generator.IRandom(0, 9999999)
+                 * pow(10.0, generator.IRandom(-12, 6));
+      } else {
+         value = generator.Random() * pow(10.0, generator.IRandom(-12, 12));
+      }
+
+      values.push_back( generator.IRandom(0, 1) ? value : -value );
+   }
+}
+
+int main(int argc, char* argv[]) {
+
+   int graphs = ( argc > 1 ) ? atoi(argv[1]) : 20;
+   int seed = ( argc > 2 ) ? atoi(argv[2]) : 1;
+
+   TRandomMersenne generator(seed);
+
+   long long coreMismatches = 0;
+   long long triangleMismatches = 0;
+   long long tableMismatches = 0;
+   long long logMismatches = 0;
+   long long percolationMismatches = 0;
+   long long codecMismatches = 0;
+   long long formatMismatches = 0;
+   long long blocks = 0;
+   int smallGraphs = 0;
+
+   for ( int g = 0; g < graphs; g++ ) {
+
+      bool big = ( g % BIG_EVERY == BIG_EVERY - 1 );
+      int n = big ? BIG_NODES : 1 + generator.IRandom(0, SMALL_NODES - 1);
+      double degree = 1 + 7 * generator.Random();
+
+      vector<int> endpoints;
+
+      randomEndpoints(generator, n, degree, endpoints);
+
+      multiGraph* G = graphFromEndpoints(n, endpoints);
+      frozenGraph frozen(G);
+
+      coreMismatches += checkCores(frozen);
+      triangleMismatches += checkTriangles(frozen);
+      tableMismatches += checkTables(frozen, big ? 40 : generator.IRandom(0, 8));
+      codecMismatches += checkCodec(generator, frozen, blocks);
+      formatMismatches += checkFormats(generator, G);
+
+      delete G;
+
+      if ( !big ) {
+
+         percolationMismatches += checkPercolation(generator, frozen);
+         logMismatches += checkUpdateLog(generator, n, endpoints);
+         smallGraphs++;
+      }
+   }
+
+   vector<double> values;
+
+   doubleValues(generator, DOUBLES_PER_GRAPH * graphs, values);
+
+   long long doubleMismatches = checkDoubles(values);
+
+   cout << "cores " << graphs << " " << coreMismatches << endl;
+   cout << "triangles " << graphs << " " << triangleMismatches << endl;
+   cout << "tables " << graphs << " " << tableMismatches << endl;
+   cout << "percolation " << smallGraphs << " " << percolationMismatches
+        << endl;
+   cout << "updates " << smallGraphs << " " << logMismatches << endl;
+   cout << "formats " << graphs << " " << formatMismatches << endl;
+   cout << "blocks " << blocks << " " << codecMismatches << endl;
+   cout << "doubles " << values.size() << " " << doubleMismatches << endl;
+
+   return ( coreMismatches + triangleMismatches + tableMismatches
+            + percolationMismatches + logMismatches + formatMismatches
+            + codecMismatches + doubleMismatches > 0 ) ? 1 : 0;
+}
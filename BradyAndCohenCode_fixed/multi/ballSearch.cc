@@ -0,0 +1,84 @@
+// ballSearch.cc: Definitions for a breadth-first search truncated at a
+// given radius.
+
+#include "ballSearch.h"
+
+// -------------
+// Constructors.
+// -------------
+
+ballSearch::ballSearch( const frozenGraph& frozen ) :
+   offsets(frozen.offsets),
+   adjacency(frozen.adjacency),
+   generation(0),
+   stamp( frozen.nodeSize(), 0 ),
+   level( frozen.nodeSize(), 0 ),
+   hop( frozen.nodeSize(), -1 ) {
+
+}
+
+ballSearch::ballSearch( const vector<int>& offsets,
+                        const vector<int>& adjacency ) :
+   offsets(offsets),
+   adjacency(adjacency),
+   generation(0),
+   stamp( offsets.size() - 1, 0 ),
+   level( offsets.size() - 1, 0 ),
+   hop( offsets.size() - 1, -1 ) {
+
+}
+
+// -------------------
+// Mutator functions.
+// -------------------
+
+void ballSearch::find( int center, int radius, vector<int>& ball ) {
+
+   ball.clear();
+
+   // Start a new generation; on the rare wraparound, old stamps could
+   // collide with new ones, so wipe them.
+
+   if ( ++generation == 0 ) {
+
+      stamp.assign( stamp.size(), 0 );
+      generation = 1;
+   }
+
+   if ( radius < 0 ) {
+      return;
+   }
+
+   stamp[center] = generation;
+   level[center] = 0;
+   hop[center] = -1;
+   ball.push_back(center);
+
+   // 'ball' doubles as the queue.
+
+   for ( unsigned int next = 0; next < ball.size(); next++ ) {
+
+      int node = ball[next];
+
+      if ( level[node] == radius ) {
+         break;
+      }
+
+      // The first hop toward anything found through 'node' is the first
+      // hop toward it, or the edge to it if 'node' is the center.
+
+      for ( int j = offsets[node]; j < offsets[node + 1]; j++ ) {
+
+         int neighbor = adjacency[j];
+
+         if ( stamp[neighbor] != generation ) {
+
+            stamp[neighbor] = generation;
+            level[neighbor] = level[node] + 1;
+            hop[neighbor] = ( node == center ) ? j - offsets[center]
+                                               : hop[node];
+            ball.push_back(neighbor);
+         }
+      }
+   }
+}
@@ -0,0 +1,91 @@
+// ballSearch.h: Specification for a breadth-first search truncated at a
+// given radius, for finding the ball of nodes around a center.
+//
+// Searches are meant to be run many times over the same frozenGraph, so
+// the per-node state is allocated once and never cleared: each search
+// bumps a generation number, and a node counts as visited only if its
+// stamp matches the current generation.  A search then costs time
+// proportional to the edges inside the ball it finds, however big the
+// graph is.
+//
+// Besides its distance, each node found keeps the first hop on the way to
+// it from the center: the position, in the center's list of neighbors, of
+// the edge the search first left by.  It is handed down from parent to
+// child, so no paths are kept.  Searching over a list of neighbors other
+// than a frozenGraph's [a routingScheme's ports, say] makes the first hop
+// a port.
+//
+// A ballSearch isn't safe to share between threads; give each thread its
+// own.
+
+#ifndef _BALL_SEARCH_H
+#define _BALL_SEARCH_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+class ballSearch {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      ballSearch( const frozenGraph& frozen );
+
+      // Search a graph given as neighbor lists: those of node v are
+      // adjacency[offsets[v] .. offsets[v + 1] - 1].  The lists must
+      // outlive the search.
+
+      ballSearch( const vector<int>& offsets, const vector<int>& adjacency );
+
+      // -------------------
+      // Mutator functions.
+      // -------------------
+
+      // Fill 'ball' with the nodes [dense indices] within 'radius' hops of
+      // 'center', in order of distance, center first.  A negative radius
+      // gives an empty ball.
+
+      void find( int center, int radius, vector<int>& ball );
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      // Hop distance of 'node' from the last center searched, or -1 if it
+      // isn't in the last ball found.
+
+      int distance( int node ) const {
+         return ( stamp[node] == generation ) ? level[node] : -1;
+      }
+
+      // Position in the last center's list of neighbors of the first hop
+      // toward 'node', or -1 if it is the center or isn't in the last ball
+      // found.
+
+      int firstHop( int node ) const {
+         return ( stamp[node] == generation ) ? hop[node] : -1;
+      }
+
+   private:
+
+      // ---------------------
+      // Private data members.
+      // ---------------------
+
+      const vector<int>& offsets;
+      const vector<int>& adjacency;
+
+      unsigned int generation;
+
+      vector<unsigned int> stamp;
+      vector<int> level;
+      vector<int> hop;
+};
+
+#endif
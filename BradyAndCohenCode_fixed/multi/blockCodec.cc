@@ -0,0 +1,253 @@
+// blockCodec.cc: Definitions for the block compression used by compressed
+// output files.
+
+#include "blockCodec.h"
+
+#include <cstring>
+
+// Matches are found through a hash table of recent positions, keyed on the
+// next 4 bytes.
+
+#define LZ_HASH_BITS 14
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+
+static unsigned int read32( const unsigned char* p ) {
+
+   unsigned int value;
+   memcpy(&value, p, sizeof(value));
+
+   return value;
+}
+
+static unsigned int hash4( unsigned int value ) {
+
+   return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static void write32( unsigned char* p, unsigned int value ) {
+
+   p[0] = value & 0xff;
+   p[1] = (value >> 8) & 0xff;
+   p[2] = (value >> 16) & 0xff;
+   p[3] = (value >> 24) & 0xff;
+}
+
+// Extra length bytes for a count that didn't fit in its nibble.
+
+static unsigned char* putLength( unsigned char* out, int length ) {
+
+   while ( length >= 255 ) {
+      *out++ = 255;
+      length -= 255;
+   }
+
+   *out++ = length;
+
+   return out;
+}
+
+static bool getLength( const unsigned char*& in, const unsigned char* end,
+                       int& length ) {
+
+   unsigned char byte;
+
+   do {
+
+      if ( in == end ) {
+         return false;
+      }
+
+      byte = *in++;
+      length += byte;
+
+   } while ( byte == 255 );
+
+   return true;
+}
+
+// Emit one sequence's token, literals and [unless it's the last] match.
+
+static unsigned char* putSequence( unsigned char* out,
+                                   const unsigned char* literals,
+                                   int literalCount, int offset,
+                                   int matchLength ) {
+
+   unsigned char* token = out++;
+
+   *token = (literalCount < 15 ? literalCount : 15) << 4;
+
+   if ( literalCount >= 15 ) {
+      out = putLength(out, literalCount - 15);
+   }
+
+   memcpy(out, literals, literalCount);
+   out += literalCount;
+
+   if ( offset == 0 ) {
+      return out;
+   }
+
+   matchLength -= LZ_MIN_MATCH;
+
+   *token |= (matchLength < 15 ? matchLength : 15);
+
+   *out++ = offset & 0xff;
+   *out++ = offset >> 8;
+
+   if ( matchLength >= 15 ) {
+      out = putLength(out, matchLength - 15);
+   }
+
+   return out;
+}
+
+int packBlock( const char* source, int length, char* dest ) {
+
+   const unsigned char* in = (const unsigned char*) source;
+   const unsigned char* end = in + length;
+
+   unsigned char* start = (unsigned char*) dest + BLOCK_HEADER_SIZE;
+   unsigned char* out = start;
+
+   int table[1 << LZ_HASH_BITS];
+
+   for ( int i = 0; i < (1 << LZ_HASH_BITS); i++ ) {
+      table[i] = -LZ_MAX_OFFSET - 1;
+   }
+
+   const unsigned char* anchor = in;
+   const unsigned char* p = in;
+
+   while ( end - p >= LZ_MIN_MATCH ) {
+
+      unsigned int h = hash4( read32(p) );
+      int candidate = table[h];
+
+      table[h] = p - in;
+
+      if ( (p - in) - candidate > LZ_MAX_OFFSET
+            || read32(in + candidate) != read32(p) ) {
+
+         // Step faster through data that isn't matching.
+
+         p += 1 + ((p - anchor) >> 6);
+         continue;
+      }
+
+      const unsigned char* match = in + candidate;
+      const unsigned char* q = p + LZ_MIN_MATCH;
+
+      while ( q < end && *q == match[q - p] ) {
+         q++;
+      }
+
+      out = putSequence(out, anchor, p - anchor, p - match, q - p);
+
+      p = q;
+      anchor = p;
+   }
+
+   out = putSequence(out, anchor, end - anchor, 0, 0);
+
+   int packedLength = out - start;
+
+   // Store the block as is if that didn't help.
+
+   if ( packedLength >= length ) {
+
+      memcpy(start, source, length);
+      packedLength = length;
+   }
+
+   write32( (unsigned char*) dest, length );
+   write32( (unsigned char*) dest + 4, packedLength );
+
+   return BLOCK_HEADER_SIZE + packedLength;
+}
+
+void readBlockHeader( const char* header, int& rawLength,
+                      int& packedLength ) {
+
+   const unsigned char* p = (const unsigned char*) header;
+
+   rawLength = p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+   packedLength = p[4] | (p[5] << 8) | (p[6] << 16) | (p[7] << 24);
+}
+
+bool unpackBlock( const char* source, int packedLength, char* dest,
+                  int rawLength ) {
+
+   if ( packedLength == rawLength ) {
+      memcpy(dest, source, rawLength);
+      return true;
+   }
+
+   const unsigned char* in = (const unsigned char*) source;
+   const unsigned char* inEnd = in + packedLength;
+
+   unsigned char* out = (unsigned char*) dest;
+   unsigned char* outEnd = out + rawLength;
+
+   while ( in < inEnd ) {
+
+      int token = *in++;
+      int literalCount = token >> 4;
+
+      if ( literalCount == 15 && !getLength(in, inEnd, literalCount) ) {
+         return false;
+      }
+
+      if ( inEnd - in < literalCount || outEnd - out < literalCount ) {
+         return false;
+      }
+
+      memcpy(out, in, literalCount);
+      in += literalCount;
+      out += literalCount;
+
+      if ( in == inEnd ) {
+         break;
+      }
+
+      if ( inEnd - in < 2 ) {
+         return false;
+      }
+
+      int offset = in[0] | (in[1] << 8);
+      in += 2;
+
+      int matchLength = token & 15;
+
+      if ( matchLength == 15 && !getLength(in, inEnd, matchLength) ) {
+         return false;
+      }
+
+      matchLength += LZ_MIN_MATCH;
+
+      if ( offset == 0 || out - (unsigned char*) dest < offset
+            || outEnd - out < matchLength ) {
+         return false;
+      }
+
+      // A match that overlaps what it's producing [a run] has to be
+      // copied byte by byte.
+
+      const unsigned char* match = out - offset;
+
+      if ( offset >= matchLength ) {
+
+         memcpy(out, match, matchLength);
+
+      } else {
+
+         for ( int i = 0; i < matchLength; i++ ) {
+            out[i] = match[i];
+         }
+      }
+
+      out += matchLength;
+   }
+
+   return out == outEnd;
+}
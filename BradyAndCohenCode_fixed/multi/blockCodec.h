@@ -0,0 +1,49 @@
+// blockCodec.h: Specification for the block compression used by
+// compressed output files.
+//
+// A compressed file is the 8-byte header BLOCK_FILE_MAGIC followed by one
+// frame per output block.  A frame is an 8-byte header [the block's raw
+// length, then its packed length, each 4 bytes little-endian] and the
+// packed data.  Every block is compressed on its own, so any block can be
+// decompressed without the ones before it: readers can seek, and can
+// decompress several blocks at once.
+//
+// The codec is a byte-oriented LZ77 in the style of LZ4.  A block is a
+// series of sequences, each a token byte [literal count in the high
+// nibble, match length - 4 in the low one; 15 means more length bytes
+// follow, each added in until one is below 255], the literals, and a
+// 2-byte little-endian match offset followed by the match's extra length
+// bytes.  The last sequence has only literals.  A block that doesn't get
+// any smaller is stored as is, with packed length == raw length.
+
+#ifndef _BLOCK_CODEC_H
+#define _BLOCK_CODEC_H
+
+#define BLOCK_FILE_MAGIC "MGBLZ001"
+
+#define BLOCK_FILE_MAGIC_SIZE 8
+#define BLOCK_HEADER_SIZE 8
+
+// Most bytes packBlock() can produce for 'length' bytes of input, header
+// included.
+
+#define PACKED_BLOCK_BOUND(length) \
+   (BLOCK_HEADER_SIZE + (length) + (length) / 255 + 16)
+
+// Compress 'length' bytes into a complete frame at 'dest', which must hold
+// PACKED_BLOCK_BOUND(length) bytes.  Returns the frame's size.
+
+int packBlock( const char* source, int length, char* dest );
+
+// Read a frame header.
+
+void readBlockHeader( const char* header, int& rawLength,
+                      int& packedLength );
+
+// Decompress a frame's data into 'dest', which must hold rawLength bytes.
+// Returns false if the data is corrupt.
+
+bool unpackBlock( const char* source, int packedLength, char* dest,
+                  int rawLength );
+
+#endif
@@ -0,0 +1,238 @@
+// components.cc: Definitions for connected-component labelling of a
+// frozenGraph.
+
+#include "components.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+// ----------------------------
+// Lock-free union-find helpers.
+// ----------------------------
+
+// Find the root of x's tree, halving the path on the way.  Racing threads
+// may halve the same path; any parent they install is still an ancestor,
+// so that's harmless.
+
+static int findRoot( int* parent, int x ) {
+
+   while ( true ) {
+
+      int up = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
+
+      if ( up == x ) {
+         return x;
+      }
+
+      int upUp = __atomic_load_n(&parent[up], __ATOMIC_RELAXED);
+
+      if ( upUp != up ) {
+         __atomic_compare_exchange_n(&parent[x], &up, upUp, false,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+      }
+
+      x = upUp;
+   }
+}
+
+static void unite( int* parent, int x, int y ) {
+
+   while ( true ) {
+
+      x = findRoot(parent, x);
+      y = findRoot(parent, y);
+
+      if ( x == y ) {
+         return;
+      }
+
+      // Hang the higher root under the lower, if it's still a root.
+
+      int high = max(x, y);
+      int low = min(x, y);
+
+      if ( __atomic_compare_exchange_n(&parent[high], &high, low, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) ) {
+         return;
+      }
+   }
+}
+
+// One thread's share of the edges.
+
+typedef struct {
+
+   int* parent;
+   const int* endpoints;
+   int begin;
+   int end;
+
+} uniteJob;
+
+static void* uniteMain( void* arg ) {
+
+   uniteJob* job = (uniteJob*) arg;
+
+   for ( int e = job->begin; e < job->end; e++ ) {
+      unite(job->parent, job->endpoints[2 * e], job->endpoints[2 * e + 1]);
+   }
+
+   return NULL;
+}
+
+// -------------------
+// Component labelling.
+// -------------------
+
+void findComponents( const frozenGraph& frozen,
+                     componentIndex& components ) {
+
+   int n = frozen.nodeSize();
+   int m = frozen.edgeSize();
+
+   vector<int>& parent = components.label;
+
+   parent.resize(n);
+
+   for ( int i = 0; i < n; i++ ) {
+      parent[i] = i;
+   }
+
+   if ( m > 0 ) {
+
+      vector<uniteJob> jobs( jobCount(m, COMPONENT_EDGES_MIN) );
+
+      for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+         jobs[i].parent = &parent[0];
+         jobs[i].endpoints = &frozen.endpoints[0];
+         jobs[i].begin = (long long) m * i / jobs.size();
+         jobs[i].end = (long long) m * (i + 1) / jobs.size();
+      }
+
+      runJobs(jobs, uniteMain);
+   }
+
+   // Point every node straight at its root.
+
+   for ( int i = 0; i < n; i++ ) {
+      parent[i] = findRoot(&parent[0], i);
+   }
+
+   // Every root is its component's lowest-numbered node, so it comes
+   // before the rest of the component: one pass in order both numbers the
+   // components and relabels each node.
+
+   components.nodeCount.clear();
+
+   for ( int i = 0; i < n; i++ ) {
+
+      if ( parent[i] == i ) {
+
+         parent[i] = components.nodeCount.size();
+         components.nodeCount.push_back(0);
+
+      } else {
+
+         parent[i] = parent[ parent[i] ];
+      }
+
+      components.nodeCount[ parent[i] ]++;
+   }
+
+   components.edgeCount.assign( components.size(), 0 );
+   components.loopCount.assign( components.size(), 0 );
+   components.parallelCount.assign( components.size(), 0 );
+
+   for ( int e = 0; e < m; e++ ) {
+
+      int node_1 = frozen.endpoints[2 * e];
+
+      components.edgeCount[ parent[node_1] ]++;
+
+      if ( node_1 == frozen.endpoints[2 * e + 1] ) {
+         components.loopCount[ parent[node_1] ]++;
+      }
+   }
+
+   // Count parallel edges from each node's side toward its higher-numbered
+   // neighbors, so each copy is seen once: lastSeen[v] == i means v has
+   // already turned up in node i's list.
+
+   vector<int> lastSeen( n, -1 );
+
+   for ( int i = 0; i < n; i++ ) {
+
+      for ( int j = frozen.offsets[i]; j < frozen.offsets[i + 1]; j++ ) {
+
+         int neighbor = frozen.adjacency[j];
+
+         if ( neighbor <= i ) {
+            continue;
+         }
+
+         if ( lastSeen[neighbor] == i ) {
+            components.parallelCount[ parent[i] ]++;
+         } else {
+            lastSeen[neighbor] = i;
+         }
+      }
+   }
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+int componentIndex::cyclicSize( void ) const {
+
+   int count = 0;
+
+   for ( int c = 0; c < size(); c++ ) {
+
+      if ( isCyclic(c) ) {
+         count++;
+      }
+   }
+
+   return count;
+}
+
+long long componentIndex::extraEdges( void ) const {
+
+   long long count = 0;
+
+   for ( int c = 0; c < size(); c++ ) {
+
+      if ( isCyclic(c) ) {
+         count += excessEdges(c);
+      }
+   }
+
+   return count;
+}
+
+// Sort by decreasing size, breaking ties by component number.
+
+static bool largerComponent( const pair<int, int>& a,
+                             const pair<int, int>& b ) {
+
+   return a.first > b.first || ( a.first == b.first && a.second < b.second );
+}
+
+void componentIndex::bySize( vector<int>& order ) const {
+
+   vector< pair<int, int> > sizes( size() );
+
+   for ( int c = 0; c < size(); c++ ) {
+      sizes[c] = make_pair(nodeCount[c], c);
+   }
+
+   sort( sizes.begin(), sizes.end(), largerComponent );
+
+   order.resize( size() );
+
+   for ( int c = 0; c < size(); c++ ) {
+      order[c] = sizes[c].second;
+   }
+}
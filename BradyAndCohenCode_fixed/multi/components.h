@@ -0,0 +1,89 @@
+// components.h: Specification for connected-component labelling of a
+// frozenGraph.
+//
+// Components are found with a lock-free union-find over the edge list,
+// split across threads: each thread links the endpoints of its share of
+// the edges, always hanging the higher-numbered root under the lower one
+// with a compare-and-swap, so concurrent links can't form a cycle.
+// Components are numbered in order of their lowest-numbered node.
+//
+// Self-loops and parallel edges count as cycles, so a component is
+// acyclic [a tree] exactly when it has one edge fewer than it has nodes.
+// Every statistic is gathered from the frozen copy, so the multiGraph
+// itself is never touched.
+
+#ifndef _COMPONENTS_H
+#define _COMPONENTS_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+// Fewest edges worth handing to a thread of its own.
+
+#define COMPONENT_EDGES_MIN (1 << 16)
+
+class componentIndex {
+
+   public:
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Component of each node [by dense index], and the node and edge
+      // count of each component.
+
+      vector<int> label;
+      vector<int> nodeCount;
+      vector<int> edgeCount;
+
+      // Self-loops in each component, and parallel edges: every copy of a
+      // multiedge after the first.  [Repeated loops count only as loops.]
+
+      vector<int> loopCount;
+      vector<int> parallelCount;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      int size( void ) const {
+         return nodeCount.size();
+      }
+
+      // |E(C)| - (|V(C)| - 1): zero for a tree, positive otherwise.
+
+      int excessEdges( int component ) const {
+         return edgeCount[component] - (nodeCount[component] - 1);
+      }
+
+      bool isTree( int component ) const {
+         return excessEdges(component) == 0;
+      }
+
+      bool isCyclic( int component ) const {
+         return excessEdges(component) > 0;
+      }
+
+      // Number of components containing a cycle.
+
+      int cyclicSize( void ) const;
+
+      // Total of excessEdges() over the components with cycles.
+
+      long long extraEdges( void ) const;
+
+      // Components in decreasing order of node count.
+
+      void bySize( vector<int>& order ) const;
+};
+
+// Label the components of 'frozen' and count their nodes, edges, loops and
+// parallel edges.
+
+void findComponents( const frozenGraph& frozen, componentIndex& components );
+
+#endif
@@ -0,0 +1,109 @@
+// coreSelection.cc: Definitions for choosing the core of a multiGraph by
+// degree.
+
+#include "coreSelection.h"
+#include "degreeStats.h"
+#include "frozenGraph.h"
+#include "thorupZwick.h"
+
+#include <cstdlib>
+#include <math.h>
+
+// ------------
+// Thresholds.
+// ------------
+
+int practicalCoreSize( int n, double tau ) {
+
+   double gamma = (tau - 2) / (2 * tau - 3) + 1e-12;
+
+   return (int) ceil( pow((double) n, gamma) );
+}
+
+double theoreticalDegreeThreshold( int n, double tau ) {
+   return (0.294 * n + 2586.3) * pow(1 / (2.85765 * pow((double) n, 0.118)),
+                                     tau);
+}
+
+// -------------
+// Constructors.
+// -------------
+
+coreSelection::coreSelection( coreStrategy strategy, double parameter ) :
+   strategy( strategy ), parameter( parameter ) {
+}
+
+bool coreSelection::parse( const string& text, coreSelection& selection ) {
+
+   string::size_type colon = text.find(':');
+   string name = text.substr(0, colon);
+   char* end;
+
+   if ( colon == string::npos ) {
+
+      long size = strtol(text.c_str(), &end, 10);
+
+      if ( text.empty() || *end != '\0' || size < 0 ) {
+         return false;
+      }
+
+      selection = coreSelection(coreFixed, size);
+      return true;
+   }
+
+   double tau = strtod(text.c_str() + colon + 1, &end);
+
+   if ( colon + 1 == text.size() || *end != '\0' ) {
+      return false;
+   }
+
+   if ( name == "practical" ) {
+      selection = coreSelection(corePractical, tau);
+   } else if ( name == "theoretical" ) {
+      selection = coreSelection(coreTheoretical, tau);
+   } else if ( name == "tz" && tau >= 0 ) {
+      selection = coreSelection(coreThorupZwick, floor(tau));
+   } else {
+      return false;
+   }
+
+   return true;
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+void coreSelection::select( multiGraph* G, int n, vector<int>& core ) const {
+
+   switch ( strategy ) {
+
+      case corePractical:
+         topDegreeNodes(G, practicalCoreSize(n, parameter), core);
+         break;
+
+      case coreTheoretical:
+         degreeAboveNodes(G, theoreticalDegreeThreshold(n, parameter), core);
+         break;
+
+      case coreFixed:
+         topDegreeNodes(G, (int) parameter, core);
+         break;
+
+      case coreThorupZwick: {
+
+         frozenGraph frozen(G);
+         vector<int> indices;
+
+         thorupZwickCore(frozen, (unsigned int) parameter, indices, NULL);
+
+         core.clear();
+
+         for ( unsigned int i = 0; i < indices.size(); i++ ) {
+            core.push_back( frozen.ids[ indices[i] ] );
+         }
+
+         break;
+      }
+   }
+}
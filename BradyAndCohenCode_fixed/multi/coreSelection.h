@@ -0,0 +1,91 @@
+// coreSelection.h: Specification for choosing the core [the landmarks of
+// the routing scheme] of a multiGraph, with the simulator's Utils
+// strategies.
+//
+//    - practical: the ceil(n^gamma) highest-degree nodes, where
+//      gamma = (tau - 2) / (2 tau - 3) [plus a hair, 1e-12, as in Utils];
+//    - theoretical: every node of degree above
+//      (0.294 n + 2586.3) (2.85765 n^0.118)^-tau, a fit to where routing
+//      through the core stops paying;
+//    - fixed: the k highest-degree nodes, for a given k; and
+//    - Thorup-Zwick: nodes sampled at random until every cluster is small
+//      [see thorupZwick.h], for a given seed.
+//
+// Here n is the number of nodes the graph was generated with and tau the
+// exponent of its degree distribution.
+//
+// Degrees here are multigraph degrees, as degreeHash keeps them: every
+// copy of a multiedge counts, and a loop counts twice.  Utils instead
+// ranks by the degree in the simulator's graph, which collapses parallel
+// edges, so on graphs with many of them the two can pick different nodes
+// and the theoretical threshold lets more in.
+//
+// The degree strategies walk the degreeHash buckets from the top [see
+// degreeStats], so picking k nodes costs O(k) plus one pass over the
+// degrees, with no sorting: a sweep over core sizes can take the largest
+// core once and use its prefixes, since every core is a prefix of the
+// order the buckets give.
+//
+// Cores come back as node IDs, highest degree first [in the order sampled,
+// for Thorup-Zwick], ready to be mapped to a frozenGraph's indices and
+// handed to routingScheme, which breaks ties between equally close
+// landmarks by this order.
+
+#ifndef _CORE_SELECTION_H
+#define _CORE_SELECTION_H
+
+#include <string>
+#include <vector>
+
+#include "multiGraph.h"
+
+using namespace std;
+
+enum coreStrategy { corePractical, coreTheoretical, coreFixed,
+                    coreThorupZwick };
+
+class coreSelection {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      coreSelection( coreStrategy strategy, double parameter );
+
+      // Read a strategy from "practical:tau", "theoretical:tau", "tz:seed"
+      // or a plain core size.  Returns false, leaving 'selection' alone, if
+      // it isn't one.
+
+      static bool parse( const string& text, coreSelection& selection );
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // The strategy, and its parameter: tau, the core size for a fixed
+      // core, or the seed for Thorup-Zwick.
+
+      coreStrategy strategy;
+      double parameter;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      // Set 'core' to the IDs of the core of G, which was generated with n
+      // nodes.
+
+      void select( multiGraph* G, int n, vector<int>& core ) const;
+};
+
+// Size of the practical core of a graph generated with n nodes.
+
+int practicalCoreSize( int n, double tau );
+
+// Degree the theoretical core's nodes must exceed.
+
+double theoreticalDegreeThreshold( int n, double tau );
+
+#endif
@@ -0,0 +1,265 @@
+// cores.cc: Definitions for the k-core decomposition of a frozenGraph.
+
+#include "cores.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+// Tally the k-shells once every node's coreness is known.
+
+static void countShells( coreIndex& cores ) {
+
+   int maxCore = -1;
+
+   for ( unsigned int i = 0; i < cores.coreness.size(); i++ ) {
+      maxCore = max(maxCore, cores.coreness[i]);
+   }
+
+   cores.shellSize.assign( maxCore + 1, 0 );
+
+   for ( unsigned int i = 0; i < cores.coreness.size(); i++ ) {
+      cores.shellSize[ cores.coreness[i] ]++;
+   }
+}
+
+// ----------------------
+// Sequential peeling.
+// ----------------------
+
+void peelCores( const frozenGraph& frozen, coreIndex& cores ) {
+
+   int n = frozen.nodeSize();
+
+   vector<int>& degree = cores.coreness;
+   int maxDegree = 0;
+
+   degree.resize(n);
+
+   for ( int i = 0; i < n; i++ ) {
+      degree[i] = frozen.degree(i);
+      maxDegree = max(maxDegree, degree[i]);
+   }
+
+   // Sort the nodes by degree into 'order'; bucketStart[d] is where the
+   // nodes of degree d begin, and position[v] is where v sits.
+
+   vector<int> bucketStart( maxDegree + 2, 0 );
+   vector<int> order( n );
+   vector<int> position( n );
+
+   for ( int i = 0; i < n; i++ ) {
+      bucketStart[ degree[i] + 1 ]++;
+   }
+
+   for ( int d = 0; d <= maxDegree; d++ ) {
+      bucketStart[d + 1] += bucketStart[d];
+   }
+
+   vector<int> next( bucketStart.begin(), bucketStart.end() - 1 );
+
+   for ( int i = 0; i < n; i++ ) {
+      position[i] = next[ degree[i] ]++;
+      order[ position[i] ] = i;
+   }
+
+   // Peel the nodes in order.  Decrementing a neighbor's degree moves it
+   // to the front of its bucket and then across into the bucket below, so
+   // 'order' stays sorted.
+
+   for ( int i = 0; i < n; i++ ) {
+
+      int node = order[i];
+
+      for ( int j = frozen.offsets[node]; j < frozen.offsets[node + 1];
+            j++ ) {
+
+         int neighbor = frozen.adjacency[j];
+
+         if ( degree[neighbor] > degree[node] ) {
+
+            int first = bucketStart[ degree[neighbor] ];
+            int swapped = order[first];
+
+            order[first] = neighbor;
+            order[ position[neighbor] ] = swapped;
+
+            position[swapped] = position[neighbor];
+            position[neighbor] = first;
+
+            bucketStart[ degree[neighbor] ]++;
+            degree[neighbor]--;
+         }
+      }
+   }
+
+   countShells(cores);
+}
+
+// --------------------
+// Parallel peeling.
+// --------------------
+
+// One thread's share of a scan or a round, and the nodes it found for the
+// next round.
+
+typedef struct {
+
+   const frozenGraph* frozen;
+   int* degree;
+   int level;
+
+   const int* nodes;
+   int begin;
+   int end;
+
+   vector<int> found;
+
+} peelJob;
+
+// Collect the nodes of degree exactly 'level' in [begin, end).
+
+static void* scanMain( void* arg ) {
+
+   peelJob* job = (peelJob*) arg;
+
+   job->found.clear();
+
+   for ( int i = job->begin; i < job->end; i++ ) {
+
+      if ( job->degree[i] == job->level ) {
+         job->found.push_back(i);
+      }
+   }
+
+   return NULL;
+}
+
+// Peel nodes[begin .. end - 1], collecting the neighbors that fall to
+// 'level'.  A neighbor two peeled nodes both decrement can dip below
+// 'level' for a moment; whichever thread takes it below puts it back, and
+// whichever takes it to 'level' exactly claims it.
+
+static void* roundMain( void* arg ) {
+
+   peelJob* job = (peelJob*) arg;
+   const frozenGraph& frozen = *(job->frozen);
+
+   job->found.clear();
+
+   for ( int i = job->begin; i < job->end; i++ ) {
+
+      int node = job->nodes[i];
+
+      for ( int j = frozen.offsets[node]; j < frozen.offsets[node + 1];
+            j++ ) {
+
+         int neighbor = frozen.adjacency[j];
+
+         if ( __atomic_load_n(&job->degree[neighbor], __ATOMIC_RELAXED)
+              <= job->level ) {
+            continue;
+         }
+
+         int left = __atomic_sub_fetch(&job->degree[neighbor], 1,
+                                       __ATOMIC_RELAXED);
+
+         if ( left == job->level ) {
+            job->found.push_back(neighbor);
+         } else if ( left < job->level ) {
+            __atomic_add_fetch(&job->degree[neighbor], 1, __ATOMIC_RELAXED);
+         }
+      }
+   }
+
+   return NULL;
+}
+
+// Run 'jobMain' over nodes[0 .. size - 1] [or over node indices, if 'nodes'
+// is NULL] and gather what the jobs found.
+
+static void runPeelJobs( const frozenGraph& frozen, int* degree, int level,
+                         const int* nodes, int size,
+                         void* (*jobMain)( void* ), vector<int>& found ) {
+
+   vector<peelJob> jobs( jobCount(size, CORE_ROUND_MIN) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].frozen = &frozen;
+      jobs[i].degree = degree;
+      jobs[i].level = level;
+      jobs[i].nodes = nodes;
+      jobs[i].begin = (long long) size * i / jobs.size();
+      jobs[i].end = (long long) size * (i + 1) / jobs.size();
+   }
+
+   runJobs(jobs, jobMain);
+
+   found.clear();
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+      found.insert( found.end(), jobs[i].found.begin(), jobs[i].found.end() );
+   }
+}
+
+void peelCoresParallel( const frozenGraph& frozen, coreIndex& cores ) {
+
+   int n = frozen.nodeSize();
+
+   vector<int>& degree = cores.coreness;
+
+   degree.resize(n);
+
+   for ( int i = 0; i < n; i++ ) {
+      degree[i] = frozen.degree(i);
+   }
+
+   vector<int> round;
+   vector<int> nextRound;
+   int peeled = 0;
+
+   for ( int level = 0; peeled < n; level++ ) {
+
+      runPeelJobs(frozen, &degree[0], level, NULL, n, scanMain, round);
+
+      while ( !round.empty() ) {
+
+         peeled += round.size();
+
+         runPeelJobs(frozen, &degree[0], level, &round[0], round.size(),
+                     roundMain, nextRound);
+
+         round.swap(nextRound);
+      }
+   }
+
+   countShells(cores);
+}
+
+// ----------------------
+// Choosing a peeling.
+// ----------------------
+
+void findCores( const frozenGraph& frozen, coreIndex& cores ) {
+
+   if ( jobCount(frozen.edgeSize(), CORE_EDGES_MIN) > 1 ) {
+      peelCoresParallel(frozen, cores);
+   } else {
+      peelCores(frozen, cores);
+   }
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+int coreIndex::coreSize( int k ) const {
+
+   int size = 0;
+
+   for ( int j = max(k, 0); j <= maxCore(); j++ ) {
+      size += shellSize[j];
+   }
+
+   return size;
+}
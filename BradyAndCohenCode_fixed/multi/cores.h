@@ -0,0 +1,70 @@
+// cores.h: Specification for the k-core decomposition of a frozenGraph.
+//
+// The k-core is what's left after repeatedly deleting every node of
+// degree less than k; a node's coreness is the largest k whose core holds
+// it.  Degrees count each copy of a multiedge, and a loop twice, as in the
+// multiGraph itself.
+//
+// Small graphs are peeled one node at a time from degree buckets
+// [Batagelj and Zaversnik, O(n + m)].  Large ones are peeled a level at a
+// time in parallel, after ParK [Dasari et al.]: for k = 0, 1, ..., the
+// nodes of remaining degree k are peeled together, each decrementing its
+// neighbors' degrees with atomic operations, and any neighbor brought down
+// to k joins the next round at the same level.  Both give the same
+// coreness.
+
+#ifndef _CORES_H
+#define _CORES_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+// Fewest edges worth peeling in parallel, and fewest nodes in a round
+// worth handing to a thread of its own.
+
+#define CORE_EDGES_MIN (1 << 18)
+#define CORE_ROUND_MIN (1 << 12)
+
+class coreIndex {
+
+   public:
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Coreness of each node [by dense index], and the number of nodes of
+      // each coreness [the k-shells].
+
+      vector<int> coreness;
+      vector<int> shellSize;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      // Largest k with a nonempty k-core, or -1 for an empty graph.
+
+      int maxCore( void ) const {
+         return shellSize.size() - 1;
+      }
+
+      // Number of nodes in the k-core.
+
+      int coreSize( int k ) const;
+};
+
+// Find the coreness of every node of 'frozen', choosing the sequential or
+// parallel peeling by size.
+
+void findCores( const frozenGraph& frozen, coreIndex& cores );
+
+// The two peelings, for when the choice matters.
+
+void peelCores( const frozenGraph& frozen, coreIndex& cores );
+void peelCoresParallel( const frozenGraph& frozen, coreIndex& cores );
+
+#endif
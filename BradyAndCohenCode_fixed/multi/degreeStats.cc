@@ -0,0 +1,227 @@
+// degreeStats.cc: Definitions for degree statistics of a multiGraph and
+// for fitting a power law to its degree distribution.
+
+#include "degreeStats.h"
+
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
+
+// ---------------------
+// Degree bookkeeping.
+// ---------------------
+
+void degreeHistogram( multiGraph* G, vector<int>& histogram ) {
+
+   histogram.clear();
+
+   for ( hash_map<int, hash_set<int> >::iterator iter = G->degreeHash.begin();
+         iter != G->degreeHash.end(); iter++ ) {
+
+      if ( iter->second.empty() ) {
+         continue;
+      }
+
+      if ( (int) histogram.size() <= iter->first ) {
+         histogram.resize( iter->first + 1, 0 );
+      }
+
+      histogram[iter->first] = iter->second.size();
+   }
+}
+
+// Walk the buckets down from the top, taking nodes until there are k or
+// the degrees drop to 'least'.
+
+static void walkBuckets( multiGraph* G, int k, int least,
+                         vector<int>& nodes ) {
+
+   vector<int> histogram;
+
+   degreeHistogram(G, histogram);
+
+   nodes.clear();
+
+   for ( int d = (int) histogram.size() - 1;
+         d >= least && (int) nodes.size() < k; d-- ) {
+
+      if ( histogram[d] == 0 ) {
+         continue;
+      }
+
+      hash_set<int>& bucket = G->degreeHash.find(d)->second;
+
+      for ( hash_set<int>::iterator iter = bucket.begin();
+            iter != bucket.end() && (int) nodes.size() < k; iter++ ) {
+         nodes.push_back(*iter);
+      }
+   }
+}
+
+void topDegreeNodes( multiGraph* G, int k, vector<int>& nodes ) {
+   walkBuckets(G, k, 0, nodes);
+}
+
+void degreeAboveNodes( multiGraph* G, double threshold, vector<int>& nodes ) {
+
+   if ( threshold >= INT_MAX - 1 ) {
+
+      nodes.clear();
+      return;
+   }
+
+   walkBuckets(G, INT_MAX, max( (int) floor(threshold) + 1, 0 ), nodes);
+}
+
+// -------------
+// Fitting.
+// -------------
+
+double hurwitzZeta( double s, double q ) {
+
+   // Sum the first terms directly, then the rest by Euler-Maclaurin from
+   // a = q + 10, where the correction terms are already tiny.
+
+   double sum = 0.0;
+   int k;
+
+   for ( k = 0; k < 10; k++ ) {
+      sum += pow(q + k, -s);
+   }
+
+   double a = q + k;
+   double term = pow(a, -s);
+
+   sum += a * term / (s - 1) + term / 2;
+   sum += s * term / a / 12;
+   sum -= s * (s + 1) * (s + 2) * term / (a * a * a) / 720;
+   sum += s * (s + 1) * (s + 2) * (s + 3) * (s + 4) * term
+          / (a * a * a * a * a) / 30240;
+
+   return sum;
+}
+
+// Log-likelihood of 'count' degrees >= xmin, whose logs sum to 'logSum',
+// under the power law with exponent alpha.
+
+static double logLikelihood( double alpha, int xmin, double count,
+                             double logSum ) {
+   return -count * log( hurwitzZeta(alpha, xmin) ) - alpha * logSum;
+}
+
+// Maximize the likelihood over alpha by golden-section search; it's
+// concave in alpha.
+
+static double bestAlpha( int xmin, double count, double logSum ) {
+
+   const double ratio = (sqrt(5.0) - 1) / 2;
+
+   double low = FIT_ALPHA_LOW;
+   double high = FIT_ALPHA_HIGH;
+
+   double left = high - ratio * (high - low);
+   double right = low + ratio * (high - low);
+
+   double leftValue = logLikelihood(left, xmin, count, logSum);
+   double rightValue = logLikelihood(right, xmin, count, logSum);
+
+   while ( high - low > 1e-6 ) {
+
+      if ( leftValue < rightValue ) {
+
+         low = left;
+         left = right;
+         leftValue = rightValue;
+         right = low + ratio * (high - low);
+         rightValue = logLikelihood(right, xmin, count, logSum);
+
+      } else {
+
+         high = right;
+         right = left;
+         rightValue = leftValue;
+         left = high - ratio * (high - low);
+         leftValue = logLikelihood(left, xmin, count, logSum);
+      }
+   }
+
+   return (low + high) / 2;
+}
+
+// Second derivative of log zeta(alpha, xmin) in alpha, by central
+// differences: the variance of log d under the fitted law, and so the
+// Fisher information per node.
+
+static double logZetaCurvature( double alpha, int xmin ) {
+
+   const double step = 1e-3;
+
+   return ( log( hurwitzZeta(alpha + step, xmin) )
+            - 2 * log( hurwitzZeta(alpha, xmin) )
+            + log( hurwitzZeta(alpha - step, xmin) ) ) / (step * step);
+}
+
+// Largest gap between the distribution of the degrees >= xmin in
+// 'histogram' and the power law with exponent alpha.
+
+static double ksDistance( const vector<int>& histogram, int xmin,
+                          double count, double alpha ) {
+
+   double zetaMin = hurwitzZeta(alpha, xmin);
+   double zetaAbove = zetaMin;
+   double below = 0.0;
+   double distance = 0.0;
+
+   for ( int d = xmin; d < (int) histogram.size(); d++ ) {
+
+      below += histogram[d];
+      zetaAbove -= pow((double) d, -alpha);
+
+      distance = max( distance, fabs(below / count
+                                     - (1.0 - zetaAbove / zetaMin)) );
+   }
+
+   return distance;
+}
+
+bool fitPowerLaw( const vector<int>& histogram, powerLawFit& fit ) {
+
+   int size = histogram.size();
+
+   // Number of nodes of degree >= d, and the sum of their log degrees.
+
+   vector<double> tailCount( size + 1, 0.0 );
+   vector<double> tailLogSum( size + 1, 0.0 );
+
+   for ( int d = size - 1; d >= 1; d-- ) {
+      tailCount[d] = tailCount[d + 1] + histogram[d];
+      tailLogSum[d] = tailLogSum[d + 1] + histogram[d] * log((double) d);
+   }
+
+   bool found = false;
+
+   for ( int xmin = 1; xmin < size && tailCount[xmin] >= FIT_TAIL_MIN;
+         xmin++ ) {
+
+      if ( histogram[xmin] == 0 ) {
+         continue;
+      }
+
+      double alpha = bestAlpha(xmin, tailCount[xmin], tailLogSum[xmin]);
+      double distance = ksDistance(histogram, xmin, tailCount[xmin], alpha);
+
+      if ( !found || distance < fit.distance ) {
+
+         fit.alpha = alpha;
+         fit.alphaError = 1.0 / sqrt( tailCount[xmin]
+                                      * logZetaCurvature(alpha, xmin) );
+         fit.xmin = xmin;
+         fit.tailSize = (int) tailCount[xmin];
+         fit.distance = distance;
+
+         found = true;
+      }
+   }
+
+   return found;
+}
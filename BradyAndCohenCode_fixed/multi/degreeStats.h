@@ -0,0 +1,80 @@
+// degreeStats.h: Specification for degree statistics of a multiGraph and
+// for fitting a power law to its degree distribution.
+//
+// Everything here works from the graph's degreeHash, which already files
+// the nodes by degree: the histogram is one pass over the buckets, and the
+// k highest-degree nodes [or those above a degree] are found by walking
+// the buckets down from the top, taking whole buckets until the last one
+// needed, so nothing is sorted and no per-node degrees are copied.
+//
+// The fit is the discrete maximum-likelihood fit of Clauset, Shalizi and
+// Newman: for each candidate minimum degree xmin, the exponent alpha
+// maximizing the likelihood of the degrees >= xmin under
+// P(d) = d^-alpha / zeta(alpha, xmin), and the Kolmogorov-Smirnov distance
+// between that tail and the fitted law.  The xmin with the smallest
+// distance wins.  Since the likelihood only depends on how many nodes have
+// each degree, all of it runs over the histogram, in time depending on the
+// number of distinct degrees rather than nodes.
+
+#ifndef _DEGREE_STATS_H
+#define _DEGREE_STATS_H
+
+#include <vector>
+
+#include "multiGraph.h"
+
+using namespace std;
+
+// Fewest nodes in a tail worth fitting, and the range searched for alpha.
+
+#define FIT_TAIL_MIN 50
+#define FIT_ALPHA_LOW 1.01
+#define FIT_ALPHA_HIGH 6.0
+
+class powerLawFit {
+
+   public:
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Fitted exponent, its standard error, the smallest degree fitted,
+      // the number of nodes of at least that degree, and the
+      // Kolmogorov-Smirnov distance between them and the fitted law.
+
+      double alpha;
+      double alphaError;
+      int xmin;
+      int tailSize;
+      double distance;
+};
+
+// Fill histogram[d] with the number of nodes of degree d in G, for d = 0
+// .. maximum degree.
+
+void degreeHistogram( multiGraph* G, vector<int>& histogram );
+
+// Set 'nodes' to the IDs of the k highest-degree nodes of G [all of them,
+// if there are no more than k], highest first.  Ties are broken in the
+// order of the degree buckets.
+
+void topDegreeNodes( multiGraph* G, int k, vector<int>& nodes );
+
+// Set 'nodes' to the IDs of the nodes of G with degree above 'threshold',
+// highest first.
+
+void degreeAboveNodes( multiGraph* G, double threshold, vector<int>& nodes );
+
+// Fit a power law to the tail of the degree distribution in 'histogram'.
+// Returns false, leaving 'fit' alone, if no tail has FIT_TAIL_MIN nodes
+// of degree 1 or more.
+
+bool fitPowerLaw( const vector<int>& histogram, powerLawFit& fit );
+
+// Hurwitz zeta function: the sum over k >= 0 of (k + q)^-s, for s > 1 and
+// q > 0.
+
+double hurwitzZeta( double s, double q );
+
+#endif
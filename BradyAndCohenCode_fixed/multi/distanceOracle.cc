@@ -0,0 +1,184 @@
+// distanceOracle.cc: Definitions for an approximate distance oracle built
+// from the landmarks and balls of a routingScheme.
+
+#include "distanceOracle.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+// -------------
+// Constructors.
+// -------------
+
+distanceOracle::distanceOracle( const frozenGraph& frozen,
+                                const routingScheme& scheme ) :
+   landmarkRows( frozen, scheme.landmarks ),
+   closestRow( scheme.nodeSize(), -1 ),
+   landmarkDistance( scheme.nodeSize(), DISTANCE_NONE ),
+   ballOffsets( scheme.ballOffsets ),
+   ballNodes( scheme.ballNodes ),
+   ballDistances( scheme.ballDistances.size() ) {
+
+   saturated = landmarkRows.saturated;
+
+   for ( int v = 0; v < nodeSize(); v++ ) {
+
+      if ( scheme.closestLandmark[v] < 0 ) {
+         continue;
+      }
+
+      closestRow[v] = scheme.landmarkRank[ scheme.closestLandmark[v] ];
+
+      if ( scheme.landmarkDistance[v] > DISTANCE_MAX ) {
+         saturated = true;
+      } else {
+         landmarkDistance[v] = scheme.landmarkDistance[v];
+      }
+   }
+
+   for ( unsigned int j = 0; j < ballDistances.size(); j++ ) {
+
+      if ( scheme.ballDistances[j] > DISTANCE_MAX ) {
+
+         ballDistances[j] = DISTANCE_NONE;
+         saturated = true;
+
+      } else {
+         ballDistances[j] = scheme.ballDistances[j];
+      }
+   }
+}
+
+// -----------------
+// Helper functions.
+// -----------------
+
+int distanceOracle::ballDistance( int node, int target ) const {
+
+   vector<int>::const_iterator first = ballNodes.begin() + ballOffsets[node];
+   vector<int>::const_iterator last = ballNodes.begin() + ballOffsets[node + 1];
+   vector<int>::const_iterator found = lower_bound(first, last, target);
+
+   if ( found == last || *found != target ) {
+      return -1;
+   }
+
+   int entry = ballDistances[ found - ballNodes.begin() ];
+
+   return ( entry != DISTANCE_NONE ) ? entry : -1;
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+int distanceOracle::estimate( int s, int t ) const {
+
+   if ( s == t ) {
+      return 0;
+   }
+
+   int exact = ballDistance(s, t);
+
+   if ( exact < 0 ) {
+      exact = ballDistance(t, s);
+   }
+
+   if ( exact >= 0 ) {
+      return exact;
+   }
+
+   // Through the closest landmark of either end.
+
+   int best = -1;
+
+   if ( closestRow[s] >= 0 && landmarkDistance[s] != DISTANCE_NONE ) {
+
+      int across = landmarkRows.distance(closestRow[s], t);
+
+      if ( across >= 0 ) {
+         best = landmarkDistance[s] + across;
+      }
+   }
+
+   if ( closestRow[t] >= 0 && landmarkDistance[t] != DISTANCE_NONE ) {
+
+      int across = landmarkRows.distance(closestRow[t], s);
+
+      if ( across >= 0 && (best < 0 || landmarkDistance[t] + across < best) ) {
+         best = landmarkDistance[t] + across;
+      }
+   }
+
+   return best;
+}
+
+// One thread's view of a batch of queries.  Threads take ORACLE_BATCH
+// queries at a time until there are none left.
+
+typedef struct {
+
+   const distanceOracle* oracle;
+   const vector<int>* sources;
+   const vector<int>* targets;
+   vector<int>* estimates;
+   int* nextQuery;
+
+} oracleJob;
+
+static void* oracleMain( void* arg ) {
+
+   oracleJob* job = (oracleJob*) arg;
+
+   int size = job->sources->size();
+
+   while ( true ) {
+
+      int first = __atomic_fetch_add(job->nextQuery, ORACLE_BATCH,
+                                     __ATOMIC_RELAXED);
+
+      if ( first >= size ) {
+         break;
+      }
+
+      int last = min(first + ORACLE_BATCH, size);
+
+      for ( int i = first; i < last; i++ ) {
+         (*job->estimates)[i] = job->oracle->estimate( (*job->sources)[i],
+                                                       (*job->targets)[i] );
+      }
+   }
+
+   return NULL;
+}
+
+void distanceOracle::estimates( const vector<int>& sources,
+                                const vector<int>& targets,
+                                vector<int>& estimates ) const {
+
+   int nextQuery = 0;
+
+   estimates.assign(sources.size(), -1);
+
+   vector<oracleJob> jobs( jobCount(sources.size(), ORACLE_QUERIES_MIN) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].oracle = this;
+      jobs[i].sources = &sources;
+      jobs[i].targets = &targets;
+      jobs[i].estimates = &estimates;
+      jobs[i].nextQuery = &nextQuery;
+   }
+
+   runJobs(jobs, oracleMain);
+}
+
+long long distanceOracle::bytes( void ) const {
+   return (long long) landmarkRows.entries.size()
+          + (long long) sizeof(int) * closestRow.size()
+          + landmarkDistance.size()
+          + (long long) sizeof(int) * ballOffsets.size()
+          + (long long) sizeof(int) * ballNodes.size()
+          + ballDistances.size();
+}
@@ -0,0 +1,113 @@
+// distanceOracle.h: Specification for an approximate distance oracle
+// built from the landmarks and balls of a routingScheme.
+//
+// This is the oracle of Chen, Sommer, Teng and Wang, which comes from the
+// same preprocessing as the routing tables.  For nodes s and t:
+//
+//    - if t is in the ball of s, or s in the ball of t, the ball gives the
+//      distance exactly;
+//    - otherwise the estimate is the shorter of d(s, l(s)) + d(l(s), t)
+//      and d(t, l(t)) + d(l(t), s), going through the closest landmark of
+//      one end or the other.
+//
+// Outside the balls, d(s, l(s)) <= d(s, t), so the estimate is at most
+// three times the true distance, and never less than it.
+//
+// The distances from each landmark to every node are kept as one 8-bit
+// row per landmark [a distanceMatrix over the landmarks], and the balls as
+// sorted node indices, each with an 8-bit distance.  A query is a binary
+// search in each ball and two lookups in the landmark rows.  Queries in
+// bulk are handed out to threads in batches.
+
+#ifndef _DISTANCE_ORACLE_H
+#define _DISTANCE_ORACLE_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+#include "routingScheme.h"
+#include "exactDistances.h"
+
+using namespace std;
+
+// Fewest queries worth a thread of their own, and the queries per batch
+// handed to a thread.
+
+#define ORACLE_QUERIES_MIN 65536
+#define ORACLE_BATCH 4096
+
+class distanceOracle {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Build the oracle for 'frozen' from the landmarks and balls of
+      // 'scheme', which must have been built over it.
+
+      distanceOracle( const frozenGraph& frozen, const routingScheme& scheme );
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Distances from the i-th landmark to every node, in row i.
+
+      distanceMatrix landmarkRows;
+
+      // Each node's closest landmark, as a row of landmarkRows [-1 if it
+      // can't reach one], and its distance to it.
+
+      vector<int> closestRow;
+      vector<unsigned char> landmarkDistance;
+
+      // The ball of node v is ballNodes[ballOffsets[v] .. ballOffsets[v + 1]
+      // - 1], in increasing order, and ballDistances gives the distance to
+      // each.
+
+      vector<int> ballOffsets;
+      vector<int> ballNodes;
+      vector<unsigned char> ballDistances;
+
+      // Whether some distance the oracle needed was more than DISTANCE_MAX
+      // [those read as no path].
+
+      bool saturated;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      int nodeSize( void ) const {
+         return closestRow.size();
+      }
+
+      // Estimated distance from s to t, or -1 if the oracle knows of no
+      // path.
+
+      int estimate( int s, int t ) const;
+
+      // Set estimates[i] to the estimate for (sources[i], targets[i]), in
+      // parallel.
+
+      void estimates( const vector<int>& sources, const vector<int>& targets,
+                      vector<int>& estimates ) const;
+
+      // Bytes the oracle takes.
+
+      long long bytes( void ) const;
+
+   private:
+
+      // -----------------
+      // Helper functions.
+      // -----------------
+
+      // Distance from 'node' to 'target' if it's in the ball, else -1.
+
+      int ballDistance( int node, int target ) const;
+};
+
+#endif
@@ -0,0 +1,336 @@
+// exactDistances.cc: Definitions for exact hop distances between many
+// pairs of nodes of a frozenGraph.
+
+#include "exactDistances.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+// ----------
+// Searching.
+// ----------
+
+// Writes the distance to each node reached at a level into the rows of
+// the sources that reach it, rows[b * n + node] for source b, or notes
+// that the level is deeper than DISTANCE_MAX.
+
+struct rowWriter {
+
+   unsigned char* rows;
+   long long n;
+   int level;
+   bool deep;
+
+   void operator()( int node, unsigned long long bits ) {
+
+      if ( level > DISTANCE_MAX ) {
+
+         deep = true;
+         return;
+      }
+
+      for ( ; bits != 0; bits &= bits - 1 ) {
+         rows[ __builtin_ctzll(bits) * n + node ] = level;
+      }
+   }
+};
+
+// Search from sources[0 .. count - 1] together, count <= SWEEP_SOURCES,
+// setting rows[b * n + v] to the distance from source b to node v.
+// Returns false if the search went deeper than DISTANCE_MAX, leaving the
+// deeper entries at DISTANCE_NONE.
+
+static bool sweep( sourceSweep& bits, const int* sources, int count,
+                   unsigned char* rows ) {
+
+   int n = bits.nodeSize();
+
+   fill( rows, rows + (long long) count * n, (unsigned char) DISTANCE_NONE );
+
+   bits.start(sources, count);
+
+   for ( int b = 0; b < count; b++ ) {
+      rows[ (long long) b * n + sources[b] ] = 0;
+   }
+
+   rowWriter writer;
+
+   writer.rows = rows;
+   writer.n = n;
+   writer.deep = false;
+
+   while ( true ) {
+
+      writer.level = bits.level;
+
+      if ( !bits.advance(0, n, writer) ) {
+         return true;
+      }
+
+      if ( writer.deep ) {
+         return false;
+      }
+
+      bits.nextLevel();
+   }
+}
+
+// Plain breadth-first search from 'source', for sweeps that go too deep.
+
+static void search( const frozenGraph& frozen, int source,
+                    vector<int>& distance ) {
+
+   vector<int> queue;
+
+   distance.assign(frozen.nodeSize(), -1);
+   distance[source] = 0;
+   queue.push_back(source);
+
+   for ( unsigned int head = 0; head < queue.size(); head++ ) {
+
+      int v = queue[head];
+
+      for ( int j = frozen.offsets[v]; j < frozen.offsets[v + 1]; j++ ) {
+
+         int w = frozen.adjacency[j];
+
+         if ( distance[w] < 0 ) {
+
+            distance[w] = distance[v] + 1;
+            queue.push_back(w);
+         }
+      }
+   }
+}
+
+// One thread's view of a set of sweeps.  Threads take the next sweep,
+// sources[k * SWEEP_SOURCES ..], until there are none left.  With a
+// matrix, the sweep writes its rows straight into it; otherwise into a
+// matrix of the thread's own, from which the distances to the targets of
+// source s, targets[offsets[s] .. offsets[s + 1] - 1], go to the same
+// places of 'distances'.
+
+typedef struct {
+
+   const frozenGraph* frozen;
+   const vector<int>* sources;
+   const vector<int>* offsets;
+   const vector<int>* targets;
+   vector<int>* distances;
+   distanceMatrix* matrix;
+   int* nextSweep;
+
+   bool saturated;
+
+} distanceJob;
+
+static void* distanceMain( void* arg ) {
+
+   distanceJob* job = (distanceJob*) arg;
+   const frozenGraph& frozen = *(job->frozen);
+   const vector<int>& sources = *(job->sources);
+
+   int n = frozen.nodeSize();
+   int sweeps = (sources.size() + SWEEP_SOURCES - 1) / SWEEP_SOURCES;
+
+   sourceSweep bits( frozen );
+   vector<unsigned char> ownRows;
+   vector<int> distance;
+
+   if ( job->matrix == NULL ) {
+      ownRows.resize( (long long) SWEEP_SOURCES * n );
+   }
+
+   job->saturated = false;
+
+   while ( true ) {
+
+      int k = __atomic_fetch_add(job->nextSweep, 1, __ATOMIC_RELAXED);
+
+      if ( k >= sweeps ) {
+         break;
+      }
+
+      int first = k * SWEEP_SOURCES;
+      int count = min(SWEEP_SOURCES, (int) sources.size() - first);
+
+      unsigned char* rows = ( job->matrix != NULL ) ?
+         &job->matrix->entries[ (long long) first * n ] : &ownRows[0];
+
+      bool complete = sweep(bits, &sources[first], count, rows);
+
+      if ( job->matrix != NULL ) {
+
+         job->saturated = job->saturated || !complete;
+         continue;
+      }
+
+      for ( int b = 0; b < count; b++ ) {
+
+         int s = sources[first + b];
+
+         if ( !complete ) {
+            search(frozen, s, distance);
+         }
+
+         for ( int j = (*job->offsets)[s]; j < (*job->offsets)[s + 1]; j++ ) {
+
+            int t = (*job->targets)[j];
+            int found;
+
+            if ( complete ) {
+
+               int entry = rows[ (long long) b * n + t ];
+
+               found = ( entry != DISTANCE_NONE ) ? entry : -1;
+
+            } else {
+               found = distance[t];
+            }
+
+            (*job->distances)[j] = found;
+         }
+      }
+   }
+
+   return NULL;
+}
+
+// -------------
+// Constructors.
+// -------------
+
+distanceMatrix::distanceMatrix( const frozenGraph& frozen ) {
+
+   vector<int> sources( frozen.nodeSize() );
+
+   for ( int v = 0; v < frozen.nodeSize(); v++ ) {
+      sources[v] = v;
+   }
+
+   build(frozen, sources);
+}
+
+distanceMatrix::distanceMatrix( const frozenGraph& frozen,
+                                const vector<int>& sources ) {
+   build(frozen, sources);
+}
+
+// -----------------
+// Helper functions.
+// -----------------
+
+// Each sweep fills the rows of its sources.
+
+void distanceMatrix::build( const frozenGraph& frozen,
+                            const vector<int>& sources ) {
+
+   size = frozen.nodeSize();
+   entries.resize( (long long) sources.size() * size );
+
+   int nextSweep = 0;
+   int sweeps = (sources.size() + SWEEP_SOURCES - 1) / SWEEP_SOURCES;
+
+   vector<distanceJob> jobs( jobCount(sweeps, 1) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].frozen = &frozen;
+      jobs[i].sources = &sources;
+      jobs[i].matrix = this;
+      jobs[i].nextSweep = &nextSweep;
+   }
+
+   runJobs(jobs, distanceMain);
+
+   saturated = false;
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+      saturated = saturated || jobs[i].saturated;
+   }
+}
+
+// -----------------
+// Pairs of nodes.
+// -----------------
+
+void pairDistances( const frozenGraph& frozen, const vector<int>& sources,
+                    const vector<int>& targets, vector<int>& distances ) {
+
+   int n = frozen.nodeSize();
+
+   distances.assign(sources.size(), -1);
+
+   // Group the targets by source, and list the distinct sources.
+
+   vector<int> offsets( n + 1, 0 );
+
+   for ( unsigned int i = 0; i < sources.size(); i++ ) {
+      offsets[ sources[i] + 1 ]++;
+   }
+
+   vector<int> distinct;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      if ( offsets[v + 1] > 0 ) {
+         distinct.push_back(v);
+      }
+
+      offsets[v + 1] += offsets[v];
+   }
+
+   vector<int> fill( offsets.begin(), offsets.end() - 1 );
+   vector<int> place( sources.size() );
+   vector<int> grouped( targets.size() );
+
+   for ( unsigned int i = 0; i < sources.size(); i++ ) {
+
+      place[i] = fill[ sources[i] ]++;
+      grouped[ place[i] ] = targets[i];
+   }
+
+   // With most nodes as sources, look everything up in the all-pairs
+   // matrix, if it fits and holds every distance.
+
+   if ( distinct.size() >= MATRIX_SOURCE_FRACTION * n
+        && (long long) n * n <= MATRIX_BYTES_MAX ) {
+
+      distanceMatrix matrix(frozen);
+
+      if ( !matrix.saturated ) {
+
+         for ( unsigned int i = 0; i < sources.size(); i++ ) {
+            distances[i] = matrix.distance(sources[i], targets[i]);
+         }
+
+         return;
+      }
+   }
+
+   // Otherwise sweep from the distinct sources only.
+
+   vector<int> found( sources.size() );
+
+   int nextSweep = 0;
+   int sweeps = (distinct.size() + SWEEP_SOURCES - 1) / SWEEP_SOURCES;
+
+   vector<distanceJob> jobs( jobCount(sweeps, 1) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].frozen = &frozen;
+      jobs[i].sources = &distinct;
+      jobs[i].offsets = &offsets;
+      jobs[i].targets = &grouped;
+      jobs[i].distances = &found;
+      jobs[i].matrix = NULL;
+      jobs[i].nextSweep = &nextSweep;
+   }
+
+   runJobs(jobs, distanceMain);
+
+   for ( unsigned int i = 0; i < sources.size(); i++ ) {
+      distances[i] = found[ place[i] ];
+   }
+}
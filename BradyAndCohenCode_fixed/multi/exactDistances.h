@@ -0,0 +1,103 @@
+// exactDistances.h: Specification for exact hop distances between many
+// pairs of nodes of a frozenGraph, as baselines for measuring stretch.
+//
+// The pairs are grouped by source, and the distinct sources searched
+// SWEEP_SOURCES at a time as a sourceSweep, one bit of a machine word per
+// source, as in hopDistances.  Each sweep writes the distances from its
+// sources to every node into an 8-bit matrix, one row per source, as it
+// reaches them a level at a time, and the pairs of those sources are
+// read off it.  Sweeps are handed out to threads one at a time, each
+// thread with a matrix of its own.
+//
+// When most nodes are sources, the distances between all pairs are worked
+// out instead, into an n x n matrix of 8-bit distances that the pairs are
+// looked up in: the same sweeps, writing straight into the matrix.  A
+// matrix can also be had for any list of sources, one row each.
+//
+// Eight bits hold distances up to DISTANCE_MAX.  A sweep that goes deeper
+// [only on graphs with very long paths] is redone with a plain
+// breadth-first search per source.
+
+#ifndef _EXACT_DISTANCES_H
+#define _EXACT_DISTANCES_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+#include "sourceSweep.h"
+
+using namespace std;
+
+// Largest distance an 8-bit entry holds, and the entry for a node that
+// can't be reached [or is further away].
+
+#define DISTANCE_MAX 254
+#define DISTANCE_NONE 255
+
+// Most bytes an all-pairs matrix may take, and the fraction of nodes that
+// must be sources before one is built.
+
+#define MATRIX_BYTES_MAX (1LL << 30)
+#define MATRIX_SOURCE_FRACTION 0.5
+
+class distanceMatrix {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Find the distances between all pairs of nodes of 'frozen'.
+
+      distanceMatrix( const frozenGraph& frozen );
+
+      // Find the distances from each of 'sources' to every node.
+
+      distanceMatrix( const frozenGraph& frozen, const vector<int>& sources );
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Row i holds the distances from the i-th source [node i, for all
+      // pairs]: the distance to t is entries[i * size + t], DISTANCE_NONE if
+      // t can't be reached or is more than DISTANCE_MAX away.
+
+      int size;
+      vector<unsigned char> entries;
+
+      // Whether some distance was more than DISTANCE_MAX.
+
+      bool saturated;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      // Distance from the source of row i to t, or -1 if there's no entry
+      // for it.
+
+      int distance( int i, int t ) const {
+
+         int entry = entries[ (long long) i * size + t ];
+
+         return ( entry != DISTANCE_NONE ) ? entry : -1;
+      }
+
+   private:
+
+      // -----------------
+      // Helper functions.
+      // -----------------
+
+      void build( const frozenGraph& frozen, const vector<int>& sources );
+};
+
+// Set distances[i] to the distance from sources[i] to targets[i] in
+// 'frozen', or -1 if there's no path.
+
+void pairDistances( const frozenGraph& frozen, const vector<int>& sources,
+                    const vector<int>& targets, vector<int>& distances );
+
+#endif
@@ -0,0 +1,113 @@
+// frozenGraph.cc: Definitions for the read-only, array-based copy of a
+// multiGraph.
+
+#include "frozenGraph.h"
+
+#include <algorithm>
+
+// -------------
+// Constructors.
+// -------------
+
+frozenGraph::frozenGraph( multiGraph* G ) {
+
+   ids.reserve( G->nodeSize() );
+
+   for ( hash_map<int, multiNode*>::iterator iter = G->nodes.begin();
+         iter != G->nodes.end(); iter++ ) {
+      ids.push_back(iter->first);
+   }
+
+   sort( ids.begin(), ids.end() );
+
+   // Node IDs are never reused, so they're bounded by the number of nodes
+   // ever created; a flat table beats searching for every endpoint.
+
+   vector<int> rank( ids.empty() ? 0 : ids.back() + 1, -1 );
+
+   for ( unsigned int i = 0; i < ids.size(); i++ ) {
+      rank[ids[i]] = i;
+   }
+
+   endpoints.reserve( 2 * G->edgeSize() );
+
+   for ( hash_map<int, multiEdge*>::iterator iter = G->edges.begin();
+         iter != G->edges.end(); iter++ ) {
+
+      endpoints.push_back( rank[iter->second->getNode1()] );
+      endpoints.push_back( rank[iter->second->getNode2()] );
+   }
+
+   buildAdjacency();
+}
+
+frozenGraph::frozenGraph( const frozenGraph& source,
+                          const vector<bool>& keep ) {
+
+   vector<int> rank( source.nodeSize(), -1 );
+
+   for ( int i = 0; i < source.nodeSize(); i++ ) {
+
+      if ( keep[i] ) {
+         rank[i] = ids.size();
+         ids.push_back(source.ids[i]);
+      }
+   }
+
+   for ( int e = 0; e < source.edgeSize(); e++ ) {
+
+      int node_1 = rank[ source.endpoints[2 * e] ];
+      int node_2 = rank[ source.endpoints[2 * e + 1] ];
+
+      if ( node_1 >= 0 && node_2 >= 0 ) {
+         endpoints.push_back(node_1);
+         endpoints.push_back(node_2);
+      }
+   }
+
+   buildAdjacency();
+}
+
+// -----------------
+// Helper functions.
+// -----------------
+
+// Fill in offsets and adjacency from endpoints.
+
+void frozenGraph::buildAdjacency( void ) {
+
+   offsets.assign( ids.size() + 1, 0 );
+
+   for ( unsigned int i = 0; i < endpoints.size(); i++ ) {
+      offsets[ endpoints[i] + 1 ]++;
+   }
+
+   for ( unsigned int i = 0; i < ids.size(); i++ ) {
+      offsets[i + 1] += offsets[i];
+   }
+
+   adjacency.resize( offsets[ids.size()] );
+
+   vector<int> next( offsets.begin(), offsets.end() - 1 );
+
+   for ( unsigned int i = 0; i < endpoints.size(); i += 2 ) {
+      adjacency[ next[endpoints[i]]++ ] = endpoints[i + 1];
+      adjacency[ next[endpoints[i + 1]]++ ] = endpoints[i];
+   }
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+int frozenGraph::indexOf( int nodeID ) const {
+
+   vector<int>::const_iterator iter = lower_bound( ids.begin(), ids.end(),
+                                                   nodeID );
+
+   if ( iter == ids.end() || *iter != nodeID ) {
+      return -1;
+   }
+
+   return iter - ids.begin();
+}
@@ -0,0 +1,83 @@
+// frozenGraph.h: Specification for a read-only, array-based copy of a
+// multiGraph, for analyses that make many passes over a graph that isn't
+// changing.
+//
+// Nodes are renumbered densely, 0 .. nodeSize() - 1, in order of ID.  The
+// edges are kept both as a list of endpoint pairs and as adjacency lists
+// in compressed sparse row form: the neighbors of node i are
+// adjacency[offsets[i]] .. adjacency[offsets[i + 1] - 1].  As in the
+// multiGraph itself, each copy of a multiedge appears separately, and a
+// loop appears twice in its node's list.
+
+#ifndef _FROZEN_GRAPH_H
+#define _FROZEN_GRAPH_H
+
+#include <vector>
+
+#include "multiGraph.h"
+
+using namespace std;
+
+class frozenGraph {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Copy the current state of G.
+
+      frozenGraph( multiGraph* G );
+
+      // Copy the subgraph of 'source' induced by the nodes i with keep[i]
+      // set.  Node IDs carry over; dense indices are renumbered.
+
+      frozenGraph( const frozenGraph& source, const vector<bool>& keep );
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Node ID for each dense index, in increasing order.
+
+      vector<int> ids;
+
+      // Endpoints of edge e are endpoints[2e] and endpoints[2e + 1].
+
+      vector<int> endpoints;
+
+      vector<int> offsets;
+      vector<int> adjacency;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      int nodeSize( void ) const {
+         return ids.size();
+      }
+
+      int edgeSize( void ) const {
+         return endpoints.size() / 2;
+      }
+
+      int degree( int index ) const {
+         return offsets[index + 1] - offsets[index];
+      }
+
+      // Dense index of the node with the given ID, or -1 if there's no
+      // such node.
+
+      int indexOf( int nodeID ) const;
+
+   private:
+
+      // -----------------
+      // Helper functions.
+      // -----------------
+
+      void buildAdjacency( void );
+};
+
+#endif
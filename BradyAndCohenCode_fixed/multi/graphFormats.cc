@@ -0,0 +1,588 @@
+// graphFormats.cc: Definitions for reading and writing edge lists, METIS
+// and Matrix Market files.
+
+#include "graphFormats.h"
+#include "outputBuffer.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+// What a chunk parser needs to know from the file's header.
+
+typedef struct {
+
+   graphFormat format;
+
+   // METIS: numbers to skip at the start of each line [vertex size and
+   // weights], and whether each neighbor is followed by an edge weight.
+
+   int vertexFields;
+   bool edgeWeights;
+
+   // Matrix Market: does each entry stand for its transpose too?
+
+   bool symmetric;
+
+} formatInfo;
+
+// One line-aligned piece of the file, and what came of parsing it.
+
+typedef struct {
+
+   const char* begin;
+   const char* end;
+   const formatInfo* info;
+
+   // METIS: 0-based node whose adjacency is on the chunk's first line.
+
+   int firstVertex;
+
+   vector<int> endpoints;
+   int maxNode;
+   bool ok;
+
+} parseChunk;
+
+static bool isBlank( char c ) {
+
+   return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Start of the line after the one 'p' is on.
+
+static const char* nextLine( const char* p, const char* end ) {
+
+   const char* newline = (const char*) memchr(p, '\n', end - p);
+
+   return ( newline == NULL ) ? end : newline + 1;
+}
+
+// Skip blanks, then read a non-negative integer.  Returns false if there
+// isn't one before 'end', or it doesn't fit in an int.
+
+static bool getInt( const char*& p, const char* end, int& value ) {
+
+   while ( p < end && isBlank(*p) ) {
+      p++;
+   }
+
+   if ( p == end || *p < '0' || *p > '9' ) {
+      return false;
+   }
+
+   long long result = 0;
+
+   while ( p < end && *p >= '0' && *p <= '9' ) {
+
+      result = result * 10 + (*p - '0');
+
+      if ( result > INT_MAX ) {
+         return false;
+      }
+
+      p++;
+   }
+
+   value = (int) result;
+
+   return true;
+}
+
+// Does the line at 'p' hold nothing but blanks?
+
+static bool isEmptyLine( const char* p, const char* end ) {
+
+   while ( p < end && isBlank(*p) ) {
+      p++;
+   }
+
+   return p == end || *p == '\n';
+}
+
+static bool isComment( const char* p, const formatInfo& info ) {
+
+   return *p == '%' || ( info.format == FORMAT_EDGE_LIST && *p == '#' );
+}
+
+// Number of METIS adjacency lines [i.e., non-comment lines] in a chunk.
+
+static int countVertexLines( const char* p, const char* end,
+                             const formatInfo& info ) {
+
+   int count = 0;
+
+   for ( ; p < end; p = nextLine(p, end) ) {
+
+      if ( !isComment(p, info) ) {
+         count++;
+      }
+   }
+
+   return count;
+}
+
+// Parse one chunk into its own endpoint list.
+
+static void* parseChunkMain( void* arg ) {
+
+   parseChunk* chunk = (parseChunk*) arg;
+   const formatInfo& info = *(chunk->info);
+
+   const char* end = chunk->end;
+
+   int vertex = chunk->firstVertex;
+
+   chunk->maxNode = -1;
+   chunk->ok = true;
+
+   for ( const char* p = chunk->begin; p < end; p = nextLine(p, end) ) {
+
+      if ( isComment(p, info) ) {
+         continue;
+      }
+
+      const char* lineEnd = (const char*) memchr(p, '\n', end - p);
+
+      if ( lineEnd == NULL ) {
+         lineEnd = end;
+      }
+
+      const char* q = p;
+      int node_1;
+      int node_2;
+
+      switch ( info.format ) {
+
+      case FORMAT_EDGE_LIST:
+
+         if ( isEmptyLine(p, lineEnd) ) {
+            break;
+         }
+
+         if ( !getInt(q, lineEnd, node_1) || !getInt(q, lineEnd, node_2) ) {
+            chunk->ok = false;
+            return NULL;
+         }
+
+         chunk->endpoints.push_back(node_1);
+         chunk->endpoints.push_back(node_2);
+
+         chunk->maxNode = max( chunk->maxNode, max(node_1, node_2) );
+         break;
+
+      case FORMAT_MATRIX_MARKET:
+
+         if ( isEmptyLine(p, lineEnd) ) {
+            break;
+         }
+
+         if ( !getInt(q, lineEnd, node_1) || !getInt(q, lineEnd, node_2)
+               || node_1 == 0 || node_2 == 0 ) {
+            chunk->ok = false;
+            return NULL;
+         }
+
+         if ( info.symmetric || node_1 >= node_2 ) {
+
+            chunk->endpoints.push_back(node_1 - 1);
+            chunk->endpoints.push_back(node_2 - 1);
+
+            chunk->maxNode = max( chunk->maxNode, max(node_1, node_2) - 1 );
+         }
+         break;
+
+      case FORMAT_METIS:
+      {
+         // Each edge is listed at both endpoints; keep the copy on the
+         // lower-numbered one.  A loop is listed twice on its own line.
+
+         bool loopPending = false;
+
+         for ( int i = 0; i < info.vertexFields; i++ ) {
+
+            if ( !getInt(q, lineEnd, node_2) ) {
+               chunk->ok = false;
+               return NULL;
+            }
+         }
+
+         while ( getInt(q, lineEnd, node_2) ) {
+
+            int weight;
+
+            if ( node_2 == 0
+                  || ( info.edgeWeights && !getInt(q, lineEnd, weight) ) ) {
+               chunk->ok = false;
+               return NULL;
+            }
+
+            node_2--;
+
+            if ( node_2 == vertex ) {
+               loopPending = !loopPending;
+            }
+
+            if ( vertex < node_2 || ( node_2 == vertex && !loopPending ) ) {
+
+               chunk->endpoints.push_back(vertex);
+               chunk->endpoints.push_back(node_2);
+
+               chunk->maxNode = max( chunk->maxNode, node_2 );
+            }
+         }
+
+         vertex++;
+         break;
+      }
+
+      } // end switch ( format )
+   }
+
+   return NULL;
+}
+
+// Read a whole file into memory.
+
+static bool readWholeFile( const char* filename, vector<char>& data ) {
+
+   FILE* file = fopen(filename, "rb");
+
+   if ( file == NULL ) {
+      return false;
+   }
+
+   fseeko(file, 0, SEEK_END);
+   off_t size = ftello(file);
+   fseeko(file, 0, SEEK_SET);
+
+   data.resize(size);
+
+   bool ok = ( size <= 0
+               || fread(&data[0], 1, size, file) == (size_t) size );
+
+   fclose(file);
+
+   return ok;
+}
+
+// Read the header, if the format has one, filling in 'info' and the node
+// count it declares, and advancing 'p' to the first line of the body.
+
+static bool readHeader( const char*& p, const char* end, formatInfo& info,
+                        int& numNodes ) {
+
+   numNodes = 0;
+
+   if ( info.format == FORMAT_EDGE_LIST ) {
+
+      // Look for a node count among the leading comments.
+
+      for ( const char* q = p; q < end && isComment(q, info);
+            q = nextLine(q, end) ) {
+
+         const char* lineEnd = nextLine(q, end);
+         string line(q, lineEnd - q);
+
+         size_t position = line.find("Nodes:");
+
+         if ( position != string::npos ) {
+            numNodes = atoi( line.c_str() + position + strlen("Nodes:") );
+         }
+      }
+
+      return true;
+   }
+
+   if ( p == end ) {
+      return false;
+   }
+
+   if ( info.format == FORMAT_MATRIX_MARKET ) {
+
+      string banner(p, nextLine(p, end) - p);
+
+      if ( banner.compare(0, 14, "%%MatrixMarket") != 0
+            || banner.find("coordinate") == string::npos ) {
+         return false;
+      }
+
+      info.symmetric = ( banner.find("symmetric") != string::npos
+                         || banner.find("hermitian") != string::npos );
+   }
+
+   while ( p < end && isComment(p, info) ) {
+      p = nextLine(p, end);
+   }
+
+   const char* lineEnd = nextLine(p, end);
+
+   if ( info.format == FORMAT_METIS ) {
+
+      // "n m [fmt [ncon]]".  The digits of fmt flag vertex sizes, vertex
+      // weights and edge weights, in that order.
+
+      int numEdges;
+      int fmt = 0;
+      int ncon = 1;
+
+      if ( !getInt(p, lineEnd, numNodes) || !getInt(p, lineEnd, numEdges) ) {
+         return false;
+      }
+
+      if ( getInt(p, lineEnd, fmt) ) {
+         getInt(p, lineEnd, ncon);
+      }
+
+      info.vertexFields = ( (fmt / 100) % 10 != 0 ? 1 : 0 )
+                        + ( (fmt / 10) % 10 != 0 ? ncon : 0 );
+      info.edgeWeights = ( fmt % 10 != 0 );
+
+   } else {
+
+      // "rows columns entries".
+
+      int rows;
+      int columns;
+
+      if ( !getInt(p, lineEnd, rows) || !getInt(p, lineEnd, columns) ) {
+         return false;
+      }
+
+      numNodes = max(rows, columns);
+   }
+
+   p = lineEnd;
+
+   return true;
+}
+
+bool readGraphFile( const char* filename, graphFormat format,
+                    int& numNodes, vector<int>& endpoints ) {
+
+   endpoints.clear();
+
+   vector<char> data;
+
+   if ( !readWholeFile(filename, data) ) {
+      return false;
+   }
+
+   const char* p = data.empty() ? NULL : &data[0];
+   const char* end = p + data.size();
+
+   formatInfo info;
+   info.format = format;
+   info.vertexFields = 0;
+   info.edgeWeights = false;
+   info.symmetric = false;
+
+   if ( !readHeader(p, end, info, numNodes) ) {
+      return false;
+   }
+
+   // Split the body into line-aligned chunks, one per thread.
+
+   long count = jobCount(end - p, PARSE_CHUNK_MIN);
+
+   vector<parseChunk> chunks(count);
+
+   const char* begin = p;
+
+   for ( long i = 0; i < count; i++ ) {
+
+      chunks[i].begin = begin;
+      chunks[i].end = end;
+
+      if ( i < count - 1 ) {
+
+         const char* target = p + (end - p) * (i + 1) / count;
+
+         chunks[i].end = ( target <= begin ) ? begin
+                                             : nextLine(target - 1, end);
+      }
+
+      chunks[i].info = &info;
+      chunks[i].firstVertex = 0;
+
+      begin = chunks[i].end;
+   }
+
+   // METIS lines are numbered, so each chunk needs to know where it
+   // starts.
+
+   if ( format == FORMAT_METIS ) {
+
+      for ( long i = 1; i < count; i++ ) {
+         chunks[i].firstVertex = chunks[i - 1].firstVertex
+            + countVertexLines(chunks[i - 1].begin, chunks[i - 1].end, info);
+      }
+   }
+
+   runJobs(chunks, parseChunkMain);
+
+   // Stitch the chunks' edges together, in file order.
+
+   size_t total = 0;
+   int maxNode = -1;
+
+   for ( long i = 0; i < count; i++ ) {
+
+      if ( !chunks[i].ok ) {
+         return false;
+      }
+
+      total += chunks[i].endpoints.size();
+      maxNode = max(maxNode, chunks[i].maxNode);
+   }
+
+   endpoints.reserve(total);
+
+   for ( long i = 0; i < count; i++ ) {
+      endpoints.insert( endpoints.end(), chunks[i].endpoints.begin(),
+                        chunks[i].endpoints.end() );
+   }
+
+   if ( format == FORMAT_EDGE_LIST ) {
+      numNodes = max(numNodes, maxNode + 1);
+   }
+
+   return true;
+}
+
+bool formatFromExtension( const char* filename, graphFormat& format ) {
+
+   const char* dot = strrchr(filename, '.');
+
+   if ( dot == NULL || strchr(dot, '/') != NULL ) {
+      return false;
+   }
+
+   if ( strcmp(dot, ".edges") == 0 ) {
+      format = FORMAT_EDGE_LIST;
+   } else if ( strcmp(dot, ".metis") == 0 ) {
+      format = FORMAT_METIS;
+   } else if ( strcmp(dot, ".mtx") == 0 ) {
+      format = FORMAT_MATRIX_MARKET;
+   } else {
+      return false;
+   }
+
+   return true;
+}
+
+bool writeGraphFile( const char* filename, graphFormat format,
+                     multiGraph* G ) {
+
+   outputBuffer out;
+
+   if ( !out.open(filename) ) {
+      return false;
+   }
+
+   // Number the nodes densely, in order of ID.
+
+   vector<int> ids;
+   ids.reserve( G->nodeSize() );
+
+   for ( hash_map<int, multiNode*>::iterator iter = G->nodes.begin();
+         iter != G->nodes.end(); iter++ ) {
+      ids.push_back(iter->first);
+   }
+
+   sort( ids.begin(), ids.end() );
+
+   int base = ( format == FORMAT_EDGE_LIST ) ? 0 : 1;
+
+   vector<int> rank( ids.empty() ? 0 : ids.back() + 1 );
+
+   for ( unsigned int i = 0; i < ids.size(); i++ ) {
+      rank[ids[i]] = i + base;
+   }
+
+   int numNodes = ids.size();
+   int numEdges = G->edgeSize();
+
+   hash_map<int, multiEdge*>::iterator iter;
+
+   switch ( format ) {
+
+   case FORMAT_EDGE_LIST:
+
+      out << "# Nodes: " << numNodes << " Edges: " << numEdges << "\n";
+
+      for ( iter = G->edges.begin(); iter != G->edges.end(); iter++ ) {
+         out << rank[iter->second->getNode1()] << ' '
+             << rank[iter->second->getNode2()] << '\n';
+      }
+      break;
+
+   case FORMAT_MATRIX_MARKET:
+
+      // Lower triangle only, as the symmetric format requires.
+
+      out << "%%MatrixMarket matrix coordinate pattern symmetric\n"
+          << numNodes << ' ' << numNodes << ' ' << numEdges << '\n';
+
+      for ( iter = G->edges.begin(); iter != G->edges.end(); iter++ ) {
+
+         int row = rank[iter->second->getNode1()];
+         int column = rank[iter->second->getNode2()];
+
+         out << max(row, column) << ' ' << min(row, column) << '\n';
+      }
+      break;
+
+   case FORMAT_METIS:
+   {
+      // Gather each node's adjacency list [0-based here] in one array.
+
+      vector<int> offsets(numNodes + 1, 0);
+
+      for ( iter = G->edges.begin(); iter != G->edges.end(); iter++ ) {
+         offsets[ rank[iter->second->getNode1()] ]++;
+         offsets[ rank[iter->second->getNode2()] ]++;
+      }
+
+      for ( int i = 0; i < numNodes; i++ ) {
+         offsets[i + 1] += offsets[i];
+      }
+
+      vector<int> adjacency( offsets[numNodes] );
+      vector<int> next( offsets.begin(), offsets.end() - 1 );
+
+      for ( iter = G->edges.begin(); iter != G->edges.end(); iter++ ) {
+
+         int node_1 = rank[iter->second->getNode1()] - 1;
+         int node_2 = rank[iter->second->getNode2()] - 1;
+
+         adjacency[ next[node_1]++ ] = node_2;
+         adjacency[ next[node_2]++ ] = node_1;
+      }
+
+      out << numNodes << ' ' << numEdges << '\n';
+
+      for ( int i = 0; i < numNodes; i++ ) {
+
+         for ( int j = offsets[i]; j < offsets[i + 1]; j++ ) {
+
+            if ( j > offsets[i] ) {
+               out << ' ';
+            }
+
+            out << adjacency[j] + 1;
+         }
+
+         out << '\n';
+      }
+      break;
+   }
+
+   } // end switch ( format )
+
+   out.close();
+
+   return true;
+}
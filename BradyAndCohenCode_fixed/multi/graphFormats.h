@@ -0,0 +1,73 @@
+// graphFormats.h: Specification for reading and writing graphs in the
+// plain-text formats other tools expect, as an alternative to XML.
+//
+//    FORMAT_EDGE_LIST:     One edge per line, "node_1 node_2", with
+//                          0-based node IDs.  Anything after the second
+//                          ID is ignored, as are lines starting with '#'
+//                          or '%'.  A SNAP-style "# Nodes: n Edges: m"
+//                          comment, if present, gives the node count;
+//                          otherwise it's one more than the largest ID.
+//
+//    FORMAT_METIS:         A "n m [fmt [ncon]]" header line, then line i
+//                          [counting from 1] lists the neighbors of node i,
+//                          1-based.  Vertex and edge weights, as flagged
+//                          by fmt, are skipped.  '%' lines are comments.
+//
+//    FORMAT_MATRIX_MARKET: A "%%MatrixMarket matrix coordinate" header, a
+//                          "rows columns entries" line, then one 1-based
+//                          "row column [value]" entry per line.  Symmetric
+//                          matrices give one edge per entry; for general
+//                          ones only the lower triangle and diagonal are
+//                          read, so a full symmetric adjacency matrix
+//                          gives each edge once.
+//
+// Written files use dense node IDs: the graph's nodes, in order of ID, are
+// numbered from 0 [edge lists] or 1 [METIS, Matrix Market].  A loop
+// appears twice in its node's METIS adjacency line, and each copy of a
+// multiedge is written separately, so nothing is lost on a round trip.
+// [Strict METIS tools expect a simple graph.]
+//
+// Readers load the whole file, split it into line-aligned chunks, and
+// parse the chunks on separate threads.
+
+#ifndef _GRAPH_FORMATS_H
+#define _GRAPH_FORMATS_H
+
+#include <vector>
+
+#include "multiGraph.h"
+
+using namespace std;
+
+enum graphFormat {
+
+   FORMAT_EDGE_LIST,
+   FORMAT_METIS,
+   FORMAT_MATRIX_MARKET
+};
+
+// Smallest chunk worth handing to a thread of its own.
+
+#define PARSE_CHUNK_MIN (1 << 20)
+
+// Read a graph file.  On success, 'numNodes' is the number of nodes
+// [numbered from 0] and 'endpoints' holds the edges as consecutive pairs of
+// node IDs, ready for multiGraph::addEdges().  Returns false if the file
+// couldn't be read or is malformed.
+
+bool readGraphFile( const char* filename, graphFormat format,
+                    int& numNodes, vector<int>& endpoints );
+
+// Tell a file's format from its extension: .edges for an edge list,
+// .metis for METIS and .mtx for Matrix Market.  Returns false for any
+// other file [e.g., a recorded XML file].
+
+bool formatFromExtension( const char* filename, graphFormat& format );
+
+// Write G to a file, overwriting any preexisting file with this name.
+// Returns false if the file couldn't be opened.
+
+bool writeGraphFile( const char* filename, graphFormat format,
+                     multiGraph* G );
+
+#endif
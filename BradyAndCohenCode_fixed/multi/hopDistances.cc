@@ -0,0 +1,285 @@
+// hopDistances.cc: Definitions for estimating the hop-distance
+// distribution of a frozenGraph from a sample of sources.
+
+#include "hopDistances.h"
+#include "sourceSweep.h"
+#include "parallel.h"
+#include "../rand/randomc.h"
+
+#include <algorithm>
+
+// Average distance and 'quantile' effective diameter of the pairs counted
+// in 'pairs'.
+
+static void summarize( const vector<long long>& pairs, double quantile,
+                       double& average, double& effective ) {
+
+   double total = 0.0;
+   double sum = 0.0;
+
+   for ( unsigned int d = 1; d < pairs.size(); d++ ) {
+      total += pairs[d];
+      sum += (double) d * pairs[d];
+   }
+
+   average = 0.0;
+   effective = 0.0;
+
+   if ( total == 0.0 ) {
+      return;
+   }
+
+   average = sum / total;
+
+   // Find the first distance d within which the quantile is reached, and
+   // interpolate between d - 1 and d.
+
+   double target = quantile * total;
+   double within = 0.0;
+
+   for ( unsigned int d = 1; d < pairs.size(); d++ ) {
+
+      if ( pairs[d] > 0 && within + pairs[d] >= target ) {
+
+         effective = (d - 1) + (target - within) / pairs[d];
+         return;
+      }
+
+      within += pairs[d];
+   }
+
+   effective = pairs.size() - 1;
+}
+
+// Add 'histogram' into 'total', growing it as needed.
+
+static void accumulate( vector<long long>& total,
+                        const vector<long long>& histogram ) {
+
+   if ( total.size() < histogram.size() ) {
+      total.resize( histogram.size(), 0 );
+   }
+
+   for ( unsigned int d = 0; d < histogram.size(); d++ ) {
+      total[d] += histogram[d];
+   }
+}
+
+// ----------
+// Searching.
+// ----------
+
+// Counts the nodes reached at a level under the sources that reach them.
+
+struct levelCounter {
+
+   long long found[SWEEP_SOURCES];
+
+   void operator()( int node, unsigned long long bits ) {
+
+      for ( ; bits != 0; bits &= bits - 1 ) {
+         found[ __builtin_ctzll(bits) ]++;
+      }
+   }
+};
+
+// One thread's share of a level of a sweep: the nodes [begin, end).
+
+typedef struct {
+
+   sourceSweep* sweep;
+
+   int begin;
+   int end;
+
+   levelCounter counter;
+   bool reached;
+
+} sweepJob;
+
+static void* sweepMain( void* arg ) {
+
+   sweepJob* job = (sweepJob*) arg;
+
+   for ( int b = 0; b < SWEEP_SOURCES; b++ ) {
+      job->counter.found[b] = 0;
+   }
+
+   job->reached = job->sweep->advance(job->begin, job->end, job->counter);
+
+   return NULL;
+}
+
+// Search from sources[0 .. count - 1] together, count <= SWEEP_SOURCES,
+// adding the number of nodes source b finds at distance d to
+// histograms[b][d].
+
+static void sweep( const frozenGraph& frozen, sourceSweep& bits,
+                   const int* sources, int count,
+                   vector<long long>* histograms ) {
+
+   int n = bits.nodeSize();
+
+   bits.start(sources, count);
+
+   vector<sweepJob> jobs( jobCount(frozen.adjacency.size(), SWEEP_EDGES_MIN) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].sweep = &bits;
+      jobs[i].begin = (long long) n * i / jobs.size();
+      jobs[i].end = (long long) n * (i + 1) / jobs.size();
+   }
+
+   while ( true ) {
+
+      runJobs(jobs, sweepMain);
+
+      int d = bits.level;
+      bool reached = false;
+
+      for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+         reached = reached || jobs[i].reached;
+
+         for ( int b = 0; b < count; b++ ) {
+
+            if ( jobs[i].counter.found[b] == 0 ) {
+               continue;
+            }
+
+            if ( (int) histograms[b].size() <= d ) {
+               histograms[b].resize( d + 1, 0 );
+            }
+
+            histograms[b][d] += jobs[i].counter.found[b];
+         }
+      }
+
+      if ( !reached ) {
+         break;
+      }
+
+      bits.nextLevel();
+   }
+}
+
+void sampleHopDistances( const frozenGraph& frozen, int sources,
+                         unsigned int seed, double quantile,
+                         hopDistanceSample& sample ) {
+
+   int n = frozen.nodeSize();
+   int k = min(max(sources, 0), n);
+
+   sample.sources = k;
+   sample.pairs.assign(1, 0);
+
+   sample.averageDistance = sample.averageLow = sample.averageHigh = 0.0;
+   sample.effectiveDiameter = sample.effectiveLow = sample.effectiveHigh = 0.0;
+
+   if ( k == 0 ) {
+      return;
+   }
+
+   // Draw the sources: the first k places of a partial shuffle.
+
+   TRandomMersenne generator(seed);
+
+   vector<int> nodes( n );
+
+   for ( int i = 0; i < n; i++ ) {
+      nodes[i] = i;
+   }
+
+   for ( int i = 0; i < k; i++ ) {
+      swap( nodes[i], nodes[ generator.IRandom(i, n - 1) ] );
+   }
+
+   nodes.resize(k);
+
+   // Search from them a sweep at a time.
+
+   sourceSweep bits( frozen );
+   vector< vector<long long> > histograms( k );
+
+   for ( int first = 0; first < k; first += SWEEP_SOURCES ) {
+      sweep( frozen, bits, &nodes[first], min(SWEEP_SOURCES, k - first),
+             &histograms[first] );
+   }
+
+   // Pool the sources into groups for the bootstrap, and the groups into
+   // the estimate.
+
+   int groups = min(k, BOOTSTRAP_GROUPS);
+
+   vector< vector<long long> > groupPairs( groups );
+
+   for ( int s = 0; s < k; s++ ) {
+      accumulate( groupPairs[s % groups], histograms[s] );
+   }
+
+   for ( int g = 0; g < groups; g++ ) {
+      accumulate( sample.pairs, groupPairs[g] );
+   }
+
+   sample.pairs[0] = 0;
+
+   summarize(sample.pairs, quantile, sample.averageDistance,
+             sample.effectiveDiameter);
+
+   // With every node searched, there's nothing left to estimate.
+
+   if ( k == n ) {
+
+      sample.averageLow = sample.averageHigh = sample.averageDistance;
+      sample.effectiveLow = sample.effectiveHigh = sample.effectiveDiameter;
+      return;
+   }
+
+   vector<double> averages( BOOTSTRAP_ROUNDS );
+   vector<double> effectives( BOOTSTRAP_ROUNDS );
+   vector<long long> resample;
+
+   for ( int round = 0; round < BOOTSTRAP_ROUNDS; round++ ) {
+
+      resample.assign( sample.pairs.size(), 0 );
+
+      for ( int g = 0; g < groups; g++ ) {
+         accumulate( resample, groupPairs[ generator.IRandom(0, groups - 1) ] );
+      }
+
+      resample[0] = 0;
+
+      summarize(resample, quantile, averages[round], effectives[round]);
+   }
+
+   sort( averages.begin(), averages.end() );
+   sort( effectives.begin(), effectives.end() );
+
+   int low = (int) ( (1.0 - BOOTSTRAP_CONFIDENCE) / 2 * (BOOTSTRAP_ROUNDS - 1) );
+   int high = BOOTSTRAP_ROUNDS - 1 - low;
+
+   sample.averageLow = averages[low];
+   sample.averageHigh = averages[high];
+   sample.effectiveLow = effectives[low];
+   sample.effectiveHigh = effectives[high];
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+double hopDistanceSample::fraction( int d ) const {
+
+   long long total = 0;
+
+   for ( unsigned int j = 1; j < pairs.size(); j++ ) {
+      total += pairs[j];
+   }
+
+   if ( total == 0 || d < 1 || d > maxDistance() ) {
+      return 0.0;
+   }
+
+   return (double) pairs[d] / total;
+}
@@ -0,0 +1,91 @@
+// hopDistances.h: Specification for estimating the hop-distance
+// distribution of a frozenGraph from a sample of sources.
+//
+// A full breadth-first search from each of a random sample of sources
+// [without replacement] gives the distances from those sources to every
+// node they reach; pooled, these estimate the distribution of distances
+// over all connected pairs, along with the average distance and the
+// effective diameter [the distance within which a given fraction, say
+// 90%, of connected pairs lie, interpolated between whole hops].  Pairs
+// that can't reach each other aren't counted, so the graph is best cut
+// down to one component first.
+//
+// Confidence bounds come from a bootstrap over the sources: the sources
+// are dealt into groups, the groups resampled with replacement, and the
+// estimates recomputed for each resample.
+//
+// The searches run 64 sources at a time as a sourceSweep, one bit of a
+// machine word per source, counting the nodes each source reaches at each
+// level.  The nodes are split across threads for each level.
+
+#ifndef _HOP_DISTANCES_H
+#define _HOP_DISTANCES_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+// Fewest adjacency entries worth a thread of their own in a level of a
+// sweep.
+
+#define SWEEP_EDGES_MIN 65536
+
+// Default number of sources, and bootstrap settings: the number of
+// resamples, the most groups the sources are dealt into, and the
+// confidence level of the bounds.
+
+#define DISTANCE_SOURCES 100
+#define BOOTSTRAP_ROUNDS 200
+#define BOOTSTRAP_GROUPS 1000
+#define BOOTSTRAP_CONFIDENCE 0.95
+
+class hopDistanceSample {
+
+   public:
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Number of sources searched, and number of (source, target) pairs
+      // found at each distance d >= 1.  [pairs[0] is always 0.]
+
+      int sources;
+      vector<long long> pairs;
+
+      // Estimates, each with the bounds of its confidence interval.
+
+      double averageDistance;
+      double averageLow;
+      double averageHigh;
+
+      double effectiveDiameter;
+      double effectiveLow;
+      double effectiveHigh;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      // Largest distance seen.
+
+      int maxDistance( void ) const {
+         return pairs.size() - 1;
+      }
+
+      // Fraction of the connected pairs found at distance d.
+
+      double fraction( int d ) const;
+};
+
+// Search from 'sources' random sources [every node, if there are no more
+// nodes than that], drawn with 'seed', and estimate the distribution, the
+// average distance and the 'quantile' effective diameter.
+
+void sampleHopDistances( const frozenGraph& frozen, int sources,
+                         unsigned int seed, double quantile,
+                         hopDistanceSample& sample );
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "multiGraph.h"
 #include <queue>
+#include <algorithm>
 
 #define WHITE 0
 #define GRAY 1
@@ -454,26 +455,7 @@ int multiGraph::addEdge( int node_1 , int node_2 ) {
 
 int multiGraph::addEdge( multiNode* node_1, multiNode* node_2 ) {
 
-   // Create a new edge object, and hook everything up accordingly.
-
-   multiEdge* newEdge = new multiEdge( nextEdgeIndex, currentTime,
-         node_1->getId(), node_2->getId() );
-
-   edges[nextEdgeIndex] = newEdge;
-
-   node_1->addEdge( newEdge->getId() );
-
-   if ( node_1->getId() != node_2->getId() ) {
-      node_2->addEdge( newEdge->getId() );
-   }
-
-   node_1->addNeighbor( node_2->getId() );
-
-   if ( node_1->getId() != node_2->getId() ) {
-      node_2->addNeighbor( node_1->getId() );
-   }
-
-   nextEdgeIndex++;
+   int newEdgeID = linkEdge( node_1, node_2 );
 
    // Upadate the degree hash list to reflect the increase in degree for
    // both of the nodes.
@@ -514,7 +496,7 @@ int multiGraph::addEdge( multiNode* node_1, multiNode* node_2 ) {
       degreeHash[oldDegree + 2].insert(node_1->getId());
    }
    
-   return newEdge->getId();
+   return newEdgeID;
 
 }
 
@@ -755,6 +737,7 @@ void multiGraph::deleteEdge( multiNode* node_1, multiNode* node_2 ) {
       // Find out if node_1 and node_2 are still friends.
 
       iter = node1Edges.begin();
+      found = false;
 
       while ( (iter != node1Edges.end()) && !(found) ) {
 
@@ -893,58 +876,7 @@ void multiGraph::deleteEdge( int edgeID ) {
       multiNode* node_1 = nodes[edges[edgeID]->getNode1()];
       multiNode* node_2 = nodes[edges[edgeID]->getNode2()];
 
-      // If this is a loop we're zapping, fix the node's degreeOffset.
-
-      if ( node_1->getId() == node_2->getId() ) {
-         node_1->decrementDegreeOffset();
-      }
-
-      // Remove the edge from the edges collection.
-
-      edges.erase(edgeID);
-
-      // Find out if node_1 and node_2 are still friends.
-
-      vector<int> node1Edges;
-      node_1->getEdges(node1Edges);
-
-      vector<int>::iterator iter = node1Edges.begin();
-
-      int secondEdgeID = -1;
-      bool found = false;
-
-      while ( (iter != node1Edges.end()) && !(found) ) {
-
-         // (We don't want to be querying a deleted edge.)
-
-         if ( *iter != edgeID ) {
-
-            if ( (edges[*iter]->getNode1() == node_2->getId())
-                  || (edges[*iter]->getNode2() == node_2->getId()) ) {
-
-               found = true;
-               secondEdgeID = *iter;
-            }
-         }
-
-         iter++;
-      }
-
-      // If they're no longer friends,
-
-      if ( secondEdgeID == -1 ) {
-
-         // Let the nodes know this disastrous rupture in their friendship
-         // has taken place.
-
-         node_1->removeNeighbor(node_2->getId());
-         node_2->removeNeighbor(node_1->getId());
-      }
-
-      // Kill the originally-zapped edge in the nodes' adjacency lists.
-
-      node_1->removeEdge(edgeID);
-      node_2->removeEdge(edgeID);
+      unlinkEdge( edgeID );
 
       // If this is not a loop,
       
@@ -988,6 +920,170 @@ void multiGraph::deleteEdge( int edgeID ) {
       } // end if ( this is a loop)
 }
 
+// -----------------
+// Bulk operations.
+// -----------------
+
+// Find [or create] the bucket for 'key' in one of the int-keyed tracking
+// hashes.  hash_map's operator[] builds a throwaway empty hash_set on every
+// call whether or not the key exists, which adds up on the bulk paths.
+
+static hash_set<int>& findBucket( hash_map<int, hash_set<int> >& buckets,
+                                 int key ) {
+
+   hash_map<int, hash_set<int> >::iterator bucket = buckets.find(key);
+
+   if ( bucket == buckets.end() ) {
+      bucket = buckets.insert( make_pair(key, hash_set<int>()) ).first;
+   }
+
+   return bucket->second;
+}
+
+// Add 'count' nodes, as by repeated calls to addNode().
+
+void multiGraph::addNodes( int count ) {
+
+   if ( count <= 0 ) {
+      return;
+   }
+
+   nodes.resize( nodes.size() + count );
+
+   int_hash_set& zeroDegree = findBucket( degreeHash, 0 );
+   int_hash_set& zeroColor = findBucket( colorHash, 0 );
+   int_hash_set& zeroWeight = weightHash[0];
+
+   for ( int i = 0; i < count && nodeSize() < INT_MAX; i++ ) {
+
+      multiNode* newNode = new multiNode( nextNodeIndex, currentTime );
+      nodes[nextNodeIndex] = newNode;
+      nextNodeIndex++;
+
+      zeroDegree.insert(newNode->getId());
+      zeroColor.insert(newNode->getId());
+      zeroWeight.insert(newNode->getId());
+   }
+}
+
+// Add an edge for each consecutive pair of IDs in 'endpoints', as by
+// repeated calls to addEdge( int, int ).  Pairs naming a missing node are
+// skipped.  Each touched node moves between degree buckets once, at the
+// end, rather than once per edge.
+
+void multiGraph::addEdges( const vector<int>& endpoints ) {
+
+   // (node ID, degree before one of its edges was added) for every
+   // endpoint.  Degrees only go up here, so the smallest entry for a node
+   // is the bucket it's filed under.
+
+   vector< pair<int, int> > touched;
+   touched.reserve( endpoints.size() );
+
+   edges.resize( edges.size() + endpoints.size() / 2 );
+
+   for ( unsigned int i = 0; i + 1 < endpoints.size(); i += 2 ) {
+
+      node_hash_t::iterator iter_1 = nodes.find( endpoints[i] );
+      node_hash_t::iterator iter_2 = nodes.find( endpoints[i + 1] );
+
+      if ( (iter_1 == nodes.end()) || (iter_2 == nodes.end()) ) {
+         continue;
+      }
+
+      multiNode* node_1 = iter_1->second;
+      multiNode* node_2 = iter_2->second;
+
+      touched.push_back( make_pair(node_1->getId(), node_1->getDegree()) );
+      touched.push_back( make_pair(node_2->getId(), node_2->getDegree()) );
+
+      linkEdge( node_1, node_2 );
+   }
+
+   sort( touched.begin(), touched.end() );
+
+   for ( unsigned int i = 0; i < touched.size(); i++ ) {
+
+      if ( i > 0 && touched[i].first == touched[i - 1].first ) {
+         continue;
+      }
+
+      unfileDegree( touched[i].first, touched[i].second );
+      fileDegree( touched[i].first, nodes[touched[i].first]->getDegree() );
+   }
+}
+
+// Delete each node in 'targets', as by repeated calls to deleteNode( int ).
+// IDs of missing [or already deleted] nodes are skipped.  Surviving
+// neighbors move between degree buckets once, at the end.
+
+void multiGraph::deleteNodes( const vector<int>& targets ) {
+
+   hash_map<int, int> oldDegrees;
+
+   vector<int> targetEdges;
+
+   for ( unsigned int i = 0; i < targets.size(); i++ ) {
+
+      node_hash_t::iterator nodeIter = nodes.find( targets[i] );
+
+      if ( nodeIter == nodes.end() ) {
+         continue;
+      }
+
+      multiNode* targetNode = nodeIter->second;
+      int targetID = targetNode->getId();
+
+      if ( oldDegrees.find(targetID) == oldDegrees.end() ) {
+         oldDegrees[targetID] = targetNode->getDegree();
+      }
+
+      // Unlink the incident edges, noting each neighbor's degree first.
+
+      targetEdges.clear();
+      targetNode->getEdges( targetEdges );
+
+      for ( unsigned int j = 0; j < targetEdges.size(); j++ ) {
+
+         multiEdge* edge = edges[targetEdges[j]];
+
+         int otherID = ( edge->getNode1() == targetID ) ? edge->getNode2()
+                                                        : edge->getNode1();
+
+         if ( oldDegrees.find(otherID) == oldDegrees.end() ) {
+            oldDegrees[otherID] = nodes[otherID]->getDegree();
+         }
+
+         unlinkEdge( targetEdges[j] );
+      }
+
+      // The node sits in whatever degree bucket it had before this call.
+
+      unfileDegree( targetID, oldDegrees[targetID] );
+      oldDegrees.erase(targetID);
+
+      int targetColor = targetNode->getColor();
+
+      colorHash[targetColor].erase(targetID);
+
+      if ( colorHash[targetColor].empty() ) {
+         colorHash.erase(targetColor);
+      }
+
+      double targetWeight = targetNode->getWeight();
+
+      weightHash[targetWeight].erase(targetID);
+
+      if ( weightHash[targetWeight].empty() ) {
+         weightHash.erase(targetWeight);
+      }
+
+      nodes.erase( targetID );
+   }
+
+   rebucketDegrees( oldDegrees );
+}
+
 // Delete a random edge and return its endpoint IDs.
 
 vector<int> multiGraph::deleteRandomEdge() {
@@ -2876,3 +2972,149 @@ int multiGraph::randomConnectedNode( char attribute, double value ) {
 
    return ret_val;
 }
+
+// ------------------------
+// Private member functions.
+// ------------------------
+
+// Create a new edge between two nodes and hook everything up, but leave
+// the degree hash alone.  Returns the new edge's ID.
+
+int multiGraph::linkEdge( multiNode* node_1, multiNode* node_2 ) {
+
+   multiEdge* newEdge = new multiEdge( nextEdgeIndex, currentTime,
+         node_1->getId(), node_2->getId() );
+
+   edges[nextEdgeIndex] = newEdge;
+
+   node_1->addEdge( newEdge->getId() );
+
+   if ( node_1->getId() != node_2->getId() ) {
+      node_2->addEdge( newEdge->getId() );
+   }
+
+   node_1->addNeighbor( node_2->getId() );
+
+   if ( node_1->getId() != node_2->getId() ) {
+      node_2->addNeighbor( node_1->getId() );
+   }
+
+   nextEdgeIndex++;
+
+   return newEdge->getId();
+}
+
+// Remove an edge from the edge collection and from its endpoints, but
+// leave the degree hash alone.
+
+void multiGraph::unlinkEdge( int edgeID ) {
+
+      multiNode* node_1 = nodes[edges[edgeID]->getNode1()];
+      multiNode* node_2 = nodes[edges[edgeID]->getNode2()];
+
+      // If this is a loop we're zapping, fix the node's degreeOffset.
+
+      if ( node_1->getId() == node_2->getId() ) {
+         node_1->decrementDegreeOffset();
+      }
+
+      // Remove the edge from the edges collection.
+
+      edges.erase(edgeID);
+
+      // Find out if node_1 and node_2 are still friends.
+
+      vector<int> node1Edges;
+      node_1->getEdges(node1Edges);
+
+      vector<int>::iterator iter = node1Edges.begin();
+
+      int secondEdgeID = -1;
+      bool found = false;
+
+      while ( (iter != node1Edges.end()) && !(found) ) {
+
+         // (We don't want to be querying a deleted edge.)
+
+         if ( *iter != edgeID ) {
+
+            // If the deleted edge was a loop, only another loop will do.
+
+            if ( node_1->getId() == node_2->getId() ) {
+
+               if ( edges[*iter]->getNode1() == edges[*iter]->getNode2() ) {
+
+                  found = true;
+                  secondEdgeID = *iter;
+               }
+
+            } else if ( (edges[*iter]->getNode1() == node_2->getId())
+                  || (edges[*iter]->getNode2() == node_2->getId()) ) {
+
+               found = true;
+               secondEdgeID = *iter;
+            }
+         }
+
+         iter++;
+      }
+
+      // If they're no longer friends,
+
+      if ( secondEdgeID == -1 ) {
+
+         // Let the nodes know this disastrous rupture in their friendship
+         // has taken place.
+
+         node_1->removeNeighbor(node_2->getId());
+         node_2->removeNeighbor(node_1->getId());
+      }
+
+      // Kill the originally-zapped edge in the nodes' adjacency lists.
+
+      node_1->removeEdge(edgeID);
+      node_2->removeEdge(edgeID);
+}
+
+// Move every node in 'oldDegrees' [node ID -> degree bucket it currently
+// sits in] into the bucket matching its actual degree.
+
+void multiGraph::rebucketDegrees( hash_map<int, int>& oldDegrees ) {
+
+   hash_map<int, int>::iterator iter;
+
+   for ( iter = oldDegrees.begin(); iter != oldDegrees.end(); iter++ ) {
+
+      int oldDegree = iter->second;
+      int newDegree = nodes[iter->first]->getDegree();
+
+      if ( oldDegree == newDegree ) {
+         continue;
+      }
+
+      unfileDegree( iter->first, oldDegree );
+      fileDegree( iter->first, newDegree );
+   }
+}
+
+// Add a node to, or remove it from, a degree bucket, without going through
+// degreeHash[] [see findBucket() above].
+
+void multiGraph::fileDegree( int nodeID, int degree ) {
+
+   findBucket( degreeHash, degree ).insert(nodeID);
+}
+
+void multiGraph::unfileDegree( int nodeID, int degree ) {
+
+   intKey_ID_map_t::iterator bucket = degreeHash.find(degree);
+
+   if ( bucket != degreeHash.end() ) {
+
+      bucket->second.erase(nodeID);
+
+      if ( bucket->second.empty() ) {
+         degreeHash.erase(bucket);
+      }
+   }
+}
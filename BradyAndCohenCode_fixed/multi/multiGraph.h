@@ -136,6 +136,13 @@ class multiGraph {
          currentTime++;
       }
 
+      // Set the time counter, e.g. to match a snapshot being loaded.
+
+      void setTime( int time ) {
+
+         currentTime = time;
+      }
+
       // Report the graph's average degree.  Calculate this on-the-fly.
 
       double avgDegree() {
@@ -304,6 +311,27 @@ class multiGraph {
       vector<int> deleteRandomEdge( char attribute_1, double value_1,
                                     char attribute_2, double value_2 );
 
+      // -----------------
+      // Bulk operations.
+      // -----------------
+
+      // These give the same result as the equivalent sequence of single
+      // operations, but update the degree hash once per touched node
+      // rather than once per operation.  Used to replay update logs.
+
+      // Add 'count' nodes.
+
+      void addNodes( int count );
+
+      // Add an edge for each consecutive pair of node IDs in 'endpoints'.
+      // Pairs naming a missing node are skipped.
+
+      void addEdges( const vector<int>& endpoints );
+
+      // Delete each of the given nodes [missing IDs are skipped].
+
+      void deleteNodes( const vector<int>& targets );
+
       // Return a random node's ID where 'attribute' matches 'value,' or -1
       // if there isn't one.
       //
@@ -330,6 +358,14 @@ class multiGraph {
       
       // Use only when scanning input files:
       
+      int getNodeIndex() const {
+         return nextNodeIndex;
+      }
+
+      int getEdgeIndex() const {
+         return nextEdgeIndex;
+      }
+
       void setNodeIndex(int newIndex) {
          nextNodeIndex = newIndex;
       }
@@ -357,6 +393,22 @@ class multiGraph {
       // Private Member Functions
       // ------------------------
       
+      // Create an edge between two nodes, or remove one, without touching
+      // the degree hash.  The single-edge operations wrap these with the
+      // degree bookkeeping; the bulk operations defer it to
+      // rebucketDegrees().
+
+      int linkEdge( multiNode* node_1, multiNode* node_2 );
+      void unlinkEdge( int edgeID );
+
+      // Move each node in 'oldDegrees' [ID -> degree bucket it is filed
+      // under] to the bucket matching its current degree.
+
+      void rebucketDegrees( hash_map<int, int>& oldDegrees );
+
+      void fileDegree( int nodeID, int degree );
+      void unfileDegree( int nodeID, int degree );
+
       // Data initializer called by the constructors.
 
       void init() {
@@ -2,15 +2,10 @@
 // [undirected] multigraph object.
 #include <cstring> // Add this line
 #include "multiGraphManager.h"
+#include <climits>
 #include <cstdlib>
 #include <string>
 
-#define WEIGHT_INIT 42.87597
-
-void initTag( xmlTag& tag );
-bool moreAttributeData( string& line );
-void getNextPair( string& line, xmlTag& tag );
-
 // -------------
 // Constructors.
 // -------------
@@ -30,15 +25,35 @@ multiGraphManager::multiGraphManager( char* outputfilename ) {
    recording = 0;
    structureInfo = 0;
 
-   output_file_stream.open(output_file_name);
+   output_buffer.open(output_file_name);
+   recorder.setOutput(&output_buffer);
+   openIndex();
 
-   assert(output_file_stream);
+   assert(output_buffer.isOpen());
 
-   output_file_stream << "<graph nodeSize=\"0\" "
+   indexElement("graph");
+   output_buffer << "<graph nodeSize=\"0\" "
       << "directed=\"0\" multi=\"1\">\n";
 
 }
 
+// Create an empty graph with no output file, for programs that only read
+// graphs.  Snapshots and recorded updates go nowhere.
+
+multiGraphManager::multiGraphManager( void ) {
+
+   G = new multiGraph();
+
+   nodes = &(G->nodes);
+   edges = &(G->edges);
+
+   output_file_name = NULL;
+   recording = 0;
+   structureInfo = 0;
+
+   recorder.setOutput(&output_buffer);
+}
+
 // Copy constructor.
 
 multiGraphManager::multiGraphManager( multiGraphManager& source ) {
@@ -48,19 +63,31 @@ multiGraphManager::multiGraphManager( multiGraphManager& source ) {
    nodes = &(G->nodes);
    edges = &(G->edges);
    
+   recording = source.recording;
+   structureInfo = source.structureInfo;
+   
+   recorder.setOutput(&output_buffer);
+   
+   // A copy of a read-only manager is read-only too.
+   
+   if ( source.output_file_name == NULL ) {
+      
+      output_file_name = NULL;
+      return;
+   }
+   
    char tempString[200];
    strcpy(tempString, source.output_file_name);
    
    output_file_name = strcat(tempString, ".copy");
    
-   recording = source.recording;
-   structureInfo = source.structureInfo;
-   
-   output_file_stream.open(output_file_name);
+   output_buffer.open(output_file_name);
+   openIndex();
 
-   assert(output_file_stream);
+   assert(output_buffer.isOpen());
 
-   output_file_stream << "<graph nodeSize=\"" << G->nodeSize() << "\" "
+   indexElement("graph");
+   output_buffer << "<graph nodeSize=\"" << G->nodeSize() << "\" "
       << "directed=\"0\" multi=\"1\">\n";
 }
 
@@ -77,11 +104,14 @@ multiGraphManager::multiGraphManager( int numNodes, char* outputfilename ) {
    output_file_name = outputfilename;
    recording = 0;
    structureInfo = 0;
-   output_file_stream.open(output_file_name);
+   output_buffer.open(output_file_name);
+   recorder.setOutput(&output_buffer);
+   openIndex();
 
-   assert(output_file_stream);
+   assert(output_buffer.isOpen());
 
-   output_file_stream << "<graph nodeSize=\"" << numNodes
+   indexElement("graph");
+   output_buffer << "<graph nodeSize=\"" << numNodes
 	   << "\" directed=\"0\" multi=\"1\">\n";
 }
 
@@ -108,11 +138,14 @@ multiGraphManager::multiGraphManager( char graphType, int numNodes, char* output
    output_file_name = outputfilename;
    recording = 0;
    structureInfo = 0;
-   output_file_stream.open(output_file_name);
+   output_buffer.open(output_file_name);
+   recorder.setOutput(&output_buffer);
+   openIndex();
 
-   assert(output_file_stream);
+   assert(output_buffer.isOpen());
 
-   output_file_stream << "<graph nodeSize=\"" << numNodes
+   indexElement("graph");
+   output_buffer << "<graph nodeSize=\"" << numNodes
       << "\" directed=\"0\" multi=\"1\" graphType=\"" << graphType << "\">\n";
 }
 
@@ -120,12 +153,29 @@ multiGraphManager::multiGraphManager( char graphType, int numNodes, char* output
 // Wrapped graph manipulation functions.
 // -------------------------------------
 
+// Increment the contained graph's time counter by one step.
+
+void multiGraphManager::incTime( void ) {
+
+   if ( recording ) {
+
+      updateRecord update;
+      initUpdate(update, UPDATE_INC_TIME);
+      recordUpdate(update);
+   }
+
+   G->incTime();
+}
+
 // Add a node to the contained graph & return its ID.
 
 int multiGraphManager::addNode( void ) {
 
    if ( recording ) {
-      output_file_stream << "   <addNode/>\n";
+
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_NODE);
+      recordUpdate(update);
    }
 
    return G->addNode();
@@ -136,8 +186,11 @@ int multiGraphManager::addNode( void ) {
 void multiGraphManager::deleteNode( int targetNode ) {
 
    if ( recording ) {
-      output_file_stream << "   <deleteNode ID=\"" << targetNode
-       << "\"/>\n";
+
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_NODE);
+      update.node_1 = targetNode;
+      recordUpdate(update);
    }
 
    G->deleteNode(targetNode);
@@ -149,11 +202,12 @@ void multiGraphManager::deleteRandomNode( void ) {
 
    int deletedID = G->deleteRandomNode();
 
-   if ( structureInfo && recording ) {
-      output_file_stream << "   <deleteRandomNode _ID=\""
-	    << deletedID << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <deleteRandomNode/>\n";
+   if ( recording ) {
+
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_RANDOM_NODE);
+      update._node_1 = deletedID;
+      recordUpdate(update);
    }
 }
 
@@ -179,13 +233,14 @@ int multiGraphManager::deleteRandomNode( char attribute, double value ) {
 
    int deletedID = G->deleteRandomNode(attribute, value);
 
-   if ( structureInfo && recording ) {
-      output_file_stream << "   <deleteRandomNode attribute=\""
-	    << attribute << "\" value=\"" << value << "\" _ID=\""
-	    << deletedID << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <deleteRandomNode attribute=\""
-	    << attribute << "\" value=\"" << value << "\"/>\n";
+   if ( recording ) {
+
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_RANDOM_NODE_BY_ATTRIBUTE);
+      update.attribute_1 = attribute;
+      update.value_1 = value;
+      update._node_1 = deletedID;
+      recordUpdate(update);
    }
 
    return deletedID;
@@ -197,8 +252,12 @@ int multiGraphManager::deleteRandomNode( char attribute, double value ) {
 int multiGraphManager::addEdge( int node_1, int node_2 ) {
 
    if ( recording ) {
-      output_file_stream << "   <addEdge node_1=\"" << node_1 << "\" "
-	    << "node_2=\"" << node_2 << "\"/>\n";
+
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_EDGE);
+      update.node_1 = node_1;
+      update.node_2 = node_2;
+      recordUpdate(update);
    }
 
    return G->addEdge(node_1, node_2);
@@ -209,21 +268,13 @@ int multiGraphManager::addEdge( int node_1, int node_2 ) {
 int multiGraphManager::addRandomEdge( void ) {
 
    int edgeID = G->addRandomEdge();
-   int node_1 = -1;
-   int node_2 = -1;
 
-   if ( edgeID != -1 ) {
-      node_1 = G->edges[edgeID]->getNode1();
-      node_2 = G->edges[edgeID]->getNode2();
-   }
+   if ( recording ) {
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <addRandomEdge _node_1=\""
-	    << node_1 << "\" "
-       << "_node_2=\"" << node_2
-	    << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <addRandomEdge/>\n";
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_RANDOM_EDGE);
+      recordEndpoints(update, edgeID);
+      recordUpdate(update);
    }
 
    return edgeID;
@@ -235,19 +286,14 @@ int multiGraphManager::addRandomEdge( int node_1 ) {
 
    int edgeID = G->addRandomEdge(node_1);
 
-   int node_2 = -1;
-
-   if ( edgeID != -1 ) {
-      node_2 = G->edges[edgeID]->getNode2();
-   }
+   if ( recording ) {
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <addRandomEdge node_1=\""
-	    << node_1 << "\" "
-       << "_node_2=\"" << node_2
-	    << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <addRandomEdge node_1=\"" << node_1 << "\"/>\n";
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_RANDOM_EDGE_FROM_NODE);
+      update.node_1 = node_1;
+      recordEndpoints(update, edgeID);
+      update._node_1 = -1;
+      recordUpdate(update);
    }
 
    return edgeID;
@@ -262,22 +308,15 @@ int multiGraphManager::addRandomEdge( int node_1 ) {
 int multiGraphManager::addRandomEdge( char attribute, double value ) {
 
    int edgeID = G->addRandomEdge(attribute, value);
-   int node_1 = -1;
-   int node_2 = -1;
 
-   if ( edgeID != -1 ) {
-      node_1 = G->edges[edgeID]->getNode1();
-      node_2 = G->edges[edgeID]->getNode2();
-   }
+   if ( recording ) {
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <addRandomEdge attribute=\""
-       << attribute << "\" value=\"" << value << "\" _node_1=\""
-       << node_1 << "\" _node_2=\""
-       << node_2 << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <addRandomEdge attribute=\"" << attribute
-          << "\" value=\"" << value << "\"/>\n";
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_RANDOM_EDGE_BY_ATTRIBUTE);
+      update.attribute_1 = attribute;
+      update.value_1 = value;
+      recordEndpoints(update, edgeID);
+      recordUpdate(update);
    }
 
    return edgeID;
@@ -293,28 +332,17 @@ int multiGraphManager::addRandomEdge( char attribute, double value ) {
 int multiGraphManager::addRandomEdge( int node_1, char attribute, double value ) {
 
    int edgeID = G->addRandomEdge( node_1, attribute, value );
-   int node_2 = -1;
-
-   if ( edgeID != -1 ) {
-      node_2 = G->edges[edgeID]->getNode2();
-   }
-
-   if ( recording && structureInfo ) {
 
-      output_file_stream << "   <addRandomEdge "
-	 << "node_1=\"" << node_1
-	 << "\" attribute=\"" << attribute
-	 << "\" value=\"" << value
-	 << "\" _node_2=\"" << node_2
-	 << "\"/>\n";
-
-   } else if ( recording ) {
+   if ( recording ) {
 
-      output_file_stream << "   <addRandomEdge "
-	 << "node_1=\"" << node_1
-	 << "\" attribute=\"" << attribute
-	 << "\" value=\"" << value
-	 << "\"/>\n";
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_RANDOM_EDGE_FROM_NODE_BY_ATTRIBUTE);
+      update.node_1 = node_1;
+      update.attribute_1 = attribute;
+      update.value_1 = value;
+      recordEndpoints(update, edgeID);
+      update._node_1 = -1;
+      recordUpdate(update);
    }
 
    return edgeID;
@@ -331,28 +359,17 @@ int multiGraphManager::addRandomEdge( char attribute_1, double value_1,
    int edgeID = -1;
 
    edgeID = G->addRandomEdge(attribute_1,value_1, attribute_2,value_2);
-   int node_1 = -1;
-   int node_2 = -1;
 
-   if ( edgeID != -1 ) {
-      node_1 = G->edges[edgeID]->getNode1();
-      node_2 = G->edges[edgeID]->getNode2();
-   }
+   if ( recording ) {
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <addRandomEdge attribute_1=\""
-       << attribute_1 << "\" value_1=\""
-       << value_1 << "\" attribute_2=\""
-       << attribute_2 << "\" value_2=\""
-       << value_2 << "\" _node_1=\""
-       << node_1 << "\" _node_2=\""
-       << node_2 << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <addRandomEdge attribute_1=\""
-       << attribute_1 << "\" value_1=\""
-       << value_1 << "\" attribute_2=\""
-       << attribute_2 << "\" value_2=\""
-       << value_2 << "\"/>\n";
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_RANDOM_EDGE_BETWEEN_ATTRIBUTES);
+      update.attribute_1 = attribute_1;
+      update.value_1 = value_1;
+      update.attribute_2 = attribute_2;
+      update.value_2 = value_2;
+      recordEndpoints(update, edgeID);
+      recordUpdate(update);
    }
 
    return edgeID;
@@ -369,28 +386,17 @@ int multiGraphManager::addRandomNewEdge( char attribute_1, double value_1,
    int edgeID = -1;
 
    edgeID = G->addRandomNewEdge(attribute_1, value_1, attribute_2, value_2);
-   int node_1 = -1;
-   int node_2 = -1;
 
-   if ( edgeID != -1 ) {
-      node_1 = G->edges[edgeID]->getNode1();
-      node_2 = G->edges[edgeID]->getNode2();
-   }
+   if ( recording ) {
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <addRandomNewEdge attribute_1=\""
-       << attribute_1 << "\" value_1=\""
-       << value_1 << "\" attribute_2=\""
-       << attribute_2 << "\" value_2=\""
-       << value_2 << "\" _node_1=\""
-       << node_1 << "\" _node_2=\""
-       << node_2 << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <addRandomNewEdge attribute_1=\""
-       << attribute_1 << "\" value_1=\""
-       << value_1 << "\" attribute_2=\""
-       << attribute_2 << "\" value_2=\""
-       << value_2 << "\"/>\n";
+      updateRecord update;
+      initUpdate(update, UPDATE_ADD_RANDOM_NEW_EDGE);
+      update.attribute_1 = attribute_1;
+      update.value_1 = value_1;
+      update.attribute_2 = attribute_2;
+      update.value_2 = value_2;
+      recordEndpoints(update, edgeID);
+      recordUpdate(update);
    }
 
    return edgeID;
@@ -401,8 +407,12 @@ int multiGraphManager::addRandomNewEdge( char attribute_1, double value_1,
 void multiGraphManager::deleteEdge( int node_1, int node_2 ) {
 
    if ( recording ) {
-      output_file_stream << "   <deleteEdge node_1=\"" << node_1
-          << "\" node_2=\"" << node_2 << "\"/>\n";
+
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_EDGE);
+      update.node_1 = node_1;
+      update.node_2 = node_2;
+      recordUpdate(update);
    }
 
    G->deleteEdge(node_1, node_2);
@@ -413,7 +423,12 @@ void multiGraphManager::deleteEdge( int node_1, int node_2 ) {
 void multiGraphManager::deleteEdge( int edgeID ) {
 
    if ( recording ) {
-      output_file_stream << "   <deleteEdge ID=\"" << edgeID << "\"/>\n";
+
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_EDGE_BY_ID);
+      update.node_1 = edgeID;
+      recordEndpoints(update, edgeID);
+      recordUpdate(update);
    }
 
    G->deleteEdge(edgeID);
@@ -424,22 +439,18 @@ void multiGraphManager::deleteEdge( int edgeID ) {
 void multiGraphManager::deleteRandomEdge( void ) {
 
    vector<int> endpoints = G->deleteRandomEdge();
-   int node_1_ID;
-   int node_2_ID;
-
-   if ( endpoints.size() != 2 ) {
-      node_1_ID = -1;
-      node_2_ID = -1;
-   } else {
-      node_1_ID = endpoints[0];
-      node_2_ID = endpoints[1];
-   }
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <deleteRandomEdge _node_1=\"" <<
-	 node_1_ID << "\" _node_2=\"" << node_2_ID << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <deleteRandomEdge/>\n";
+   if ( recording ) {
+
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_RANDOM_EDGE);
+
+      if ( endpoints.size() == 2 ) {
+         update._node_1 = endpoints[0];
+         update._node_2 = endpoints[1];
+      }
+
+      recordUpdate(update);
    }
 }
 
@@ -448,24 +459,19 @@ void multiGraphManager::deleteRandomEdge( void ) {
 void multiGraphManager::deleteRandomEdge( int targetNode ) {
 
    vector<int> endpoints = G->deleteRandomEdge(targetNode);
-   int node_1_ID;
-   int node_2_ID;
-
-   if ( endpoints.size() != 2 ) {
-      node_1_ID = -1;
-      node_2_ID = -1;
-   } else {
-      node_1_ID = endpoints[0];
-      node_2_ID = endpoints[1];
-   }
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <deleteRandomEdge node=\""
-	 << targetNode << "\" _node_1=\"" <<
-	 node_1_ID << "\" _node_2=\"" << node_2_ID << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <deleteRandomEdge node=\""
-	 << targetNode << "\"/>\n";
+   if ( recording ) {
+
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_RANDOM_EDGE_FROM_NODE);
+      update.node_1 = targetNode;
+
+      if ( endpoints.size() == 2 ) {
+         update._node_1 = endpoints[0];
+         update._node_2 = endpoints[1];
+      }
+
+      recordUpdate(update);
    }
 }
 
@@ -475,26 +481,20 @@ void multiGraphManager::deleteRandomEdge( int targetNode ) {
 void multiGraphManager::deleteRandomEdge( char attribute, double value ) {
 
    vector<int> endpoints = G->deleteRandomEdge(attribute, value);
-   int node_1_ID, node_2_ID;
 
-   if ( endpoints.size() == 2 ) {
-      node_1_ID = endpoints[0];
-      node_2_ID = endpoints[1];
-   } else {
-      node_1_ID = -1;
-      node_2_ID = -1;
-   }
+   if ( recording ) {
 
-   if ( recording && structureInfo ) {
-      output_file_stream << "   <deleteRandomEdge attribute=\""
-	 << attribute << "\" value=\"" << value
-	 << "\" _node_1=\"" << node_1_ID
-	 << "\" _node_2=\"" << node_2_ID
-	 << "\"/>\n";
-   } else if ( recording ) {
-      output_file_stream << "   <deleteRandomEdge attribute=\""
-	 << attribute << "\" value=\""
-	 << value << "\"/>\n";
+      updateRecord update;
+      initUpdate(update, UPDATE_DELETE_RANDOM_EDGE_BY_ATTRIBUTE);
+      update.attribute_1 = attribute;
+      update.value_1 = value;
+
+      if ( endpoints.size() == 2 ) {
+         update._node_1 = endpoints[0];
+         update._node_2 = endpoints[1];
+      }
+
+      recordUpdate(update);
    }
 }
 
@@ -519,14 +519,14 @@ void multiGraphManager::deleteRandomEdge( char attribute_1, double value_1,
    node_2_ID = endpoints[1];
 
    if ( recording && structureInfo ) {
-      output_file_stream << "   <deleteRandomEdge attribute_1=\""
+      output_buffer << "   <deleteRandomEdge attribute_1=\""
 	 << attribute_1 << "\" value_1=\"" << value_1 << "\" attribute_2=\""
 	 << attribute_2 << "\" value_2=\"" << value_2
 	 << "\" _node_1=\"" << node_1_ID
 	 << "\" _node_2=\"" << node_2_ID
 	 << "\"/>\n";
    } else if ( recording ) {
-      output_file_stream << "   <deleteRandomEdge attribute_1=\""
+      output_buffer << "   <deleteRandomEdge attribute_1=\""
 	 << attribute_1 << "\" value_1=\""
 	 << value_1 << "\" attribute_2=\""
 	 << attribute_2 << "\" value_2=\""
@@ -545,7 +545,14 @@ void multiGraphManager::deleteRandomEdge( char attribute_1, double value_1,
 void multiGraphManager::pause( void ) {
 
    if ( recording ) {
-      output_file_stream << "</updateSequence>\n";
+
+      recorder.drain();
+
+      if ( update_log.isOpen() ) {
+         update_log.endRun();
+      } else {
+         output_buffer << "</updateSequence>\n";
+      }
    }
 
    recording = 0;
@@ -555,16 +562,56 @@ void multiGraphManager::pause( void ) {
 
 void multiGraphManager::record( void ) {
 
-   if ( !(recording) ) {
-      output_file_stream << "<updateSequence>\n";
+   if ( !(recording) && !(update_log.isOpen()) ) {
+      indexElement("updateSequence");
+      output_buffer << "<updateSequence>\n";
    }
 
    recording = 1;
 }
 
-// Process an XML input file, breaking it first into update-sequences
-// and snapshots.  Scan to last snapshot, create a graph to match, then
-// process all subsequent updates.
+// Record updates into a binary update log instead of the output file.
+
+bool multiGraphManager::recordToLog( const char* logfilename ) {
+
+   int was_recording = recording;
+
+   if ( was_recording ) {
+      pause();
+   }
+
+   recorder.drain();
+
+   if ( !update_log.open(logfilename) ) {
+      recorder.setLog(NULL);
+      return false;
+   }
+
+   recorder.setLog(&update_log);
+
+   if ( was_recording ) {
+      record();
+   }
+
+   return true;
+}
+
+// Apply every update in a binary update log to the graph.
+
+long multiGraphManager::replayLog( const char* logfilename ) {
+
+   return replayUpdateLog(logfilename, G);
+}
+
+// Hand update serialization to a writer thread.
+
+void multiGraphManager::enableAsyncRecording( void ) {
+
+   recorder.start();
+}
+
+// Process an XML input file: create the graph declared in it, and apply
+// each snapshot and update sequence in turn.
 //
 // Possibly to be made more flexible in future, e.g. reporting some
 // graph statistic at each snapshot, etc.
@@ -575,229 +622,147 @@ void multiGraphManager::record( void ) {
 
 void multiGraphManager::processFile( char* filename ) {
    
-   ifstream input_file_stream;
+   xmlTagReader reader;
    
-   input_file_stream.open(filename);
-   assert(input_file_stream);
+   reader.open(filename);
+   assert(reader.isOpen());
    
-   string line;
-   vector<string> tagStrings;
-   tagStrings.clear();
+   processTags(reader, INT_MAX);
+}
+
+// Load the graph as it stood at the end of time step 'time' in a recorded
+// file.  Start from the last snapshot taken no later than that, and replay
+// only what follows it.
+
+bool multiGraphManager::loadAt( char* filename, int time ) {
    
-   // Preprocess lines into strings and save in the 'tagStrings' vector.
+   vector<indexEntry> index;
    
-   while ( getline(input_file_stream, line) ) {
-      
-      // Strip leading whitespace.
-      
-      while ( line[0] == ' ' || line[0] == '\t' ) {
-         line.erase(0,1);
-      }
-      
-      // Strip trailing non-tag characters, backing up to the end of a tag.
-      
-      while (line[line.length() - 1] != '>' && line.length() > 0) {
-         line.erase( (line.length() - 1), 1 );
-      }
-      
-      // If we're at the beginning of a tag,
+   if ( !readIndex(filename, index) && !scanIndex(filename, index) ) {
+      return false;
+   }
+   
+   // If there's no such snapshot, start from the top of the file.
+   
+   long long start = 0;
+   
+   for ( unsigned int i = 0; i < index.size(); i++ ) {
       
-      if ( line[0] == '<' ) {
-         
-         // Save the tag.
-         
-         tagStrings.push_back(line);
+      if ( index[i].element == "snapshot" && index[i].time <= time ) {
+         start = index[i].offset;
       }
    }
    
-   string tempString;
+   xmlTagReader reader;
    
-   vector<xmlTag> xmlTags;
-   xmlTags.clear();
+   if ( !reader.open(filename) || !reader.seek(start) ) {
+      return false;
+   }
    
-   vector<string>::iterator stringIter = tagStrings.begin();
+   processTags(reader, time);
    
-   // Save tags in their final form, as hashes of string/string pairs.
+   return true;
+}
+
+// Load the k-th snapshot [counting from 0] in a recorded file.
+
+bool multiGraphManager::loadSnapshot( char* filename, int k ) {
    
-   while ( stringIter != tagStrings.end() ) {
-      
-      line = *stringIter;
-      xmlTag currentTag;
-      initTag(currentTag);
-      
-      // Remove initial '<'.  Save potential initial / as part of tag name,
-      // i.e., the tag name of "</updateSequence>" will be "/updateSequence".
-      
-      line = line.substr(1, line.length()-1);
-      
-      // Grab tag name.  Assume no whitespace between initial '<' and
-      // tag name.
+   vector<indexEntry> index;
+   
+   if ( !readIndex(filename, index) && !scanIndex(filename, index) ) {
+      return false;
+   }
+   
+   for ( unsigned int i = 0; i < index.size(); i++ ) {
       
-      tempString = line[0];
-      line.erase(0,1);
+      if ( index[i].element != "snapshot" ) {
+         continue;
+      }
       
-      while ( line[0] != ' ' && line[0] != '\t' && line[0] != '>'
-            && line.substr(0, 2) != "/>" ) {
-         
-         tempString += line[0];
-         line.erase(0,1);
+      if ( k > 0 ) {
+         k--;
+         continue;
       }
       
-      currentTag.tagName = tempString;
+      xmlTagReader reader;
+      xmlTag tempTag;
       
-      // While there are more attribute/value pairs in the input line,
-      // read them into our tag structure.
+      initTag(tempTag);
       
-      while ( moreAttributeData(line) ) {
-         
-         getNextPair(line, currentTag);
+      if ( !reader.open(filename) || !reader.seek(index[i].offset)
+            || !reader.next(tempTag) || tempTag.tagName != "snapshot" ) {
+         return false;
       }
       
-      xmlTags.push_back(currentTag);
+      readSnapshot(reader, tempTag);
       
-      stringIter++;
+      return true;
    }
    
-   // Now that we've got a vector of xmlTags, squidge it into chunks:
-   //    
-   //    graph declarations
-   //    update sequences
-   //    graph snapshots
-   // 
-   // and pass each chunk to the appropriate subprocessor.
+   return false;
+}
+
+// Replace the graph with one read from a file in a standard format.
+
+bool multiGraphManager::importGraph( const char* filename,
+                                     graphFormat format ) {
    
-   xmlTag tempTag;
-   vector<xmlTag> chunkVector;
+   int numNodes;
+   vector<int> endpoints;
    
-   while ( xmlTags.size() > 0 ) {
-      
-      chunkVector.clear();
-      
-      // Scan the first tag and delete it from the main vector.
-      
-      tempTag = xmlTags[0];
-      xmlTags.erase(xmlTags.begin());
-      
-      if ( tempTag.tagName == "graph" ) {
-         
-         // Scrap everything and create a new graph with the desired
-         // parameters.  It'd better be an undirected multiGraph, or we'll
-         // barf all over the user.
-         
-         if ( tempTag.directed != 0 || tempTag.multi != 1 ) {
-            
-            cout << "Wrong type of graph in input file.  Exiting.\n";
-            exit(1);
-            
-         } else if ( tempTag.graphType == '\0' ) {
-            
-            // Create a graph with nodeSize nodes.  Emulate the appropriate
-            // constructor.
-            
-            G = new multiGraph(tempTag.nodeSize);
-         
-            nodes = &(G->nodes);
-            edges = &(G->edges);
-            
-            int was_recording = recording;
-            
-            if ( was_recording ) {
-               pause();
-            }
-            
-            output_file_stream << "</graph>\n"
-                  << "<graph nodeSize=\"" << tempTag.nodeSize
-            	   << "\" directed=\"0\" multi=\"1\">\n";
-               
-            if ( was_recording ) {
-               record();
-            }
-            
-         } else {
-            
-            // Create a graph with nodeSize nodes, of type graphType.
-            // Emulate the appropriate constructor.
-            
-            G = new multiGraph(tempTag.graphType, tempTag.nodeSize);
-         
-            nodes = &(G->nodes);
-            edges = &(G->edges);
-            
-            int was_recording = recording;
-            
-            if ( was_recording ) {
-               pause();
-            }
-            
-            output_file_stream << "</graph>\n"
-               << "<graph nodeSize=\"" << tempTag.nodeSize
-               << "\" directed=\"0\" multi=\"1\" graphType=\""
-               << tempTag.graphType << "\">\n";
-               
-            if ( was_recording ) {
-               record();
-            }
-         }
-         
-      } else if ( tempTag.tagName == "updateSequence" ) {
-         
-         // Use chunkVector to create an updateSequence, then pass
-         // it to processUpdates().
-         
-         // Until we reach the end, grab all update commands.
-         
-         while ( xmlTags[0].tagName != "/updateSequence" ) {
-            
-            chunkVector.push_back(xmlTags[0]);
-            xmlTags.erase(xmlTags.begin());
-         }
-         
-         // Delete the closing </updateSequence> tag.
-         
-         xmlTags.erase(xmlTags.begin());
-         
-         // Execute the updates in sequence.
-         
-         processUpdates(chunkVector);
-         
-      } else if ( tempTag.tagName == "snapshot" ) {
-         
-         // Use chunkVector to create a graph-snapshot sequence, then pass
-         // it to processSnapshot().
-      
-         // Until we reach the end, grab all snapshot elements.
-         
-	 vector<xmlTag>::iterator xmlIter = xmlTags.begin();
-	 
-	 while ( (*xmlIter).tagName != "/snapshot" ) {
-	    
-	    xmlTag tempTag = *xmlIter;
+   if ( !readGraphFile(filename, format, numNodes, endpoints) ) {
+      return false;
+   }
+   
+   delete G;
+   
+   G = new multiGraph();
+   G->addNodes(numNodes);
+   G->addEdges(endpoints);
+   
+   nodes = &(G->nodes);
+   edges = &(G->edges);
+   
+   int was_recording = recording;
+   
+   if ( was_recording ) {
+      pause();
+   }
+   
+   output_buffer << "</graph>\n";
+   
+   indexElement("graph");
+   output_buffer << "<graph nodeSize=\"" << numNodes
+      << "\" directed=\"0\" multi=\"1\">\n";
+   
+   if ( was_recording ) {
+      snapshot();
+      record();
+   }
+   
+   return true;
+}
 
-            chunkVector.push_back(tempTag);
+// Read a graph file, in whichever format its extension says.
 
-	    xmlIter++;
-         }
-         
-	 // Delete the tags we just copied into chunkVector.
-	 
-	 xmlTags.erase(xmlTags.begin(), xmlIter);
-	 
-         // Delete the closing </snapshot> tag.
-         
-         xmlTags.erase(xmlTags.begin());
-         
-         // Reconstruct the snapshot.
-         
-         processSnapshot(chunkVector);
-         
-      } else if ( tempTag.tagName == "/graph" ) {
-         
-         // Skip it, it's a non-action tag.
-      }
+bool multiGraphManager::loadFile( char* filename ) {
    
-   } // end while (we're scanning all tags in the input file)
+   graphFormat format;
    
-   input_file_stream.close();
+   if ( formatFromExtension(filename, format) ) {
+      return importGraph(filename, format);
+   }
+   
+   xmlTagReader reader;
+   
+   if ( !reader.open(filename) ) {
+      return false;
+   }
+   
+   processTags(reader, INT_MAX);
+   
+   return true;
 }
 
 // Write a snapshot of the current graph to the output file.
@@ -812,7 +777,10 @@ void multiGraphManager::snapshot( void ) {
 
    // Write the structural snapshot.
 
-   output_file_stream << "<snapshot>\n";
+   indexElement("snapshot");
+   output_buffer << "<snapshot time=\"" << G->getTime()
+      << "\" nodeIndex=\"" << G->getNodeIndex()
+      << "\" edgeIndex=\"" << G->getEdgeIndex() << "\">\n";
 
    node_hash_t::iterator node_iterator;
    edge_hash_t::iterator edge_iterator;
@@ -824,7 +792,7 @@ void multiGraphManager::snapshot( void ) {
 	      node_iterator++ ) {
 
 	 node_ptr = node_iterator->second;
-	 output_file_stream << "   <node ID=\"" << node_ptr->getId()
+	 output_buffer << "   <node ID=\"" << node_ptr->getId()
 	    << "\" color=\"" << node_ptr->getColor()
 	    << "\" weight=\"" << node_ptr->getWeight()
 	    << "\"/>\n";
@@ -834,7 +802,7 @@ void multiGraphManager::snapshot( void ) {
 	      edge_iterator++ ) {
 
 	 edge_ptr = edge_iterator->second;
-	 output_file_stream << "   <edge ID=\"" << edge_ptr->getId()
+	 output_buffer << "   <edge ID=\"" << edge_ptr->getId()
 	    << "\" color=\"" << edge_ptr->getColor()
 	    << "\" weight=\"" << edge_ptr->getWeight()
 	    << "\" nodeID_1=\"" << edge_ptr->getNode1()
@@ -842,7 +810,7 @@ void multiGraphManager::snapshot( void ) {
 	    << "\"/>\n";
    }
 
-   output_file_stream << "</snapshot>\n";
+   output_buffer << "</snapshot>\n";
 
    // Resume recording, if we were originally.
 
@@ -853,25 +821,130 @@ void multiGraphManager::snapshot( void ) {
 
 // [Private member functions]
 
-// Input parsing functions called by processFile().  Change argument
-// type to reflect XML parse tree, or whatever internal data structure
-// ends up representing the appropriate chunk of input data.
-//
-// *****************************
-// DEPRECATED FOR THE TIME BEING
-// *****************************
+// Input parsing functions called by processFile() and friends.
 
-void multiGraphManager::processUpdates( vector<xmlTag>& updates ) {
+// Read tags and act on them until the end of the file: 'graph' tags
+// replace the graph, snapshots are reconstructed, and updates are applied
+// as they're read.  Stop short of the first incTime that would carry the
+// graph past 'stopTime'.
+
+void multiGraphManager::processTags( xmlTagReader& reader, int stopTime ) {
    
    xmlTag tempTag;
+   initTag(tempTag);
    
-   // Execute each update in the sequence provided.
-   
-   while ( updates.size() > 0 ) {
+   while ( reader.next(tempTag) ) {
       
-      tempTag = updates[0];
-      updates.erase(updates.begin());
+      if ( tempTag.tagName == "graph" ) {
+         
+         // Scrap everything and create a new graph with the desired
+         // parameters.  It'd better be an undirected multiGraph, or we'll
+         // barf all over the user.
+         
+         if ( tempTag.directed != 0 || tempTag.multi != 1 ) {
+            
+            cout << "Wrong type of graph in input file.  Exiting.\n";
+            exit(1);
+         }
+         
+         delete G;
+         
+         if ( tempTag.graphType == '\0' ) {
+            
+            // Create a graph with nodeSize nodes.  Emulate the appropriate
+            // constructor.
+            
+            G = new multiGraph(tempTag.nodeSize);
+            
+         } else {
+            
+            // Create a graph with nodeSize nodes, of type graphType.
+            // Emulate the appropriate constructor.
+            
+            G = new multiGraph(tempTag.graphType, tempTag.nodeSize);
+         }
+         
+         nodes = &(G->nodes);
+         edges = &(G->edges);
+         
+         int was_recording = recording;
+         
+         if ( was_recording ) {
+            pause();
+         }
+         
+         output_buffer << "</graph>\n";
+         
+         indexElement("graph");
+         output_buffer << "<graph nodeSize=\"" << tempTag.nodeSize
+            << "\" directed=\"0\" multi=\"1\"";
+         
+         if ( tempTag.graphType != '\0' ) {
+            output_buffer << " graphType=\"" << tempTag.graphType << "\"";
+         }
+         
+         output_buffer << ">\n";
+         
+         if ( was_recording ) {
+            record();
+         }
+         
+      } else if ( tempTag.tagName == "updateSequence" ) {
+         
+         // Execute each update as it's read, up to the closing tag.
+         
+         initTag(tempTag);
+         
+         while ( reader.next(tempTag)
+               && tempTag.tagName != "/updateSequence" ) {
+            
+            if ( tempTag.tagName == "incTime" && G->getTime() >= stopTime ) {
+               return;
+            }
+            
+            processUpdate(tempTag);
+            initTag(tempTag);
+         }
+         
+      } else if ( tempTag.tagName == "snapshot" ) {
+         
+         if ( tempTag.time > stopTime ) {
+            return;
+         }
+         
+         readSnapshot(reader, tempTag);
+         
+      } // end switch on tag name ["/graph" etc. are non-action tags]
       
+      initTag(tempTag);
+   
+   } // end while (we're scanning all tags in the input file)
+}
+
+// Collect the elements of a snapshot, whose opening tag has just been
+// read, and reconstruct it.
+
+void multiGraphManager::readSnapshot( xmlTagReader& reader,
+                                      const xmlTag& snapshotTag ) {
+   
+   vector<xmlTag> chunkVector;
+   
+   xmlTag tempTag;
+   initTag(tempTag);
+   
+   while ( reader.next(tempTag) && tempTag.tagName != "/snapshot" ) {
+      
+      chunkVector.push_back(tempTag);
+      initTag(tempTag);
+   }
+   
+   processSnapshot(chunkVector, snapshotTag);
+}
+
+// Apply a single update tag.
+
+void multiGraphManager::processUpdate( const xmlTag& tempTag ) {
+   
       if ( tempTag.tagName == "addNode" ) {
          
          this->addNode();
@@ -915,7 +988,7 @@ void multiGraphManager::processUpdates( vector<xmlTag>& updates ) {
                this->addEdge(tempTag._node_1, tempTag._node_2);
             }
             
-         } else if ( tempTag.attribute_1 != -1 ) {
+         } else if ( tempTag.attribute_1 != '\0' ) {
             
             // (attribute_1, value_1, attribute_2, value_2 version.)
             
@@ -1003,15 +1076,19 @@ void multiGraphManager::processUpdates( vector<xmlTag>& updates ) {
             
          } // end switch on version of deleteRandomEdge
          
+      } else if ( tempTag.tagName == "incTime" ) {
+         
+         this->incTime();
+         
       } // end switch on tag name
-   
-   } // end iterator over all tags in update sequence
 }
 
-void multiGraphManager::processSnapshot( vector<xmlTag>& snapshot ) {
+void multiGraphManager::processSnapshot( vector<xmlTag>& snapshot,
+                                         const xmlTag& snapshotTag ) {
    
    // Reset our internal graph.
    
+   delete G;
    G = new multiGraph();
    
    nodes = &(G->nodes);
@@ -1019,6 +1096,9 @@ void multiGraphManager::processSnapshot( vector<xmlTag>& snapshot ) {
    
    xmlTag tempTag;
    
+   int maxNode = -1;
+   int maxEdge = -1;
+   
    // Create each graph object in the sequence provided.
    
    vector<xmlTag>::iterator xmlIter = snapshot.begin();
@@ -1034,6 +1114,8 @@ void multiGraphManager::processSnapshot( vector<xmlTag>& snapshot ) {
          G->setNodeColor(tempTag.ID, tempTag.color);
          G->setNodeWeight(tempTag.ID, tempTag.weight);
          
+         maxNode = max(maxNode, tempTag.ID);
+         
       } else if ( tempTag.tagName == "edge" ) {
          
          G->setEdgeIndex(tempTag.ID);
@@ -1041,189 +1123,188 @@ void multiGraphManager::processSnapshot( vector<xmlTag>& snapshot ) {
          G->edges[tempTag.ID]->setColor(tempTag.color);
          G->edges[tempTag.ID]->setWeight(tempTag.weight);
          
+         maxEdge = max(maxEdge, tempTag.ID);
+         
       } // end switch on tag name
       
       xmlIter++;
 
    } // end iterator over all tags in snapshot
    
+   // Pick up where the snapshot's graph left off, so that replayed
+   // updates create the same IDs they did originally.  Older snapshots
+   // don't say, so settle for not reusing an ID.
+   
+   G->setNodeIndex( snapshotTag.nodeIndex != -1 ? snapshotTag.nodeIndex
+                                                : maxNode + 1 );
+   G->setEdgeIndex( snapshotTag.edgeIndex != -1 ? snapshotTag.edgeIndex
+                                                : maxEdge + 1 );
+   
+   if ( snapshotTag.time != -1 ) {
+      G->setTime(snapshotTag.time);
+   }
+   
    if ( recording ) {
       this->snapshot();
    }
 }
 
-// Is there more attribute data in a given tag?  Assume the tag name
-// has already been removed, so everything left should be properly paired.
+// Pass an update on to the recorder, noting whether resolved IDs are to
+// be written out.
 
-bool moreAttributeData( string& line ) {
-   
-   bool moreData = false;
+void multiGraphManager::recordUpdate( updateRecord& update ) {
+
+   update.structure = structureInfo;
+   recorder.push(update);
+}
+
+// Fill in a record's resolved endpoints from a freshly added edge, or leave
+// them at -1 if the addition failed.
+
+void multiGraphManager::recordEndpoints( updateRecord& update, int edgeID ) {
+
+   if ( edgeID != -1 ) {
+      update._node_1 = G->edges[edgeID]->getNode1();
+      update._node_2 = G->edges[edgeID]->getNode2();
+   }
+}
+
+// ---------------------
+// Random-access index.
+// ---------------------
+
+// Open the index alongside the output file, and overwrite any preexisting
+// index with this name.
+
+void multiGraphManager::openIndex( void ) {
    
-   // Kill initial whitespace.
+   string indexName = string(output_file_name) + ".idx";
    
-   while ( line[0] == ' ' || line[0] == '\t' ) {
-      line.erase(0,1);
-   }
+   index_buffer.open(indexName.c_str());
+}
+
+// Add an index entry for the element about to be written to the output
+// file.  The output buffer knows its own position, so this costs nothing
+// but the line itself.
+
+void multiGraphManager::indexElement( const char* element ) {
    
-   if (  line[0] != '>' && line.substr(0, 2) != "/>" ) {
-      
-      moreData = true;
+   if ( !index_buffer.isOpen() ) {
+      return;
    }
    
-   return moreData;
+   index_buffer << element << " " << output_buffer.tell() << " "
+      << G->getTime() << "\n";
 }
 
-// Get next attribute/value pair from a given tag into an 'xmlTag' struct.
-// Assume such a pair exists and is at the immediate beginning of the string.
+// Read the index for a given file.  Check the first and last entries
+// against the file itself, so a stale or mismatched index isn't trusted.
 
-void getNextPair( string& line, xmlTag& tag ) {
+bool multiGraphManager::readIndex( char* filename,
+                                   vector<indexEntry>& index ) {
    
-   string attributeName = "";
-   string value = "";
+   index.clear();
    
-   // Grab the attribute name.
+   string indexName = string(filename) + ".idx";
    
-   while ( line[0] != '=' ) {
-      
-      attributeName += line[0];
-      line.erase(0, 1);
-   }
-   
-   // Erase the equals-sign & quote mark before the value.
+   FILE* file = fopen(indexName.c_str(), "r");
    
-   line.erase(0, 1);
-   line.erase(0, 1);
+   if ( file == NULL ) {
+      return false;
+   }
    
-   // Get the value.
+   char element[32];
+   long long offset;
+   int time;
    
-   while ( line[0] != '\"' ) {
+   while ( fscanf(file, "%31s %lld %d", element, &offset, &time) == 3 ) {
       
-      value += line[0];
-      line.erase(0, 1);
+      indexEntry entry;
+      entry.element = element;
+      entry.offset = offset;
+      entry.time = time;
+      
+      index.push_back(entry);
    }
    
-   // Erase the quote mark after the value.
+   fclose(file);
    
-   line.erase(0, 1);
+   if ( index.empty() ) {
+      return false;
+   }
    
-   // Insert the value, typed appropriately, into the proper field
-   // in the xmlTag structure.
+   xmlTagReader reader;
+   xmlTag tempTag;
    
-   if ( attributeName == "attribute" ) {
-      
-      tag.attribute = value[0];
-      
-   } else if ( attributeName == "attribute_1" ) {
-      
-      tag.attribute_1 = value[0];
-      
-   } else if ( attributeName == "attribute_2" ) {
-      
-      tag.attribute_2 = value[0];
-      
-   } else if ( attributeName == "graphType" ) {
-      
-      tag.graphType = value[0];
-      
-   } else if ( attributeName == "color" ) {
-      
-      tag.color = atoi(value.c_str());
-      
-   } else if ( attributeName == "ID" ) {
-      
-      tag.ID = atoi(value.c_str());
-      
-   } else if ( attributeName == "_ID" ) {
-      
-      tag._ID = atoi(value.c_str());
-      
-   } else if ( attributeName == "node_1" ) {
-      
-      tag.node_1 = atoi(value.c_str());
-      
-   } else if ( attributeName == "_node_1" ) {
-      
-      tag._node_1 = atoi(value.c_str());
-      
-   } else if ( attributeName == "node_2" ) {
-      
-      tag.node_2 = atoi(value.c_str());
-      
-   } else if ( attributeName == "_node_2" ) {
-      
-      tag._node_2 = atoi(value.c_str());
-      
-   } else if ( attributeName == "nodeID_1" ) {
-      
-      tag.nodeID_1 = atoi(value.c_str());
-      
-   } else if ( attributeName == "nodeID_2" ) {
-      
-      tag.nodeID_2 = atoi(value.c_str());
-      
-   } else if ( attributeName == "nodeSize" ) {
-      
-      tag.nodeSize = atoi(value.c_str());
-      
-   } else if ( attributeName == "directed" ) {
-      
-      tag.directed = atoi(value.c_str());
-      
-   } else if ( attributeName == "multi" ) {
-      
-      tag.multi = atoi(value.c_str());
-      
-   } else if ( attributeName == "value" ) {
-      
-      tag.value = atof(value.c_str());
-      
-   } else if ( attributeName == "value_1" ) {
-      
-      tag.value_1 = atof(value.c_str());
-      
-   } else if ( attributeName == "value_2" ) {
+   if ( !reader.open(filename) ) {
+      return false;
+   }
+   
+   for ( int i = 0; i < 2; i++ ) {
       
-      tag.value_2 = atof(value.c_str());
+      const indexEntry& entry = ( i == 0 ) ? index.front() : index.back();
       
-   } else if ( attributeName == "weight" ) {
+      initTag(tempTag);
       
-      tag.weight = atof(value.c_str());
+      if ( !reader.seek(entry.offset) || !reader.next(tempTag)
+            || reader.tagOffset() != entry.offset
+            || tempTag.tagName != entry.element ) {
+         
+         index.clear();
+         return false;
+      }
    }
+   
+   return true;
 }
 
-// Seed some default values to facilitate structure discovery later on.
+// Build the index for a given file with a single scan through it, keeping
+// track of the time by counting incTime updates.
 
-void initTag( xmlTag& tag ) {
+bool multiGraphManager::scanIndex( char* filename,
+                                   vector<indexEntry>& index ) {
    
-   tag.attribute = '\0';
-   tag.attribute_1 = '\0';
-   tag.attribute_2 = '\0';
-   tag.graphType = '\0';
+   index.clear();
    
-   tag.color = -1;
-   tag.ID = -1;
-   tag.node = -1;
-   tag._ID = -1;
-   tag.node_1 = -1;
-   tag._node_1 = -1;
-   tag.node_2 = -1;
-   tag._node_2 = -1;
-   tag.nodeID_1 = -1;
-   tag.nodeID_2 = -1;
-   tag.nodeSize = -1;
-
-   tag.directed = -1;
-   tag.multi = -1;
+   xmlTagReader reader;
+   xmlTag tempTag;
    
-   // These'll be picked up only if the 'attribute*' fields contain
-   // relevant data, so their seed values don't matter.
+   if ( !reader.open(filename) ) {
+      return false;
+   }
+   
+   int time = 0;
    
-   tag.value = 0;
-   tag.value_1 = 0;
-   tag.value_2 = 0;
+   initTag(tempTag);
    
-   // Set to a hopefully unlikely value to serve later as a marker for
-   // whether or not this has been set.
+   while ( reader.next(tempTag) ) {
+      
+      if ( tempTag.tagName == "incTime" ) {
+         
+         time++;
+         
+      } else if ( tempTag.tagName == "graph"
+            || tempTag.tagName == "snapshot"
+            || tempTag.tagName == "updateSequence" ) {
+         
+         // A new graph starts its clock over; a snapshot carries its own.
+         
+         if ( tempTag.tagName == "graph" ) {
+            time = 0;
+         } else if ( tempTag.time != -1 ) {
+            time = tempTag.time;
+         }
+         
+         indexEntry entry;
+         entry.element = tempTag.tagName;
+         entry.offset = reader.tagOffset();
+         entry.time = time;
+         
+         index.push_back(entry);
+      }
+      
+      initTag(tempTag);
+   }
    
-   tag.weight = WEIGHT_INIT;
+   return true;
 }
@@ -11,37 +11,22 @@
 //#include <hash_map>
 #include <backward/hash_map>
 #include "multiGraph.h"
+#include "outputBuffer.h"
+#include "updateRecorder.h"
+#include "graphFormats.h"
+#include "updateLog.h"
+#include "xmlTagReader.h"
+
+// One entry of a recorded file's index: the element [graph, snapshot or
+// updateSequence] beginning at byte 'offset', and the graph's time there.
 
 typedef struct {
    
-   string tagName;
-   
-   char attribute;
-   char attribute_1;
-   char attribute_2;
-   char graphType;
-   
-   int color;
-   int  ID;
-   int _ID;
-   int node;
-   int  node_1;
-   int _node_1;
-   int  node_2;
-   int _node_2;
-   int  nodeID_1;
-   int  nodeID_2;
-   int nodeSize;
-
-   short directed;
-   short multi;
+   string element;
+   long long offset;
+   int time;
    
-   double value;
-   double value_1;
-   double value_2;
-   double weight;
-      
-} xmlTag;
+} indexEntry;
 
 class multiGraphManager {
 
@@ -60,6 +45,12 @@ class multiGraphManager {
 
       multiGraphManager( char* outputfilename );
 
+      // Create an empty graph with no output file at all, for programs
+      // that only read graphs: snapshots and recorded updates go nowhere,
+      // and nothing is created or overwritten.
+
+      multiGraphManager( void );
+
       // Copy constructor.
 
       multiGraphManager( multiGraphManager& source );
@@ -96,11 +87,16 @@ class multiGraphManager {
             pause();
          }
 
-         if (output_file_stream.is_open()){
-             output_file_stream << "</graph>\n";
-             output_file_stream.close();
+         recorder.stop();
+         update_log.close();
+
+         if (output_buffer.isOpen()){
+             output_buffer << "</graph>\n";
+             output_buffer.close();
          }
 
+         index_buffer.close();
+
       }
 
       // --------------------
@@ -132,11 +128,11 @@ class multiGraphManager {
          return G->getTime();
       }
 
-      // Increment the contained graph's time counter by one step.
+      // Increment the contained graph's time counter by one step.  This is
+      // recorded like any other update, so that a recorded file can be
+      // loaded as of any point in time.
 
-      void incTime( void ) {
-         G->incTime();
-      }
+      void incTime( void );
 
       // Report the contained graph's average degree.
 
@@ -291,6 +287,26 @@ class multiGraphManager {
 
       void record( void );
 
+      // Serialize recorded updates on a separate writer thread instead of
+      // inside each graph operation.  Pausing or taking a snapshot still
+      // waits for everything recorded so far to reach the output file.
+
+      void enableAsyncRecording( void );
+
+      // Record updates into a compact binary update log [see updateLog.h]
+      // rather than as XML update sequences in the output file.  Random
+      // operations are logged by outcome, so the log replays exactly
+      // whatever the structureInfo setting.  Snapshots still go to the
+      // output file.  Returns false if the log couldn't be opened.
+
+      bool recordToLog( const char* logfilename );
+
+      // Apply every update in a binary update log to the graph, in bulk.
+      // Replayed updates aren't themselves recorded.  Returns the number of
+      // updates applied, or -1 if the log was unreadable or damaged.
+
+      long replayLog( const char* logfilename );
+
       // Enable extra structural info in recording graph operations.
 
       void enableStructureInfo( void ) {
@@ -305,18 +321,83 @@ class multiGraphManager {
          structureInfo = 0;
       }
 
-      // Process an XML input file, breaking it first into update-sequences
-      // and snapshots.  Scan to last snapshot, create a graph to match, then
-      // process all subsequent updates.
+      // Process an XML input file from top to bottom: create the graph
+      // declared in it, then apply each snapshot and update sequence in
+      // turn.
       //
       // Possibly to be made more flexible in future, e.g. reporting some
       // graph statistic at each snapshot, etc.
 
       void processFile( char* filename );
 
+      // Random access into a recorded file.  Alongside its output file, the
+      // manager writes an index, <output file>.idx, with one line
+      //
+      //    element offset time
+      //
+      // for each graph, snapshot and updateSequence element it writes:
+      // the element's name, the byte offset of its opening tag, and the
+      // graph's time there.  These functions use that index [or, if it's
+      // missing or doesn't match the file, build one with a single scan] to
+      // start reading at the right place instead of at the top.
+      //
+      // Load the graph as it stood at the end of time step 'time', starting
+      // from the latest snapshot no later than that.  Returns false if the
+      // file couldn't be read.
+
+      bool loadAt( char* filename, int time );
+
+      // Load the k-th snapshot [counting from 0] in a file.  Returns false
+      // if the file couldn't be read or has no such snapshot.
+
+      bool loadSnapshot( char* filename, int k );
+
+      // Replace the graph with one read from an edge list, METIS or Matrix
+      // Market file [see graphFormats.h].  The output file starts a new
+      // graph element, as it does for a graph tag read by processFile(),
+      // and gets a snapshot of the imported graph if we're recording.
+      // Returns false, leaving the graph alone, if the file couldn't be
+      // read.
+
+      bool importGraph( const char* filename, graphFormat format );
+
+      // Read a graph file of any kind the manager knows: an edge list,
+      // METIS or Matrix Market file, told by its extension [see
+      // formatFromExtension], goes through importGraph(), and anything
+      // else is taken for an XML file and goes through processFile().
+      // Returns false if the file couldn't be read.
+
+      bool loadFile( char* filename );
+
+      // Write the graph to an edge list, METIS or Matrix Market file.
+      // Returns false if the file couldn't be opened.
+
+      bool exportGraph( const char* filename, graphFormat format ) {
+
+         return writeGraphFile(filename, format, G);
+      }
+
       // Write a snapshot of the current graph to the output file.
 
       void snapshot( void );
+
+      // Hand output-file writes to a background thread, so snapshots and
+      // recorded updates only pay for formatting.
+
+      void enableBackgroundWriter( void ) {
+
+         output_buffer.enableBackgroundWriter();
+      }
+
+      // Block-compress the output file [see blockCodec.h]; processFile(),
+      // loadAt() and loadSnapshot() recognize compressed files on their
+      // own, and the index still works.  Call right after construction.
+      // Returns false if the output file was already under way.
+
+      bool enableCompression( void ) {
+
+         return output_buffer.enableCompression();
+      }
       
       // This should undoubtedly be private, but it's going to have to wait.
 
@@ -325,17 +406,34 @@ class multiGraphManager {
    private:
 
       const char* output_file_name;
-      ofstream output_file_stream;
+      outputBuffer output_buffer;
+      outputBuffer index_buffer;
+      updateLogWriter update_log;
+      updateRecorder recorder;
 
       int recording;
       int structureInfo;
 
-      // Input parsing functions called by processFile().  Change argument
-      // type to reflect XML parse tree, or whatever internal data structure
-      // ends up representing the appropriate chunk of input data.
+      // Input parsing functions called by processFile() and friends.
+
+      void processTags( xmlTagReader& reader, int stopTime );
+      void readSnapshot( xmlTagReader& reader, const xmlTag& snapshotTag );
+      void processUpdate( const xmlTag& );
+      void processSnapshot( vector<xmlTag>&, const xmlTag& snapshotTag );
+
+      // Index helpers: open <output file>.idx, add an entry for the element
+      // about to be written to the output file, and read or rebuild the
+      // index for an input file.
+
+      void openIndex( void );
+      void indexElement( const char* element );
+      bool readIndex( char* filename, vector<indexEntry>& index );
+      bool scanIndex( char* filename, vector<indexEntry>& index );
+
+      // Recording helpers for the wrapped graph operations.
 
-      void processUpdates( vector<xmlTag>& );
-      void processSnapshot( vector<xmlTag>& );
+      void recordUpdate( updateRecord& update );
+      void recordEndpoints( updateRecord& update, int edgeID );
 };
 
 #endif
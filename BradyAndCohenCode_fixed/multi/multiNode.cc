@@ -10,7 +10,8 @@
 // Receives an ID parameter and a creation time as its first and second
 // arguments, and enables defaults for all other data members.
 
-multiNode::multiNode( int ID, int ctime ) {
+multiNode::multiNode( int ID, int ctime )
+   : incidentEdges( NODE_HASH_BUCKETS ), adjacentVertices( NODE_HASH_BUCKETS ) {
 
    id = ID;
    creationTime = ctime;
@@ -25,7 +26,8 @@ multiNode::multiNode( int ID, int ctime ) {
 // Copy constructor.  Does not transfer any information about adjacent edges;
 // that's the graph's job.
 
-multiNode::multiNode( multiNode& source ) {
+multiNode::multiNode( multiNode& source )
+   : incidentEdges( NODE_HASH_BUCKETS ), adjacentVertices( NODE_HASH_BUCKETS ) {
    
    id = source.id;
    
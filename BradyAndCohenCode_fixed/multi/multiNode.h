@@ -16,6 +16,12 @@ using namespace __gnu_cxx; // This might be necessary for older GCC versions
 
 class multiEdge;
 
+// Initial bucket count for each node's edge and neighbor sets.  Most nodes
+// have small degree, and hash_set's default [193 buckets] costs several
+// KB per node before a single edge is added.  The sets grow as needed.
+
+#define NODE_HASH_BUCKETS 8
+
 class multiNode {
    
    private:
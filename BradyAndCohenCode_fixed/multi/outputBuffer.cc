@@ -0,0 +1,576 @@
+// outputBuffer.cc: Definitions for the block-buffered text writer used by
+// multiGraphManager for snapshots and update recording.
+
+#include "outputBuffer.h"
+#include "blockCodec.h"
+
+#include <cstring>
+#include <cmath>
+
+// -------------
+// Constructors.
+// -------------
+
+outputBuffer::outputBuffer() {
+
+   file = NULL;
+
+   block = new char[OUTPUT_BLOCK_SIZE];
+   spare = NULL;
+   current = block;
+   blockEnd = block + OUTPUT_BLOCK_SIZE;
+   blockOffset = 0;
+
+   compressing = false;
+   packed = NULL;
+
+   background = false;
+   stopping = false;
+   pending = NULL;
+   pendingLength = 0;
+}
+
+outputBuffer::~outputBuffer() {
+
+   close();
+
+   delete [] block;
+   delete [] spare;
+   delete [] packed;
+}
+
+// -----------------
+// File management.
+// -----------------
+
+bool outputBuffer::open( const char* filename ) {
+
+   close();
+
+   file = fopen(filename, "wb");
+
+   if ( file == NULL ) {
+      return false;
+   }
+
+   // We only ever hand the C library whole blocks, so its own buffering
+   // would just be an extra copy.
+
+   setvbuf(file, NULL, _IONBF, 0);
+
+   current = block;
+   blockEnd = block + OUTPUT_BLOCK_SIZE;
+   blockOffset = 0;
+
+   compressing = false;
+
+   return true;
+}
+
+void outputBuffer::close( void ) {
+
+   if ( file == NULL ) {
+      return;
+   }
+
+   flush();
+   stopBackgroundWriter();
+
+   fclose(file);
+   file = NULL;
+}
+
+void outputBuffer::flush( void ) {
+
+   if ( file == NULL ) {
+      return;
+   }
+
+   if ( current != block ) {
+      emitBlock();
+   }
+
+   if ( background ) {
+      waitForWriter();
+   }
+
+   fflush(file);
+}
+
+void outputBuffer::enableBackgroundWriter( void ) {
+
+   if ( background || file == NULL ) {
+      return;
+   }
+
+   if ( spare == NULL ) {
+      spare = new char[OUTPUT_BLOCK_SIZE];
+   }
+
+   pthread_mutex_init(&lock, NULL);
+   pthread_cond_init(&changed, NULL);
+
+   stopping = false;
+   pending = NULL;
+
+   if ( pthread_create(&writerThread, NULL, writerMain, this) == 0 ) {
+
+      background = true;
+
+   } else {
+
+      // No thread to be had; carry on writing synchronously.
+
+      pthread_cond_destroy(&changed);
+      pthread_mutex_destroy(&lock);
+   }
+}
+
+bool outputBuffer::enableCompression( void ) {
+
+   if ( file == NULL || blockOffset != 0 ) {
+      return false;
+   }
+
+   if ( compressing ) {
+      return true;
+   }
+
+   if ( packed == NULL ) {
+      packed = new char[ PACKED_BLOCK_BOUND(OUTPUT_BLOCK_SIZE) ];
+   }
+
+   // Nothing has reached the file yet, so the writer thread [if any] is
+   // idle.
+
+   fwrite(BLOCK_FILE_MAGIC, 1, BLOCK_FILE_MAGIC_SIZE, file);
+
+   compressing = true;
+
+   return true;
+}
+
+// ------------------
+// Append functions.
+// ------------------
+
+void outputBuffer::put( const char* s ) {
+
+   while ( *s != '\0' ) {
+
+      if ( current == blockEnd ) {
+         emitBlock();
+      }
+
+      *current++ = *s++;
+   }
+}
+
+void outputBuffer::put( const char* s, int length ) {
+
+   while ( length > 0 ) {
+
+      if ( current == blockEnd ) {
+         emitBlock();
+      }
+
+      int chunk = blockEnd - current;
+
+      if ( chunk > length ) {
+         chunk = length;
+      }
+
+      memcpy(current, s, chunk);
+
+      current += chunk;
+      s += chunk;
+      length -= chunk;
+   }
+}
+
+// Format an int directly into the block.  Digits are generated backwards
+// into a small scratch array, then copied forward.
+
+void outputBuffer::putInt( int value ) {
+
+   char digits[12];
+   int count = 0;
+
+   unsigned int magnitude = (value < 0) ? (0u - (unsigned int) value)
+                                        : (unsigned int) value;
+
+   do {
+      digits[count++] = '0' + (magnitude % 10);
+      magnitude /= 10;
+   } while ( magnitude != 0 );
+
+   if ( blockEnd - current < 12 ) {
+      emitBlock();
+   }
+
+   if ( value < 0 ) {
+      *current++ = '-';
+   }
+
+   while ( count > 0 ) {
+      *current++ = digits[--count];
+   }
+}
+
+// The same for a long long, e.g. a file offset.
+
+void outputBuffer::putLong( long long value ) {
+
+   char digits[21];
+   int count = 0;
+
+   unsigned long long magnitude = (value < 0)
+      ? (0ull - (unsigned long long) value) : (unsigned long long) value;
+
+   do {
+      digits[count++] = '0' + (magnitude % 10);
+      magnitude /= 10;
+   } while ( magnitude != 0 );
+
+   if ( blockEnd - current < 21 ) {
+      emitBlock();
+   }
+
+   if ( value < 0 ) {
+      *current++ = '-';
+   }
+
+   while ( count > 0 ) {
+      *current++ = digits[--count];
+   }
+}
+
+// Exact powers of five, for scaling a double by a power of ten without
+// rounding.
+
+static unsigned __int128 powerOfFive( int exponent ) {
+
+   unsigned __int128 power = 1;
+
+   while ( exponent-- > 0 ) {
+      power *= 5;
+   }
+
+   return power;
+}
+
+// Round 'value' [finite and positive] to DOUBLE_DIGITS significant decimal
+// digits, exactly and with ties to even, as the C library does.  Sets
+// 'digits' to them as an integer and 'exponent' to the power of ten of the
+// first.  Returns false if the value is out of the range the 128-bit
+// arithmetic covers [about 1e-15 to 1e25].
+//
+// Writing value = m 2^e with m a 53-bit integer, value / 10^(exponent - 5)
+// is a ratio of two integers, which fit in 128 bits over that range: the
+// quotient gives the digits and the remainder the rounding.
+
+#define DOUBLE_DIGITS 6
+#define DOUBLE_SCALE_MAX 20
+
+static bool roundDigits( double value, int& digits, int& exponent ) {
+
+   int binary;
+   double fraction = frexp(value, &binary);
+
+   unsigned long long mantissa = (unsigned long long) ldexp(fraction, 53);
+   binary -= 53;
+
+   exponent = (int) floor( log10(value) );
+
+   while ( true ) {
+
+      int scale = DOUBLE_DIGITS - 1 - exponent;
+
+      if ( scale > DOUBLE_SCALE_MAX || scale < -DOUBLE_SCALE_MAX ) {
+         return false;
+      }
+
+      // value 10^scale = numerator / denominator.
+
+      unsigned __int128 numerator = mantissa;
+      unsigned __int128 denominator = 1;
+      int twos = binary;
+
+      if ( scale >= 0 ) {
+
+         numerator *= powerOfFive(scale);
+         twos += scale;
+
+      } else {
+
+         denominator = powerOfFive(-scale);
+         twos += scale;
+      }
+
+      if ( twos >= 0 ) {
+         numerator <<= twos;
+      } else {
+         denominator <<= -twos;
+      }
+
+      unsigned __int128 quotient = numerator / denominator;
+      unsigned __int128 remainder = numerator % denominator;
+
+      // log10 can be a hair off near a power of ten.
+
+      if ( quotient >= 1000000 ) {
+         exponent++;
+         continue;
+      }
+
+      if ( quotient < 100000 ) {
+         exponent--;
+         continue;
+      }
+
+      digits = (int) quotient;
+
+      if ( 2 * remainder > denominator
+            || (2 * remainder == denominator && (digits & 1) != 0) ) {
+         digits++;
+      }
+
+      if ( digits == 1000000 ) {
+         digits = 100000;
+         exponent++;
+      }
+
+      return true;
+   }
+}
+
+// Reproduce ofstream's default double formatting, i.e. "%g" with six
+// significant digits: fixed notation for exponents from -4 to 5, otherwise
+// scientific with at least two exponent digits, and trailing zeros
+// dropped either way.  Nearly every weight and attribute value we write is
+// a small whole number, which "%g" prints exactly as the integer would be,
+// so those go straight to putInt.  Everything else is rounded and laid out
+// here, so the output never depends on the C library's locale; only
+// infinities, NaNs and values too large or small for roundDigits fall back
+// to snprintf.
+
+void outputBuffer::putDouble( double value ) {
+
+   if ( value > -1e6 && value < 1e6 && value == floor(value)
+         && !(value == 0 && signbit(value)) ) {
+
+      putInt( (int) value );
+      return;
+   }
+
+   char text[32];
+   int length = 0;
+   int digits;
+   int exponent;
+
+   if ( value == 0 ) {
+
+      put("-0");
+      return;
+   }
+
+   if ( !isfinite(value) || !roundDigits(fabs(value), digits, exponent) ) {
+
+      length = snprintf(text, sizeof(text), "%g", value);
+      put(text, length);
+      return;
+   }
+
+   char figures[DOUBLE_DIGITS];
+   int count = DOUBLE_DIGITS;
+
+   for ( int i = DOUBLE_DIGITS - 1; i >= 0; i-- ) {
+      figures[i] = '0' + digits % 10;
+      digits /= 10;
+   }
+
+   while ( figures[count - 1] == '0' ) {
+      count--;
+   }
+
+   if ( value < 0 ) {
+      text[length++] = '-';
+   }
+
+   if ( exponent >= DOUBLE_DIGITS || exponent < -4 ) {
+
+      text[length++] = figures[0];
+
+      if ( count > 1 ) {
+
+         text[length++] = '.';
+
+         for ( int i = 1; i < count; i++ ) {
+            text[length++] = figures[i];
+         }
+      }
+
+      int magnitude = ( exponent < 0 ) ? -exponent : exponent;
+
+      text[length++] = 'e';
+      text[length++] = ( exponent < 0 ) ? '-' : '+';
+
+      if ( magnitude >= 100 ) {
+         text[length++] = '0' + magnitude / 100;
+      }
+
+      text[length++] = '0' + (magnitude / 10) % 10;
+      text[length++] = '0' + magnitude % 10;
+
+   } else if ( exponent >= 0 ) {
+
+      for ( int i = 0; i <= exponent; i++ ) {
+         text[length++] = figures[i];
+      }
+
+      if ( count > exponent + 1 ) {
+
+         text[length++] = '.';
+
+         for ( int i = exponent + 1; i < count; i++ ) {
+            text[length++] = figures[i];
+         }
+      }
+
+   } else {
+
+      text[length++] = '0';
+      text[length++] = '.';
+
+      for ( int i = -1; i > exponent; i-- ) {
+         text[length++] = '0';
+      }
+
+      for ( int i = 0; i < count; i++ ) {
+         text[length++] = figures[i];
+      }
+   }
+
+   put(text, length);
+}
+
+// ------------------------
+// Private member functions.
+// ------------------------
+
+void outputBuffer::emitBlock( void ) {
+
+   int length = current - block;
+
+   if ( length > 0 && file != NULL ) {
+
+      if ( background ) {
+
+         // Wait for the writer to finish with the spare block, hand it
+         // this one, and carry on filling the spare.
+
+         pthread_mutex_lock(&lock);
+
+         while ( pending != NULL ) {
+            pthread_cond_wait(&changed, &lock);
+         }
+
+         pending = block;
+         pendingLength = length;
+
+         pthread_cond_broadcast(&changed);
+         pthread_mutex_unlock(&lock);
+
+         char* temp = block;
+         block = spare;
+         spare = temp;
+
+      } else {
+
+         writeBlock(block, length);
+      }
+   }
+
+   blockOffset += length;
+   current = block;
+   blockEnd = block + OUTPUT_BLOCK_SIZE;
+}
+
+void outputBuffer::writeBlock( const char* data, int length ) {
+
+   if ( !compressing ) {
+      fwrite(data, 1, length, file);
+      return;
+   }
+
+   int frameLength = packBlock(data, length, packed);
+
+   fwrite(packed, 1, frameLength, file);
+}
+
+void outputBuffer::waitForWriter( void ) {
+
+   pthread_mutex_lock(&lock);
+
+   while ( pending != NULL ) {
+      pthread_cond_wait(&changed, &lock);
+   }
+
+   pthread_mutex_unlock(&lock);
+}
+
+void outputBuffer::stopBackgroundWriter( void ) {
+
+   if ( !background ) {
+      return;
+   }
+
+   pthread_mutex_lock(&lock);
+   stopping = true;
+   pthread_cond_broadcast(&changed);
+   pthread_mutex_unlock(&lock);
+
+   pthread_join(writerThread, NULL);
+
+   pthread_cond_destroy(&changed);
+   pthread_mutex_destroy(&lock);
+
+   background = false;
+}
+
+// Writer thread: write each block handed over until told to stop.  Any
+// block pending at stop time is still written.
+
+void* outputBuffer::writerMain( void* arg ) {
+
+   outputBuffer* self = (outputBuffer*) arg;
+
+   pthread_mutex_lock(&self->lock);
+
+   while ( true ) {
+
+      while ( self->pending == NULL && !(self->stopping) ) {
+         pthread_cond_wait(&self->changed, &self->lock);
+      }
+
+      if ( self->pending == NULL ) {
+         break;
+      }
+
+      char* data = self->pending;
+      int length = self->pendingLength;
+
+      pthread_mutex_unlock(&self->lock);
+
+      self->writeBlock(data, length);
+
+      pthread_mutex_lock(&self->lock);
+
+      self->pending = NULL;
+      pthread_cond_broadcast(&self->changed);
+   }
+
+   pthread_mutex_unlock(&self->lock);
+
+   return NULL;
+}
@@ -0,0 +1,194 @@
+// outputBuffer.h: Specification for the block-buffered text writer used by
+// multiGraphManager for snapshots and update recording.
+
+#ifndef _OUTPUT_BUFFER_H
+#define _OUTPUT_BUFFER_H
+
+#include <cstdio>
+#include <string>
+#include <pthread.h>
+
+using namespace std;
+
+// Size of each output block.  Output is only ever handed to the operating
+// system in blocks of this size (plus a final partial block on flush).
+
+#define OUTPUT_BLOCK_SIZE (1 << 20)
+
+class outputBuffer {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Create a closed buffer.  Call open() before writing.
+
+      outputBuffer();
+
+      // --------------
+      // Destructor.
+      // --------------
+
+      // Flushes and closes the file if it's still open.
+
+      ~outputBuffer();
+
+      // -----------------
+      // File management.
+      // -----------------
+
+      // Open a file for writing, overwriting any preexisting file with this
+      // name.  Returns false if the file couldn't be opened.
+
+      bool open( const char* filename );
+
+      bool isOpen() const {
+         return file != NULL;
+      }
+
+      // Write out everything buffered so far, wait for the background
+      // writer (if any) to finish, and close the file.
+
+      void close( void );
+
+      // Hand everything buffered so far to the operating system.  If the
+      // background writer is running, block until it has caught up.
+
+      void flush( void );
+
+      // Move file writes onto a separate thread, so the caller only ever
+      // pays for formatting.  Output is double-buffered: the caller fills
+      // one block while the writer thread drains the other.
+
+      void enableBackgroundWriter( void );
+
+      // Compress each block before it's written [see blockCodec.h].  Must
+      // be called before the first block goes out, i.e., right after
+      // open() and a little writing at most.  tell() still counts
+      // uncompressed bytes.  Returns false if it's too late.
+
+      bool enableCompression( void );
+
+      // Total number of bytes appended since open(), i.e. the file offset
+      // at which the next appended byte will land.
+
+      long long tell( void ) const {
+         return blockOffset + (current - block);
+      }
+
+      // ------------------
+      // Append functions.
+      // ------------------
+
+      void put( char c ) {
+
+         if ( current == blockEnd ) {
+            emitBlock();
+         }
+
+         *current++ = c;
+      }
+
+      void put( const char* s );
+      void put( const char* s, int length );
+
+      // Numbers are formatted by hand.  Doubles reproduce ostream's default
+      // formatting ("%g"), byte for byte.
+
+      void putInt( int value );
+      void putLong( long long value );
+      void putDouble( double value );
+
+      // Stream-style shorthand, so call sites read like the ofstream code
+      // they replace.
+
+      outputBuffer& operator<<( char c ) {
+         put(c);
+         return *this;
+      }
+
+      outputBuffer& operator<<( const char* s ) {
+         put(s);
+         return *this;
+      }
+
+      outputBuffer& operator<<( const string& s ) {
+         put(s.data(), s.length());
+         return *this;
+      }
+
+      outputBuffer& operator<<( int value ) {
+         putInt(value);
+         return *this;
+      }
+
+      outputBuffer& operator<<( long long value ) {
+         putLong(value);
+         return *this;
+      }
+
+      outputBuffer& operator<<( double value ) {
+         putDouble(value);
+         return *this;
+      }
+
+   private:
+
+      // Not copyable.
+
+      outputBuffer( const outputBuffer& );
+      outputBuffer& operator=( const outputBuffer& );
+
+      FILE* file;
+
+      // The block currently being filled, and the spare block handed to
+      // the background writer.
+
+      char* block;
+      char* spare;
+      char* current;
+      char* blockEnd;
+
+      // File offset of the first byte in the current block.
+
+      long long blockOffset;
+
+      // Compression state.  'packed' holds the frame being written; only
+      // ever used by whichever thread is doing the writing.
+
+      bool compressing;
+      char* packed;
+
+      // Background writer state.  'pending' is the block waiting to be
+      // written (or NULL), guarded by 'lock'.
+
+      bool background;
+      bool stopping;
+      char* pending;
+      int pendingLength;
+
+      pthread_t writerThread;
+      pthread_mutex_t lock;
+      pthread_cond_t changed;
+
+      // Pass the current block on, either writing it directly or handing
+      // it to the writer thread, and start a fresh one.
+
+      void emitBlock( void );
+
+      // Write a block to the file, compressing it first if need be.
+
+      void writeBlock( const char* data, int length );
+
+      // Wait until the writer thread has no pending block.
+
+      void waitForWriter( void );
+
+      void stopBackgroundWriter( void );
+
+      static void* writerMain( void* arg );
+};
+
+#endif
@@ -0,0 +1,70 @@
+// parallel.h: Small helpers for splitting work across threads.
+//
+// Work is described as a vector of jobs, each a self-contained struct
+// holding its share of the input and room for its results, and a job
+// function taking a pointer to one.  Each job runs on a thread of its
+// own, except the first, which runs on the caller's.
+
+#ifndef _PARALLEL_H
+#define _PARALLEL_H
+
+#include <vector>
+#include <pthread.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Most threads any one piece of work is split across.
+
+#define THREADS_MAX 16
+
+// Number of jobs to split 'work' units into: one per processor, but no
+// more than THREADS_MAX, and none with less than 'minimum' units.
+
+inline int jobCount( long work, long minimum ) {
+
+   long processors = sysconf(_SC_NPROCESSORS_ONLN);
+   long count = ( minimum > 0 ) ? work / minimum : work;
+
+   if ( count > processors ) {
+      count = processors;
+   }
+
+   if ( count > THREADS_MAX ) {
+      count = THREADS_MAX;
+   }
+
+   return ( count < 1 ) ? 1 : (int) count;
+}
+
+// Run jobMain on every job and wait for them all.  If a thread can't be
+// had, its job runs on the caller's thread instead.
+
+template <class job_t>
+void runJobs( vector<job_t>& jobs, void* (*jobMain)( void* ) ) {
+
+   if ( jobs.empty() ) {
+      return;
+   }
+
+   vector<pthread_t> workers( jobs.size() );
+   vector<bool> started( jobs.size(), false );
+
+   for ( unsigned int i = 1; i < jobs.size(); i++ ) {
+      started[i] = ( pthread_create(&workers[i], NULL, jobMain,
+                                    &jobs[i]) == 0 );
+   }
+
+   jobMain( &jobs[0] );
+
+   for ( unsigned int i = 1; i < jobs.size(); i++ ) {
+
+      if ( started[i] ) {
+         pthread_join(workers[i], NULL);
+      } else {
+         jobMain( &jobs[i] );
+      }
+   }
+}
+
+#endif
@@ -0,0 +1,320 @@
+// percolation.cc: Definitions for site and bond percolation on a
+// frozenGraph.
+
+#include "percolation.h"
+#include "parallel.h"
+#include "../rand/randomc.h"
+
+#include <queue>
+#include <functional>
+
+// Binomial weights smaller than this, relative to the largest, are dropped.
+
+#define BINOMIAL_CUTOFF 1e-15
+
+// -------------------
+// Removal orders.
+// -------------------
+
+static void shuffledOrder( int size, unsigned int seed, vector<int>& order ) {
+
+   TRandomMersenne generator(seed);
+
+   order.resize(size);
+
+   for ( int i = 0; i < size; i++ ) {
+      order[i] = i;
+   }
+
+   for ( int i = size - 1; i > 0; i-- ) {
+      swap( order[i], order[ generator.IRandom(0, i) ] );
+   }
+}
+
+// Counting sort by decreasing degree; stable, so ties go by index.
+
+static void degreeOrder( const frozenGraph& frozen, vector<int>& order ) {
+
+   int n = frozen.nodeSize();
+   int maxDegree = 0;
+
+   for ( int i = 0; i < n; i++ ) {
+      maxDegree = max(maxDegree, frozen.degree(i));
+   }
+
+   vector<int> start( maxDegree + 2, 0 );
+
+   for ( int i = 0; i < n; i++ ) {
+      start[ maxDegree - frozen.degree(i) + 1 ]++;
+   }
+
+   for ( int d = 0; d <= maxDegree; d++ ) {
+      start[d + 1] += start[d];
+   }
+
+   order.resize(n);
+
+   for ( int i = 0; i < n; i++ ) {
+      order[ start[ maxDegree - frozen.degree(i) ]++ ] = i;
+   }
+}
+
+// Highest current degree first, from a heap with lazy deletion: a node is
+// pushed again whenever its degree drops, and stale entries are skipped.
+
+static void adaptiveDegreeOrder( const frozenGraph& frozen,
+                                 vector<int>& order ) {
+
+   int n = frozen.nodeSize();
+
+   vector<int> degree( n );
+   vector<bool> removed( n, false );
+
+   // Entries are (degree, -index), so ties pop lowest index first.
+
+   priority_queue< pair<int, int> > heap;
+
+   for ( int i = 0; i < n; i++ ) {
+      degree[i] = frozen.degree(i);
+      heap.push( make_pair(degree[i], -i) );
+   }
+
+   order.clear();
+   order.reserve(n);
+
+   while ( !heap.empty() ) {
+
+      int node = -heap.top().second;
+      int entryDegree = heap.top().first;
+
+      heap.pop();
+
+      if ( removed[node] || entryDegree != degree[node] ) {
+         continue;
+      }
+
+      removed[node] = true;
+      order.push_back(node);
+
+      for ( int j = frozen.offsets[node]; j < frozen.offsets[node + 1];
+            j++ ) {
+
+         int neighbor = frozen.adjacency[j];
+
+         if ( !removed[neighbor] ) {
+            degree[neighbor]--;
+            heap.push( make_pair(degree[neighbor], -neighbor) );
+         }
+      }
+   }
+}
+
+// Each ball is grown only through nodes that are still there, so an
+// earlier ball can cut a later one short.
+
+static void ballOrder( const frozenGraph& frozen, int radius,
+                       vector<int>& order ) {
+
+   int n = frozen.nodeSize();
+
+   vector<int> hubs;
+   vector<bool> removed( n, false );
+   vector<int> level( n, 0 );
+
+   degreeOrder(frozen, hubs);
+
+   order.clear();
+   order.reserve(n);
+
+   for ( int h = 0; h < n; h++ ) {
+
+      if ( removed[ hubs[h] ] ) {
+         continue;
+      }
+
+      // Breadth-first search from the hub, using 'order' as the queue.
+
+      unsigned int next = order.size();
+
+      removed[ hubs[h] ] = true;
+      level[ hubs[h] ] = 0;
+      order.push_back(hubs[h]);
+
+      while ( next < order.size() ) {
+
+         int node = order[next++];
+
+         if ( level[node] == radius ) {
+            continue;
+         }
+
+         for ( int j = frozen.offsets[node]; j < frozen.offsets[node + 1];
+               j++ ) {
+
+            int neighbor = frozen.adjacency[j];
+
+            if ( !removed[neighbor] ) {
+
+               removed[neighbor] = true;
+               level[neighbor] = level[node] + 1;
+               order.push_back(neighbor);
+            }
+         }
+      }
+   }
+}
+
+void removalOrder( const frozenGraph& frozen, removalStrategy strategy,
+                   vector<int>& order, unsigned int seed, int radius ) {
+
+   switch ( strategy ) {
+
+      case REMOVE_RANDOM:
+         shuffledOrder(frozen.nodeSize(), seed, order);
+         break;
+
+      case REMOVE_DEGREE:
+         degreeOrder(frozen, order);
+         break;
+
+      case REMOVE_ADAPTIVE_DEGREE:
+         adaptiveDegreeOrder(frozen, order);
+         break;
+
+      case REMOVE_BALLS:
+         ballOrder(frozen, radius, order);
+         break;
+   }
+}
+
+// -------------
+// Percolation.
+// -------------
+
+// One thread's share of the runs, and its running totals.
+
+typedef struct {
+
+   const frozenGraph* frozen;
+   bool bond;
+   unsigned int seed;
+   int begin;
+   int end;
+
+   vector<double> largest;
+   vector<double> components;
+
+} percolationJob;
+
+static void* percolationMain( void* arg ) {
+
+   percolationJob* job = (percolationJob*) arg;
+
+   const frozenGraph& frozen = *(job->frozen);
+   int size = job->bond ? frozen.edgeSize() : frozen.nodeSize();
+
+   vector<int> order;
+   removalProfile profile;
+
+   job->largest.assign(size + 1, 0.0);
+   job->components.assign(size + 1, 0.0);
+
+   for ( int run = job->begin; run < job->end; run++ ) {
+
+      shuffledOrder(size, job->seed + 2654435761u * (run + 1), order);
+
+      if ( job->bond ) {
+         profileEdgeRemovals(frozen, order, profile);
+      } else {
+         profileRemovals(frozen, order, profile);
+      }
+
+      for ( int k = 0; k <= size; k++ ) {
+         job->largest[k] += profile.largest[k];
+         job->components[k] += profile.componentCount[k];
+      }
+   }
+
+   return NULL;
+}
+
+void randomPercolation( const frozenGraph& frozen, bool bond, int runs,
+                        unsigned int seed, vector<double>& meanLargest,
+                        vector<double>& meanComponents ) {
+
+   int size = bond ? frozen.edgeSize() : frozen.nodeSize();
+
+   meanLargest.assign(size + 1, 0.0);
+   meanComponents.assign(size + 1, 0.0);
+
+   if ( runs < 1 ) {
+      return;
+   }
+
+   vector<percolationJob> jobs( jobCount(runs, 1) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].frozen = &frozen;
+      jobs[i].bond = bond;
+      jobs[i].seed = seed;
+      jobs[i].begin = (long long) runs * i / jobs.size();
+      jobs[i].end = (long long) runs * (i + 1) / jobs.size();
+   }
+
+   runJobs(jobs, percolationMain);
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      for ( int k = 0; k <= size; k++ ) {
+         meanLargest[k] += jobs[i].largest[k];
+         meanComponents[k] += jobs[i].components[k];
+      }
+   }
+
+   for ( int k = 0; k <= size; k++ ) {
+      meanLargest[k] /= runs;
+      meanComponents[k] /= runs;
+   }
+}
+
+double atRemovalProbability( const vector<double>& curve, double q ) {
+
+   int N = curve.size() - 1;
+
+   if ( N <= 0 || q <= 0.0 ) {
+      return curve.empty() ? 0.0 : curve[0];
+   }
+
+   if ( q >= 1.0 ) {
+      return curve[N];
+   }
+
+   // Start from the most likely number of removals, where the binomial
+   // weight is largest, and work outward until the weights die off.
+
+   int mode = (int) (N * q);
+   double odds = q / (1.0 - q);
+
+   double total = 1.0;
+   double sum = curve[mode];
+   double weight = 1.0;
+
+   for ( int k = mode; k < N && weight > BINOMIAL_CUTOFF; k++ ) {
+
+      weight *= odds * (N - k) / (k + 1);
+      total += weight;
+      sum += weight * curve[k + 1];
+   }
+
+   weight = 1.0;
+
+   for ( int k = mode; k > 0 && weight > BINOMIAL_CUTOFF; k-- ) {
+
+      weight *= k / (odds * (N - k + 1));
+      total += weight;
+      sum += weight * curve[k - 1];
+   }
+
+   return sum / total;
+}
@@ -0,0 +1,75 @@
+// percolation.h: Specification for site and bond percolation on a
+// frozenGraph, after Newman and Ziff: instead of rebuilding components at
+// each occupation level, take one removal order and follow the component
+// sizes along it with a union-find [see removalProfile.h], which gives
+// the whole curve in one near-linear pass.
+//
+// Node removal orders model failures and attacks:
+//
+//    REMOVE_RANDOM:          A uniformly random order [random failure].
+//    REMOVE_DEGREE:          Decreasing degree in the original graph.
+//    REMOVE_ADAPTIVE_DEGREE: Repeatedly the node of highest degree in what's
+//                            left, so hubs are reassessed as the graph
+//                            thins out.
+//    REMOVE_BALLS:           Repeatedly the highest-degree node left [by
+//                            original degree] along with everything within
+//                            'radius' hops of it in what's left, as in the
+//                            analyzer's neighborhood experiments.
+//
+// Ties are broken by dense node index.  Bond percolation removes edges in
+// a random order.
+//
+// Random orders are averaged over many runs, split across threads; each
+// run draws from its own Mersenne twister, seeded from the caller's seed
+// and the run number, so results don't depend on the thread count.
+
+#ifndef _PERCOLATION_H
+#define _PERCOLATION_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+#include "removalProfile.h"
+
+using namespace std;
+
+enum removalStrategy {
+
+   REMOVE_RANDOM,
+   REMOVE_DEGREE,
+   REMOVE_ADAPTIVE_DEGREE,
+   REMOVE_BALLS
+};
+
+// -------------------
+// Removal orders.
+// -------------------
+
+// Fill 'order' with every node [dense index] of 'frozen', in the order
+// 'strategy' removes them.  'seed' is used only by REMOVE_RANDOM, 'radius'
+// only by REMOVE_BALLS.
+
+void removalOrder( const frozenGraph& frozen, removalStrategy strategy,
+                   vector<int>& order, unsigned int seed = 0,
+                   int radius = 0 );
+
+// -------------
+// Percolation.
+// -------------
+
+// Mean largest-component size and component count after k random
+// removals, for k = 0 .. nodeSize() [site] or edgeSize() [bond], averaged
+// over 'runs' random orders.
+
+void randomPercolation( const frozenGraph& frozen, bool bond, int runs,
+                        unsigned int seed, vector<double>& meanLargest,
+                        vector<double>& meanComponents );
+
+// Convert a curve indexed by the number of removals k out of N = 'curve'
+// size - 1 into its expected value when each of the N nodes [or edges]
+// is removed independently with probability q.  [Newman and Ziff's
+// convolution with the binomial distribution.]
+
+double atRemovalProbability( const vector<double>& curve, double q );
+
+#endif
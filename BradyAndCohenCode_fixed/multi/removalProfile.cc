@@ -0,0 +1,234 @@
+// removalProfile.cc: Definitions for tracking how a frozenGraph falls
+// apart as its nodes are removed in a given order.
+
+#include "removalProfile.h"
+
+// -------------------
+// Union-find helpers.
+// -------------------
+
+static int findRoot( vector<int>& parent, int x ) {
+
+   while ( parent[x] != x ) {
+
+      parent[x] = parent[ parent[x] ];
+      x = parent[x];
+   }
+
+   return x;
+}
+
+// Merge the components of x and y, smaller under larger.  Returns the size
+// of the merged component, or 0 if x and y were already together.
+
+static int unite( vector<int>& parent, vector<int>& size, int x, int y ) {
+
+   x = findRoot(parent, x);
+   y = findRoot(parent, y);
+
+   if ( x == y ) {
+      return 0;
+   }
+
+   if ( size[x] < size[y] ) {
+      swap(x, y);
+   }
+
+   parent[y] = x;
+   size[x] += size[y];
+
+   return size[x];
+}
+
+// ----------
+// Profiling.
+// ----------
+
+void profileRemovals( const frozenGraph& frozen, const vector<int>& order,
+                      removalProfile& profile ) {
+
+   int n = frozen.nodeSize();
+   int k = order.size();
+
+   vector<int> parent( n );
+   vector<int> size( n, 1 );
+   vector<bool> present( n, true );
+
+   for ( int i = 0; i < n; i++ ) {
+      parent[i] = i;
+   }
+
+   for ( int i = 0; i < k; i++ ) {
+      present[ order[i] ] = false;
+   }
+
+   profile.largest.resize(k + 1);
+   profile.componentCount.resize(k + 1);
+
+   // Build the graph that's left at the end of the order.
+
+   int largest = 0;
+   int count = n - k;
+
+   for ( int i = 0; i < n; i++ ) {
+
+      if ( present[i] ) {
+         largest = 1;
+         break;
+      }
+   }
+
+   for ( int e = 0; e < frozen.edgeSize(); e++ ) {
+
+      int node_1 = frozen.endpoints[2 * e];
+      int node_2 = frozen.endpoints[2 * e + 1];
+
+      if ( present[node_1] && present[node_2] ) {
+
+         int merged = unite(parent, size, node_1, node_2);
+
+         if ( merged > 0 ) {
+            count--;
+            largest = max(largest, merged);
+         }
+      }
+   }
+
+   profile.largest[k] = largest;
+   profile.componentCount[k] = count;
+
+   // Put the removed nodes back, last removed first.
+
+   for ( int i = k - 1; i >= 0; i-- ) {
+
+      int node = order[i];
+
+      present[node] = true;
+      count++;
+      largest = max(largest, 1);
+
+      for ( int j = frozen.offsets[node]; j < frozen.offsets[node + 1];
+            j++ ) {
+
+         int neighbor = frozen.adjacency[j];
+
+         if ( present[neighbor] ) {
+
+            int merged = unite(parent, size, node, neighbor);
+
+            if ( merged > 0 ) {
+               count--;
+               largest = max(largest, merged);
+            }
+         }
+      }
+
+      profile.largest[i] = largest;
+      profile.componentCount[i] = count;
+   }
+}
+
+void profileEdgeRemovals( const frozenGraph& frozen, const vector<int>& order,
+                          removalProfile& profile ) {
+
+   int n = frozen.nodeSize();
+   int m = frozen.edgeSize();
+   int k = order.size();
+
+   vector<int> parent( n );
+   vector<int> size( n, 1 );
+   vector<bool> present( m, true );
+
+   for ( int i = 0; i < n; i++ ) {
+      parent[i] = i;
+   }
+
+   for ( int i = 0; i < k; i++ ) {
+      present[ order[i] ] = false;
+   }
+
+   profile.largest.resize(k + 1);
+   profile.componentCount.resize(k + 1);
+
+   int largest = ( n > 0 ) ? 1 : 0;
+   int count = n;
+
+   // Link the edges that are never removed, then put the others back,
+   // last removed first.
+
+   for ( int i = k; i >= 0; i-- ) {
+
+      int first = ( i == k ) ? 0 : order[i];
+      int last = ( i == k ) ? m : order[i] + 1;
+
+      for ( int e = first; e < last; e++ ) {
+
+         if ( i == k && !present[e] ) {
+            continue;
+         }
+
+         int merged = unite(parent, size, frozen.endpoints[2 * e],
+                            frozen.endpoints[2 * e + 1]);
+
+         if ( merged > 0 ) {
+            count--;
+            largest = max(largest, merged);
+         }
+      }
+
+      profile.largest[i] = largest;
+      profile.componentCount[i] = count;
+   }
+}
+
+// -------------------
+// Removal orderings.
+// -------------------
+
+void nestedBalls( const frozenGraph& frozen, const vector<int>& centers,
+                  int maxRadius, vector<int>& order, vector<int>& ballEnds ) {
+
+   vector<bool> seen( frozen.nodeSize(), false );
+
+   order.clear();
+   ballEnds.clear();
+
+   // A breadth-first search from all the centers at once, one level at a
+   // time; 'order' doubles as the queue.
+
+   for ( unsigned int i = 0; i < centers.size(); i++ ) {
+
+      if ( !seen[ centers[i] ] ) {
+         seen[ centers[i] ] = true;
+         order.push_back(centers[i]);
+      }
+   }
+
+   ballEnds.push_back(order.size());
+
+   unsigned int levelStart = 0;
+
+   for ( int r = 1; r <= maxRadius; r++ ) {
+
+      unsigned int levelEnd = order.size();
+
+      for ( unsigned int i = levelStart; i < levelEnd; i++ ) {
+
+         int node = order[i];
+
+         for ( int j = frozen.offsets[node]; j < frozen.offsets[node + 1];
+               j++ ) {
+
+            int neighbor = frozen.adjacency[j];
+
+            if ( !seen[neighbor] ) {
+               seen[neighbor] = true;
+               order.push_back(neighbor);
+            }
+         }
+      }
+
+      levelStart = levelEnd;
+      ballEnds.push_back(order.size());
+   }
+}
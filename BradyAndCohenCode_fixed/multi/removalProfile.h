@@ -0,0 +1,70 @@
+// removalProfile.h: Specification for tracking how a frozenGraph falls
+// apart as its nodes are removed in a given order.
+//
+// Rather than deleting the nodes one by one and re-indexing components
+// after each deletion, the removals are played backwards: starting from
+// the graph with every listed node gone, the nodes are added back in
+// reverse order, each joined to its neighbors already present with a
+// union-find.  One pass, O((n + m) log* n), gives the component sizes
+// after every prefix of the order.
+//
+// Edges can be removed the same way, for bond rather than site
+// percolation.
+//
+// Removing balls around a set of centers fits this neatly: the ball of
+// radius r is contained in the ball of radius r + 1, so ordering nodes by
+// their distance from the nearest center makes every radius a prefix.
+
+#ifndef _REMOVAL_PROFILE_H
+#define _REMOVAL_PROFILE_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+class removalProfile {
+
+   public:
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Size of the largest component, and number of components, left
+      // after removing the first k nodes of the order, for k = 0 .. the
+      // length of the order.  [Both are 0 once nothing's left.]
+
+      vector<int> largest;
+      vector<int> componentCount;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      int size( void ) const {
+         return largest.size();
+      }
+};
+
+// Profile the removal of the nodes in 'order' [dense indices, no repeats]
+// from 'frozen'.
+
+void profileRemovals( const frozenGraph& frozen, const vector<int>& order,
+                      removalProfile& profile );
+
+// Profile the removal of the edges in 'order' [edge numbers, as in
+// frozen.endpoints, no repeats], leaving every node in place.
+
+void profileEdgeRemovals( const frozenGraph& frozen, const vector<int>& order,
+                          removalProfile& profile );
+
+// List the nodes within 'maxRadius' hops of any of the 'centers' [dense
+// indices], closest first.  ballEnds[r] is the number of nodes within r
+// hops, so order[0 .. ballEnds[r] - 1] is the union of the radius-r balls.
+
+void nestedBalls( const frozenGraph& frozen, const vector<int>& centers,
+                  int maxRadius, vector<int>& order, vector<int>& ballEnds );
+
+#endif
@@ -0,0 +1,409 @@
+// routingQueries.cc: Definitions for routing messages over packed
+// routingTables and measuring the stretch of the routes.
+
+#include "routingQueries.h"
+#include "exactDistances.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+// --------
+// Routing.
+// --------
+
+bool startRoute( const routingTables& tables, int source, int target,
+                 routeHeader& header ) {
+
+   header.target = target;
+   header.landmark = tables.closestLandmark[target];
+   header.rank = ( header.landmark >= 0 ) ?
+                 tables.landmarkRank[header.landmark] : -1;
+   header.position = 0;
+
+   if ( tables.ballIndex(source, target) >= 0 ) {
+
+      header.mode = routeLocal;
+      return true;
+   }
+
+   if ( header.landmark < 0 ) {
+      return false;
+   }
+
+   header.mode = ( header.landmark == source ) ? routeFromLandmark
+                                               : routeToLandmark;
+   return true;
+}
+
+int nextPort( const routingTables& tables, int node, routeHeader& header ) {
+
+   if ( header.mode == routeLocal ) {
+      return tables.tablePort(node, header.target);
+   }
+
+   if ( header.mode == routeToLandmark ) {
+
+      if ( node != header.landmark ) {
+         return tables.landmarkPort(node, header.rank);
+      }
+
+      // At the landmark: start down the address.
+
+      header.mode = routeFromLandmark;
+      header.position = 0;
+   }
+
+   if ( header.position >= tables.addressLength(header.target) ) {
+      return -1;
+   }
+
+   return tables.addressPorts[ tables.addressOffsets[header.target]
+                               + header.position++ ];
+}
+
+int routeHops( const routingTables& tables, int source, int target ) {
+
+   if ( source == target ) {
+      return 0;
+   }
+
+   routeHeader header;
+
+   if ( !startRoute(tables, source, target, header) ) {
+      return -1;
+   }
+
+   int node = source;
+   int hops = 0;
+
+   while ( node != target ) {
+
+      // A route longer than the graph has nodes is going round in circles.
+
+      if ( hops >= tables.nodeSize() ) {
+         return -1;
+      }
+
+      int port = nextPort(tables, node, header);
+
+      if ( port < 0 ) {
+         return -1;
+      }
+
+      node = tables.neighbor(node, port);
+      hops++;
+   }
+
+   return hops;
+}
+
+// One thread's view of a batch of routes.  Threads take ROUTE_BATCH pairs
+// at a time until there are none left.
+
+typedef struct {
+
+   const routingTables* tables;
+   const vector<int>* sources;
+   const vector<int>* targets;
+   vector<int>* hops;
+   int* nextPair;
+
+} routeJob;
+
+static void* routeMain( void* arg ) {
+
+   routeJob* job = (routeJob*) arg;
+
+   int size = job->sources->size();
+
+   while ( true ) {
+
+      int first = __atomic_fetch_add(job->nextPair, ROUTE_BATCH,
+                                     __ATOMIC_RELAXED);
+
+      if ( first >= size ) {
+         break;
+      }
+
+      int last = min(first + ROUTE_BATCH, size);
+
+      for ( int i = first; i < last; i++ ) {
+         (*job->hops)[i] = routeHops(*job->tables, (*job->sources)[i],
+                                     (*job->targets)[i]);
+      }
+   }
+
+   return NULL;
+}
+
+void routePairs( const routingTables& tables, const vector<int>& sources,
+                 const vector<int>& targets, vector<int>& hops ) {
+
+   int nextPair = 0;
+
+   hops.assign(sources.size(), -1);
+
+   vector<routeJob> jobs( jobCount(sources.size(), ROUTE_PAIRS_MIN) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].tables = &tables;
+      jobs[i].sources = &sources;
+      jobs[i].targets = &targets;
+      jobs[i].hops = &hops;
+      jobs[i].nextPair = &nextPair;
+   }
+
+   runJobs(jobs, routeMain);
+}
+
+// --------
+// Stretch.
+// --------
+
+// Running totals of the stretch measurements.
+
+typedef struct {
+
+   long long pairs;
+   long long failures;
+   double sum;
+   double squares;
+   double largest;
+   double hopSum;
+   vector<long long> histogram;
+
+} stretchTotals;
+
+static void clearTotals( stretchTotals& totals ) {
+
+   totals.pairs = totals.failures = 0;
+   totals.sum = totals.squares = totals.largest = totals.hopSum = 0.0;
+   totals.histogram.clear();
+}
+
+// Count a route of 'hops' hops [-1 if it failed] between nodes 'distance'
+// apart.
+
+static void addRoute( stretchTotals& totals, int distance, int hops ) {
+
+   if ( hops < 0 ) {
+
+      totals.failures++;
+      return;
+   }
+
+   double stretch = (double) hops / distance;
+   int bin = ( hops - distance ) * STRETCH_STEPS / distance;
+
+   totals.pairs++;
+   totals.sum += stretch;
+   totals.squares += stretch * stretch;
+   totals.largest = max(totals.largest, stretch);
+   totals.hopSum += hops;
+
+   if ( (int) totals.histogram.size() <= bin ) {
+      totals.histogram.resize( bin + 1, 0 );
+   }
+
+   totals.histogram[bin]++;
+}
+
+// Add 'totals' into 'summary' [cleared beforehand with clearTotals].
+
+static void addTotals( stretchTotals& summary, const stretchTotals& totals ) {
+
+   summary.pairs += totals.pairs;
+   summary.failures += totals.failures;
+   summary.sum += totals.sum;
+   summary.squares += totals.squares;
+   summary.largest = max(summary.largest, totals.largest);
+   summary.hopSum += totals.hopSum;
+
+   if ( summary.histogram.size() < totals.histogram.size() ) {
+      summary.histogram.resize( totals.histogram.size(), 0 );
+   }
+
+   for ( unsigned int k = 0; k < totals.histogram.size(); k++ ) {
+      summary.histogram[k] += totals.histogram[k];
+   }
+}
+
+static void summarize( const stretchTotals& totals, stretchSummary& summary ) {
+
+   long long count = totals.pairs;
+
+   summary.pairs = totals.pairs;
+   summary.failures = totals.failures;
+   summary.largest = totals.largest;
+   summary.histogram = totals.histogram;
+
+   summary.mean = ( count > 0 ) ? totals.sum / count : 0.0;
+   summary.variance = ( count > 1 ) ? (totals.squares
+                                       - totals.sum * summary.mean)
+                                      / (count - 1) : 0.0;
+   summary.meanHops = ( count > 0 ) ? totals.hopSum / count : 0.0;
+}
+
+// Plain breadth-first search from 'source', for sweeps that go too deep.
+
+static void search( const routingTables& tables, int source,
+                    vector<int>& distance ) {
+
+   vector<int> queue;
+
+   distance.assign(tables.nodeSize(), -1);
+   distance[source] = 0;
+   queue.push_back(source);
+
+   for ( unsigned int head = 0; head < queue.size(); head++ ) {
+
+      int v = queue[head];
+
+      for ( int p = 0; p < tables.degree(v); p++ ) {
+
+         int w = tables.neighbor(v, p);
+
+         if ( distance[w] < 0 ) {
+
+            distance[w] = distance[v] + 1;
+            queue.push_back(w);
+         }
+      }
+   }
+}
+
+// One thread's view of the all-pairs measurements.  Threads take the next
+// SWEEP_SOURCES sources until there are none left, find the distances
+// from them to every node with one sweep, and route from each to every
+// node.
+
+typedef struct {
+
+   const frozenGraph* frozen;
+   const routingTables* tables;
+   int* nextSweep;
+
+   stretchTotals totals;
+
+} stretchJob;
+
+static void* stretchMain( void* arg ) {
+
+   stretchJob* job = (stretchJob*) arg;
+   const routingTables& tables = *(job->tables);
+
+   int n = tables.nodeSize();
+   int sweeps = (n + SWEEP_SOURCES - 1) / SWEEP_SOURCES;
+
+   vector<int> sources;
+   vector<int> distance;
+
+   clearTotals(job->totals);
+
+   while ( true ) {
+
+      int k = __atomic_fetch_add(job->nextSweep, 1, __ATOMIC_RELAXED);
+
+      if ( k >= sweeps ) {
+         break;
+      }
+
+      int first = k * SWEEP_SOURCES;
+      int count = min(SWEEP_SOURCES, n - first);
+
+      sources.clear();
+
+      for ( int b = 0; b < count; b++ ) {
+         sources.push_back(first + b);
+      }
+
+      distanceMatrix rows( *job->frozen, sources );
+
+      for ( int b = 0; b < count; b++ ) {
+
+         int s = first + b;
+
+         // Past DISTANCE_MAX the rows have no entries; search instead.
+
+         if ( rows.saturated ) {
+            search(tables, s, distance);
+         }
+
+         for ( int t = 0; t < n; t++ ) {
+
+            int d = rows.saturated ? distance[t] : rows.distance(b, t);
+
+            if ( t == s || d < 0 ) {
+               continue;
+            }
+
+            addRoute( job->totals, d, routeHops(tables, s, t) );
+         }
+      }
+   }
+
+   return NULL;
+}
+
+void measureStretch( const routingTables& tables, const vector<int>& sources,
+                     const vector<int>& targets, const vector<int>& distances,
+                     stretchSummary& summary ) {
+
+   // Route the pairs that can reach each other.
+
+   vector<int> routeSources;
+   vector<int> routeTargets;
+   vector<int> routeDistances;
+   vector<int> hops;
+
+   for ( unsigned int i = 0; i < sources.size(); i++ ) {
+
+      if ( sources[i] != targets[i] && distances[i] > 0 ) {
+
+         routeSources.push_back(sources[i]);
+         routeTargets.push_back(targets[i]);
+         routeDistances.push_back(distances[i]);
+      }
+   }
+
+   routePairs(tables, routeSources, routeTargets, hops);
+
+   stretchTotals totals;
+
+   clearTotals(totals);
+
+   for ( unsigned int i = 0; i < hops.size(); i++ ) {
+      addRoute(totals, routeDistances[i], hops[i]);
+   }
+
+   summarize(totals, summary);
+}
+
+void measureAllStretch( const frozenGraph& frozen, const routingTables& tables,
+                        stretchSummary& summary ) {
+
+   long long n = tables.nodeSize();
+   int nextSweep = 0;
+
+   vector<stretchJob> jobs( jobCount(n * n, ROUTE_PAIRS_MIN) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].frozen = &frozen;
+      jobs[i].tables = &tables;
+      jobs[i].nextSweep = &nextSweep;
+   }
+
+   runJobs(jobs, stretchMain);
+
+   stretchTotals totals;
+
+   clearTotals(totals);
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+      addTotals(totals, jobs[i].totals);
+   }
+
+   summarize(totals, summary);
+}
@@ -0,0 +1,121 @@
+// routingQueries.h: Specification for routing messages over packed
+// routingTables and measuring the stretch of the routes.
+//
+// A message is routed the way RoutingProcedure.sendMessageNoHandshakes
+// routes it.  If the target t is in the source's ball, every node on the
+// way forwards it by its own table entry for t [local].  Otherwise it
+// heads for t's landmark by the landmark entries [toLandmark], and from
+// there follows the ports of t's address down to t [fromLandmark]; if the
+// source is t's landmark it starts on the address straight away.  The
+// header a message carries is a handful of integers, updated in place, so
+// routing allocates nothing.
+//
+// Stretch is the length of the route over the length of a shortest path.
+// The shortest paths come from the 64-source sweeps of exactDistances:
+// pairDistances for a list of pairs, and for all ordered pairs a
+// distanceMatrix per SWEEP_SOURCES sources, with sweeps handed out to
+// threads one at a time and each thread keeping its own totals and
+// histogram, added up at the end.  All ordered pairs of a 20,000-node
+// graph take one pass over the edges per level for every 64 sources, and
+// 20,000 routes per node.
+
+#ifndef _ROUTING_QUERIES_H
+#define _ROUTING_QUERIES_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+#include "routingTables.h"
+
+using namespace std;
+
+// Bins per unit of stretch in the histogram, the fewest pairs worth a
+// thread of their own, and the pairs per batch handed to a thread.
+
+#define STRETCH_STEPS 20
+#define ROUTE_PAIRS_MIN 4096
+#define ROUTE_BATCH 1024
+
+// The ways a message can be travelling, as in the simulator's RouteType.
+
+enum routeMode { routeLocal, routeToLandmark, routeFromLandmark };
+
+typedef struct {
+
+   routeMode mode;
+   int target;
+
+   // Target's landmark and its rank, and the next port of its address to
+   // take.
+
+   int landmark;
+   int rank;
+   int position;
+
+} routeHeader;
+
+class stretchSummary {
+
+   public:
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Pairs measured, and pairs whose route failed [no table entry, or
+      // more hops than there are nodes].  Pairs of a node with itself and
+      // pairs that can't reach each other aren't counted at all.
+
+      long long pairs;
+      long long failures;
+
+      // Mean, sample variance and largest stretch over the pairs measured,
+      // and the mean route length.
+
+      double mean;
+      double variance;
+      double largest;
+      double meanHops;
+
+      // histogram[k] counts the pairs with stretch from 1 + k / STRETCH_STEPS
+      // up to, but not including, 1 + (k + 1) / STRETCH_STEPS.
+
+      vector<long long> histogram;
+};
+
+// Start a header for a message from 'source' to 'target'.  Returns false
+// if the tables don't lead there [the target has no landmark and isn't in
+// the source's ball].
+
+bool startRoute( const routingTables& tables, int source, int target,
+                 routeHeader& header );
+
+// Port at 'node' to forward a message with 'header' on, updating the
+// header, or -1 if the tables have no way on.
+
+int nextPort( const routingTables& tables, int node, routeHeader& header );
+
+// Hops a message from 'source' to 'target' takes, or -1 if it fails.
+
+int routeHops( const routingTables& tables, int source, int target );
+
+// Route every pair (sources[i], targets[i]), in parallel, and set hops[i]
+// to the number of hops taken [-1 for failures].
+
+void routePairs( const routingTables& tables, const vector<int>& sources,
+                 const vector<int>& targets, vector<int>& hops );
+
+// Measure the stretch of the routes between the given pairs, whose
+// distances are as pairDistances gives them [see exactDistances.h].
+
+void measureStretch( const routingTables& tables, const vector<int>& sources,
+                     const vector<int>& targets, const vector<int>& distances,
+                     stretchSummary& summary );
+
+// Measure the stretch of the routes between all ordered pairs of nodes of
+// 'frozen', which the tables were built over.
+
+void measureAllStretch( const frozenGraph& frozen, const routingTables& tables,
+                        stretchSummary& summary );
+
+#endif
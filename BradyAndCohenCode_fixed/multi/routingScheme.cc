@@ -0,0 +1,412 @@
+// routingScheme.cc: Definitions for the routing tables of a compact
+// routing scheme over a frozenGraph.
+
+#include "routingScheme.h"
+#include "ballSearch.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <limits.h>
+
+// -------------
+// Constructors.
+// -------------
+
+routingScheme::routingScheme( const frozenGraph& frozen,
+                              const vector<int>& landmarks ) :
+   landmarks( landmarks ) {
+
+   int n = frozen.nodeSize();
+
+   landmarkRank.assign(n, -1);
+
+   for ( unsigned int i = 0; i < landmarks.size(); i++ ) {
+      landmarkRank[ landmarks[i] ] = i;
+   }
+
+   buildPorts(frozen);
+   buildClosestLandmarks();
+   buildLandmarkPorts();
+   buildAddresses();
+   buildBalls();
+}
+
+// -----------------
+// Helper functions.
+// -----------------
+
+// Number each node's distinct neighbors, other than itself, in order.
+
+void routingScheme::buildPorts( const frozenGraph& frozen ) {
+
+   int n = frozen.nodeSize();
+
+   portOffsets.assign(n + 1, 0);
+   portNeighbors.clear();
+   portNeighbors.reserve( frozen.adjacency.size() );
+
+   for ( int v = 0; v < n; v++ ) {
+
+      int start = portNeighbors.size();
+
+      for ( int j = frozen.offsets[v]; j < frozen.offsets[v + 1]; j++ ) {
+
+         if ( frozen.adjacency[j] != v ) {
+            portNeighbors.push_back(frozen.adjacency[j]);
+         }
+      }
+
+      sort( portNeighbors.begin() + start, portNeighbors.end() );
+      portNeighbors.erase( unique(portNeighbors.begin() + start,
+                                  portNeighbors.end()),
+                           portNeighbors.end() );
+
+      portOffsets[v + 1] = portNeighbors.size();
+   }
+}
+
+// Search from all the landmarks at once.  The queue starts with the
+// landmarks in order, and each node is claimed by the first node to reach
+// it, so every level of the queue stays sorted by landmark; a node is
+// first reached from the first landmark at its least distance, which is
+// the closest landmark RoutingGraphBuilder would pick.
+
+void routingScheme::buildClosestLandmarks( void ) {
+
+   int n = nodeSize();
+
+   closestLandmark.assign(n, -1);
+   landmarkDistance.assign(n, -1);
+   closestPort.assign(n, -1);
+
+   vector<int> queue;
+
+   queue.reserve(n);
+
+   for ( unsigned int i = 0; i < landmarks.size(); i++ ) {
+
+      queue.push_back(landmarks[i]);
+      closestLandmark[ landmarks[i] ] = landmarks[i];
+      landmarkDistance[ landmarks[i] ] = 0;
+   }
+
+   for ( unsigned int head = 0; head < queue.size(); head++ ) {
+
+      int v = queue[head];
+
+      for ( int p = 0; p < degree(v); p++ ) {
+
+         int w = neighbor(v, p);
+
+         if ( landmarkDistance[w] < 0 ) {
+
+            closestLandmark[w] = closestLandmark[v];
+            landmarkDistance[w] = landmarkDistance[v] + 1;
+            closestPort[w] = portTo(w, v);
+            queue.push_back(w);
+         }
+      }
+   }
+}
+
+// One thread's view of the landmark searches.  Threads take the next
+// unsearched landmark until there are none left.
+
+typedef struct {
+
+   routingScheme* scheme;
+   int* nextLandmark;
+
+} landmarkJob;
+
+static void* landmarkMain( void* arg ) {
+
+   landmarkJob* job = (landmarkJob*) arg;
+   routingScheme& scheme = *(job->scheme);
+
+   int n = scheme.nodeSize();
+
+   vector<int> distance( n, -1 );
+   vector<int> queue;
+
+   queue.reserve(n);
+
+   while ( true ) {
+
+      int rank = __atomic_fetch_add(job->nextLandmark, 1, __ATOMIC_RELAXED);
+
+      if ( rank >= (int) scheme.landmarks.size() ) {
+         break;
+      }
+
+      int* ports = &scheme.landmarkPorts[ (long long) rank * n ];
+
+      queue.clear();
+      queue.push_back( scheme.landmarks[rank] );
+      distance[ scheme.landmarks[rank] ] = 0;
+
+      for ( unsigned int head = 0; head < queue.size(); head++ ) {
+
+         int v = queue[head];
+
+         for ( int p = 0; p < scheme.degree(v); p++ ) {
+
+            int w = scheme.neighbor(v, p);
+
+            if ( distance[w] < 0 ) {
+
+               distance[w] = distance[v] + 1;
+               ports[w] = scheme.portTo(w, v);
+               queue.push_back(w);
+            }
+         }
+      }
+
+      for ( unsigned int j = 0; j < queue.size(); j++ ) {
+         distance[ queue[j] ] = -1;
+      }
+   }
+
+   return NULL;
+}
+
+// Search from every landmark, filling in the ports toward it.
+
+void routingScheme::buildLandmarkPorts( void ) {
+
+   int n = nodeSize();
+
+   landmarkPorts.assign( (long long) landmarks.size() * n, -1 );
+
+   int nextLandmark = 0;
+
+   vector<landmarkJob> jobs( jobCount(landmarks.size(), 1) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].scheme = this;
+      jobs[i].nextLandmark = &nextLandmark;
+   }
+
+   runJobs(jobs, landmarkMain);
+}
+
+// Follow each node's closest ports up to its landmark, and record the way
+// back down.
+
+void routingScheme::buildAddresses( void ) {
+
+   int n = nodeSize();
+
+   addressOffsets.assign(n + 1, 0);
+   addressPorts.clear();
+
+   for ( int v = 0; v < n; v++ ) {
+
+      int start = addressPorts.size();
+
+      if ( closestLandmark[v] >= 0 ) {
+
+         for ( int x = v; x != closestLandmark[v]; ) {
+
+            int next = neighbor(x, closestPort[x]);
+
+            addressPorts.push_back( portTo(next, x) );
+            x = next;
+         }
+
+         reverse( addressPorts.begin() + start, addressPorts.end() );
+      }
+
+      addressOffsets[v + 1] = addressPorts.size();
+   }
+}
+
+// One thread's view of the ball searches.  Threads take batches of
+// BALL_BATCH nodes from 'nextNode' until there are none left, since ball
+// sizes vary wildly on heavy-tailed graphs, and search each with a
+// ballSearch of their own over the port lists, so the first hop it keeps
+// for a node is the port toward it.  Each ball found is appended to
+// 'nodes', 'ports' and 'distances', sorted by node, and 'segments' records
+// where each node's ball starts.
+
+typedef struct {
+
+   const routingScheme* scheme;
+   int* nextNode;
+
+   vector<int> nodes;
+   vector<int> ports;
+   vector<int> distances;
+   vector< pair<int, int> > segments;
+
+} ballJob;
+
+static void* ballMain( void* arg ) {
+
+   ballJob* job = (ballJob*) arg;
+   const routingScheme& scheme = *(job->scheme);
+
+   int n = scheme.nodeSize();
+
+   ballSearch search( scheme.portOffsets, scheme.portNeighbors );
+
+   vector<int> found;
+   vector< pair<int, int> > ball;
+
+   job->nodes.clear();
+   job->ports.clear();
+   job->distances.clear();
+   job->segments.clear();
+
+   while ( true ) {
+
+      int first = __atomic_fetch_add(job->nextNode, BALL_BATCH,
+                                     __ATOMIC_RELAXED);
+
+      if ( first >= n ) {
+         break;
+      }
+
+      int last = min(first + BALL_BATCH, n);
+
+      for ( int v = first; v < last; v++ ) {
+
+         int radius = ( scheme.landmarkDistance[v] >= 0 ) ?
+                      scheme.landmarkDistance[v] - 1 : INT_MAX;
+
+         search.find(v, radius, found);
+
+         // The center comes first; the ball is everything after it.
+
+         ball.clear();
+
+         for ( unsigned int j = 1; j < found.size(); j++ ) {
+            ball.push_back( make_pair(found[j], search.firstHop(found[j])) );
+         }
+
+         sort( ball.begin(), ball.end() );
+
+         job->segments.push_back( make_pair(v, (int) job->nodes.size()) );
+
+         for ( unsigned int j = 0; j < ball.size(); j++ ) {
+            job->nodes.push_back(ball[j].first);
+            job->ports.push_back(ball[j].second);
+            job->distances.push_back( search.distance(ball[j].first) );
+         }
+      }
+   }
+
+   return NULL;
+}
+
+// Search out from each node as far as its ball reaches, in parallel, then
+// gather the balls in node order.
+
+void routingScheme::buildBalls( void ) {
+
+   int n = nodeSize();
+   int nextNode = 0;
+
+   vector<ballJob> jobs( jobCount(n, BALL_BATCH) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].scheme = this;
+      jobs[i].nextNode = &nextNode;
+   }
+
+   runJobs(jobs, ballMain);
+
+   ballOffsets.assign(n + 1, 0);
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      vector< pair<int, int> >& segments = jobs[i].segments;
+
+      for ( unsigned int j = 0; j < segments.size(); j++ ) {
+
+         int end = ( j + 1 < segments.size() ) ? segments[j + 1].second
+                                               : jobs[i].nodes.size();
+
+         ballOffsets[ segments[j].first + 1 ] = end - segments[j].second;
+      }
+   }
+
+   for ( int v = 0; v < n; v++ ) {
+      ballOffsets[v + 1] += ballOffsets[v];
+   }
+
+   ballNodes.resize( ballOffsets[n] );
+   ballPorts.resize( ballOffsets[n] );
+   ballDistances.resize( ballOffsets[n] );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      vector< pair<int, int> >& segments = jobs[i].segments;
+
+      for ( unsigned int j = 0; j < segments.size(); j++ ) {
+
+         int v = segments[j].first;
+
+         copy( jobs[i].nodes.begin() + segments[j].second,
+               jobs[i].nodes.begin() + segments[j].second + ballSize(v),
+               ballNodes.begin() + ballOffsets[v] );
+         copy( jobs[i].ports.begin() + segments[j].second,
+               jobs[i].ports.begin() + segments[j].second + ballSize(v),
+               ballPorts.begin() + ballOffsets[v] );
+         copy( jobs[i].distances.begin() + segments[j].second,
+               jobs[i].distances.begin() + segments[j].second + ballSize(v),
+               ballDistances.begin() + ballOffsets[v] );
+      }
+
+      vector<int>().swap( jobs[i].nodes );
+      vector<int>().swap( jobs[i].ports );
+      vector<int>().swap( jobs[i].distances );
+   }
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+int routingScheme::portTo( int node, int next ) const {
+
+   vector<int>::const_iterator first = portNeighbors.begin() + portOffsets[node];
+   vector<int>::const_iterator last = portNeighbors.begin() + portOffsets[node + 1];
+   vector<int>::const_iterator found = lower_bound(first, last, next);
+
+   return ( found != last && *found == next ) ? found - first : -1;
+}
+
+int routingScheme::tablePort( int node, int target ) const {
+
+   if ( landmarkRank[target] >= 0 ) {
+      return landmarkPorts[ (long long) landmarkRank[target] * nodeSize()
+                            + node ];
+   }
+
+   vector<int>::const_iterator first = ballNodes.begin() + ballOffsets[node];
+   vector<int>::const_iterator last = ballNodes.begin() + ballOffsets[node + 1];
+   vector<int>::const_iterator found = lower_bound(first, last, target);
+
+   if ( found == last || *found != target ) {
+      return -1;
+   }
+
+   return ballPorts[ found - ballNodes.begin() ];
+}
+
+int routingScheme::tableSize( int node ) const {
+
+   int size = ballSize(node);
+
+   for ( unsigned int i = 0; i < landmarks.size(); i++ ) {
+
+      if ( landmarkPorts[ (long long) i * nodeSize() + node ] >= 0 ) {
+         size++;
+      }
+   }
+
+   return size;
+}
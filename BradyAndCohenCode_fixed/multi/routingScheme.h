@@ -0,0 +1,156 @@
+// routingScheme.h: Specification for the routing tables of a compact
+// routing scheme over a frozenGraph, with the same semantics as the
+// simulator's RoutingGraphBuilder.
+//
+// A set of landmarks [the core] is given.  Every node keeps
+//
+//    - its closest landmark l(v) and the distance to it, ties going to the
+//      landmark that comes first in the list;
+//    - the port toward every landmark it can reach;
+//    - its ball: every other node u with d(v, u) < d(v, l(v)) [every node
+//      it can reach, if it can't reach a landmark], and the port toward
+//      each; and
+//    - its address: l(v) and the ports along a shortest path from l(v)
+//      down to v.
+//
+// A node's ports number its distinct neighbors other than itself, in
+// increasing order of dense index, from 0.  [The simulator numbers them
+// in order of edge creation; sorting makes them independent of how the
+// graph was loaded.]
+//
+// Closest landmarks come from a single breadth-first search started from
+// every landmark at once, which also leaves each node a port toward its
+// own landmark to build addresses from.  The ports toward each landmark
+// come from one search per landmark, split across threads.  Each ball
+// comes from a ballSearch over the port lists truncated at d(v, l(v)) - 1,
+// which reaches exactly the ball and costs time in proportion to it, and
+// keeps the port toward each node found.  Ball sizes are very uneven on
+// heavy-tailed graphs, so threads take nodes in small batches as they
+// finish the last.
+
+#ifndef _ROUTING_SCHEME_H
+#define _ROUTING_SCHEME_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+// Nodes per batch of ball searches handed to a thread.
+
+#define BALL_BATCH 64
+
+class routingScheme {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Build the tables for 'frozen' with the given landmarks [dense
+      // indices, without repeats].
+
+      routingScheme( const frozenGraph& frozen, const vector<int>& landmarks );
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Port p of node v leads to portNeighbors[portOffsets[v] + p].
+
+      vector<int> portOffsets;
+      vector<int> portNeighbors;
+
+      // The landmarks, and each node's position among them [-1 for the
+      // rest].
+
+      vector<int> landmarks;
+      vector<int> landmarkRank;
+
+      // Each node's closest landmark and the distance to it, both -1 if it
+      // can't reach one.
+
+      vector<int> closestLandmark;
+      vector<int> landmarkDistance;
+
+      // Port at each node toward its closest landmark, along the shortest
+      // path its address follows [-1 for landmarks and nodes that can't
+      // reach one].
+
+      vector<int> closestPort;
+
+      // Port at node v toward landmark i is landmarkPorts[i * n + v], or -1
+      // if v is that landmark or can't reach it.
+
+      vector<int> landmarkPorts;
+
+      // The ball of node v is ballNodes[ballOffsets[v] .. ballOffsets[v + 1]
+      // - 1], in increasing order; ballPorts gives the port at v toward
+      // each, and ballDistances the distance from v.
+
+      vector<int> ballOffsets;
+      vector<int> ballNodes;
+      vector<int> ballPorts;
+      vector<int> ballDistances;
+
+      // The address of node v: the ports along a shortest path from
+      // closestLandmark[v] to v are addressPorts[addressOffsets[v] ..
+      // addressOffsets[v + 1] - 1], the landmark's first.
+
+      vector<int> addressOffsets;
+      vector<int> addressPorts;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      int nodeSize( void ) const {
+         return landmarkRank.size();
+      }
+
+      int degree( int node ) const {
+         return portOffsets[node + 1] - portOffsets[node];
+      }
+
+      int neighbor( int node, int port ) const {
+         return portNeighbors[ portOffsets[node] + port ];
+      }
+
+      int ballSize( int node ) const {
+         return ballOffsets[node + 1] - ballOffsets[node];
+      }
+
+      int addressLength( int node ) const {
+         return addressOffsets[node + 1] - addressOffsets[node];
+      }
+
+      // Port at 'node' leading to 'next', or -1 if they aren't neighbors.
+
+      int portTo( int node, int next ) const;
+
+      // Port at 'node' on the way to 'target' according to its table, or
+      // -1 if the table has no entry for it.
+
+      int tablePort( int node, int target ) const;
+
+      // Number of entries in a node's table: one for each landmark it can
+      // reach other than itself, and one for each node in its ball.
+
+      int tableSize( int node ) const;
+
+   private:
+
+      // -----------------
+      // Helper functions.
+      // -----------------
+
+      void buildPorts( const frozenGraph& frozen );
+      void buildClosestLandmarks( void );
+      void buildLandmarkPorts( void );
+      void buildAddresses( void );
+      void buildBalls( void );
+};
+
+#endif
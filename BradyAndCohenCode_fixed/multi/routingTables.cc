@@ -0,0 +1,234 @@
+// routingTables.cc: Definitions for compact storage of the routing tables
+// built by a routingScheme.
+
+#include "routingTables.h"
+
+#include <algorithm>
+
+// -----------------
+// Helper functions.
+// -----------------
+
+// Fewest bits that can tell 'count' values apart.
+
+static int bitsFor( int count ) {
+
+   int width = 0;
+
+   while ( (1LL << width) < count ) {
+      width++;
+   }
+
+   return width;
+}
+
+// Write the low 'width' bits of 'value' at bit 'position' of 'words', which
+// must still be clear there.
+
+static void writeBits( vector<unsigned long long>& words, long long position,
+                       int width, unsigned long long value ) {
+
+   if ( width == 0 ) {
+      return;
+   }
+
+   long long word = position >> 6;
+   int shift = position & 63;
+
+   words[word] |= value << shift;
+
+   if ( shift + width > 64 ) {
+      words[word + 1] |= value >> (64 - shift);
+   }
+}
+
+static int readBits( const vector<unsigned long long>& words,
+                     long long position, int width ) {
+
+   if ( width == 0 ) {
+      return 0;
+   }
+
+   long long word = position >> 6;
+   int shift = position & 63;
+
+   unsigned long long value = words[word] >> shift;
+
+   if ( shift + width > 64 ) {
+      value |= words[word + 1] << (64 - shift);
+   }
+
+   return (int) ( value & ((1ULL << width) - 1) );
+}
+
+// -------------
+// Constructors.
+// -------------
+
+routingTables::routingTables( const routingScheme& scheme ) :
+   portOffsets( scheme.portOffsets ),
+   portNeighbors( scheme.portNeighbors ),
+   landmarks( scheme.landmarks ),
+   landmarkRank( scheme.landmarkRank ),
+   closestLandmark( scheme.closestLandmark ),
+   addressOffsets( scheme.addressOffsets ),
+   addressPorts( scheme.addressPorts ),
+   ballOffsets( scheme.ballOffsets ),
+   ballTargets( scheme.ballNodes ) {
+
+   int n = nodeSize();
+   int L = landmarkSize();
+
+   portWidth.resize(n);
+   columnWidth.resize(n);
+   blockOffsets.assign(n + 1, 0);
+
+   // Lay out the blocks, each starting on a byte.
+
+   for ( int v = 0; v < n; v++ ) {
+
+      portWidth[v] = bitsFor( degree(v) );
+      columnWidth[v] = bitsFor( degree(v) + 1 );
+
+      long long length = (long long) ballSize(v) * portWidth[v]
+                         + (long long) L * columnWidth[v];
+
+      blockOffsets[v + 1] = blockOffsets[v] + (length + 7) / 8 * 8;
+   }
+
+   bits.assign( (blockOffsets[n] + 63) / 64, 0 );
+
+   // Fill them in.
+
+   for ( int v = 0; v < n; v++ ) {
+
+      long long position = blockOffsets[v];
+
+      for ( int j = ballOffsets[v]; j < ballOffsets[v + 1]; j++ ) {
+
+         writeBits(bits, position, portWidth[v], scheme.ballPorts[j]);
+         position += portWidth[v];
+      }
+
+      unsigned long long none = (1ULL << columnWidth[v]) - 1;
+
+      for ( int i = 0; i < L; i++ ) {
+
+         int port = scheme.landmarkPorts[ (long long) i * n + v ];
+
+         writeBits(bits, position, columnWidth[v],
+                   ( port >= 0 ) ? (unsigned long long) port : none);
+         position += columnWidth[v];
+      }
+   }
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+int routingTables::ballIndex( int node, int target ) const {
+
+   vector<int>::const_iterator first = ballTargets.begin() + ballOffsets[node];
+   vector<int>::const_iterator last = ballTargets.begin() + ballOffsets[node + 1];
+   vector<int>::const_iterator found = lower_bound(first, last, target);
+
+   return ( found != last && *found == target ) ? found - first : -1;
+}
+
+int routingTables::ballPort( int node, int j ) const {
+   return readBits(bits, blockOffsets[node] + (long long) j * portWidth[node],
+                   portWidth[node]);
+}
+
+int routingTables::landmarkPort( int node, int rank ) const {
+
+   long long position = blockOffsets[node]
+                        + (long long) ballSize(node) * portWidth[node]
+                        + (long long) rank * columnWidth[node];
+
+   int port = readBits(bits, position, columnWidth[node]);
+
+   return ( port < degree(node) ) ? port : -1;
+}
+
+int routingTables::tablePort( int node, int target ) const {
+
+   if ( landmarkRank[target] >= 0 ) {
+      return landmarkPort(node, landmarkRank[target]);
+   }
+
+   int j = ballIndex(node, target);
+
+   return ( j >= 0 ) ? ballPort(node, j) : -1;
+}
+
+int routingTables::tableSize( int node ) const {
+
+   int size = ballSize(node);
+
+   for ( int i = 0; i < landmarkSize(); i++ ) {
+
+      if ( landmarkPort(node, i) >= 0 ) {
+         size++;
+      }
+   }
+
+   return size;
+}
+
+long long routingTables::nodeBytes( int node ) const {
+   return 4LL * ballSize(node)
+          + (blockOffsets[node + 1] - blockOffsets[node]) / 8;
+}
+
+long long routingTables::arenaBytes( void ) const {
+   return 4LL * ballTargets.size()
+          + 8LL * bits.size()
+          + (long long) sizeof(int) * ballOffsets.size()
+          + (long long) sizeof(long long) * blockOffsets.size()
+          + portWidth.size()
+          + columnWidth.size();
+}
+
+void routingTables::byteStats( double& mean, double& variance,
+                               long long& largest ) const {
+
+   int n = nodeSize();
+   double sum = 0.0;
+   double squares = 0.0;
+
+   largest = 0;
+
+   for ( int v = 0; v < n; v++ ) {
+
+      long long bytes = nodeBytes(v);
+
+      sum += bytes;
+      squares += (double) bytes * bytes;
+      largest = max(largest, bytes);
+   }
+
+   mean = ( n > 0 ) ? sum / n : 0.0;
+   variance = ( n > 1 ) ? (squares - sum * mean) / (n - 1) : 0.0;
+}
+
+void routingTables::byteHistogram( vector<int>& histogram ) const {
+
+   histogram.clear();
+
+   for ( int v = 0; v < nodeSize(); v++ ) {
+
+      int bin = 0;
+
+      for ( long long bytes = nodeBytes(v); bytes > 0; bytes >>= 1 ) {
+         bin++;
+      }
+
+      if ( (int) histogram.size() <= bin ) {
+         histogram.resize( bin + 1, 0 );
+      }
+
+      histogram[bin]++;
+   }
+}
@@ -0,0 +1,158 @@
+// routingTables.h: Specification for compact storage of the routing
+// tables built by a routingScheme, with an exact account of their size.
+//
+// The simulator keeps each table as a hash map from target to port, plus
+// a full path per landmark, which says little about how small the tables
+// of a compact routing scheme really are.  Here every table lives in one
+// arena:
+//
+//    - the targets of each node's ball, as sorted 32-bit node indices, all
+//      in one array;
+//    - the ports toward them, bit-packed at ceil(log2(deg)) bits each,
+//      where deg is the node's degree [a node with one neighbor needs no
+//      bits at all]; and
+//    - the ports toward the landmarks, in a matrix with one column per
+//      node and one row per landmark, stored column by column so each
+//      node's landmark entries sit together.  Each entry takes
+//      ceil(log2(deg + 1)) bits, the value with every bit set meaning no
+//      entry [the node is that landmark, or can't reach it].
+//
+// A node's packed ports and landmark column share one block of bits,
+// starting on a byte boundary, so the bytes a node's table takes are
+// exactly four per ball target plus the bytes of its block.
+//
+// The ports of each node and the addresses are kept alongside, unpacked,
+// so the tables can be routed over once the routingScheme is gone; they
+// belong to the graph and the labels rather than the tables, and aren't
+// counted.
+
+#ifndef _ROUTING_TABLES_H
+#define _ROUTING_TABLES_H
+
+#include <vector>
+
+#include "routingScheme.h"
+
+using namespace std;
+
+class routingTables {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Pack the tables of 'scheme'.
+
+      routingTables( const routingScheme& scheme );
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Port p of node v leads to portNeighbors[portOffsets[v] + p].
+
+      vector<int> portOffsets;
+      vector<int> portNeighbors;
+
+      // The landmarks, and each node's position among them [-1 for the
+      // rest].
+
+      vector<int> landmarks;
+      vector<int> landmarkRank;
+
+      // Each node's address: its closest landmark [-1 if it can't reach
+      // one] and the ports from there down to it, as in routingScheme.
+
+      vector<int> closestLandmark;
+      vector<int> addressOffsets;
+      vector<int> addressPorts;
+
+      // The ball of node v is ballTargets[ballOffsets[v] .. ballOffsets[v +
+      // 1] - 1], in increasing order.
+
+      vector<int> ballOffsets;
+      vector<int> ballTargets;
+
+      // Bits per ball port and per landmark entry at each node.
+
+      vector<unsigned char> portWidth;
+      vector<unsigned char> columnWidth;
+
+      // Node v's block starts at bit blockOffsets[v] of 'bits': its ball
+      // ports in order, then its landmark column.
+
+      vector<long long> blockOffsets;
+      vector<unsigned long long> bits;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      int nodeSize( void ) const {
+         return landmarkRank.size();
+      }
+
+      int landmarkSize( void ) const {
+         return landmarks.size();
+      }
+
+      int degree( int node ) const {
+         return portOffsets[node + 1] - portOffsets[node];
+      }
+
+      int neighbor( int node, int port ) const {
+         return portNeighbors[ portOffsets[node] + port ];
+      }
+
+      int ballSize( int node ) const {
+         return ballOffsets[node + 1] - ballOffsets[node];
+      }
+
+      int addressLength( int node ) const {
+         return addressOffsets[node + 1] - addressOffsets[node];
+      }
+
+      // Position of 'target' in the ball of 'node', or -1 if it isn't
+      // there.
+
+      int ballIndex( int node, int target ) const;
+
+      // Port at 'node' toward the j-th target of its ball.
+
+      int ballPort( int node, int j ) const;
+
+      // Port at 'node' toward the landmark of the given rank, or -1 if it
+      // has no entry for it.
+
+      int landmarkPort( int node, int rank ) const;
+
+      // Port at 'node' on the way to 'target' according to its table, or
+      // -1 if the table has no entry for it.
+
+      int tablePort( int node, int target ) const;
+
+      // Number of entries in a node's table.
+
+      int tableSize( int node ) const;
+
+      // Bytes a node's table takes in the arena.
+
+      long long nodeBytes( int node ) const;
+
+      // Bytes the whole arena takes, offsets and widths included.
+
+      long long arenaBytes( void ) const;
+
+      // Mean, sample variance and largest of the bytes per node.
+
+      void byteStats( double& mean, double& variance, long long& largest ) const;
+
+      // Number of nodes whose tables take 0 bytes in histogram[0], and
+      // between 2^(k - 1) and 2^k - 1 bytes in histogram[k].
+
+      void byteHistogram( vector<int>& histogram ) const;
+};
+
+#endif
@@ -0,0 +1,43 @@
+// sourceSweep.cc: Definitions for breadth-first searches from up to 64
+// sources of a frozenGraph at once.
+
+#include "sourceSweep.h"
+
+// -------------
+// Constructors.
+// -------------
+
+sourceSweep::sourceSweep( const frozenGraph& frozen ) :
+   level(0),
+   frozen(frozen),
+   everySource(0),
+   seen( frozen.nodeSize(), 0 ),
+   frontier( frozen.nodeSize(), 0 ),
+   nextFrontier( frozen.nodeSize(), 0 ) {
+
+}
+
+// -------------------
+// Mutator functions.
+// -------------------
+
+void sourceSweep::start( const int* sources, int count ) {
+
+   everySource = ( count == SWEEP_SOURCES ) ? ~0ULL : (1ULL << count) - 1;
+
+   seen.assign(seen.size(), 0);
+   frontier.assign(frontier.size(), 0);
+
+   for ( int b = 0; b < count; b++ ) {
+      seen[ sources[b] ] |= 1ULL << b;
+      frontier[ sources[b] ] |= 1ULL << b;
+   }
+
+   level = 1;
+}
+
+void sourceSweep::nextLevel( void ) {
+
+   frontier.swap(nextFrontier);
+   level++;
+}
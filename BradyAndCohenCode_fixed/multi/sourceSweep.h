@@ -0,0 +1,133 @@
+// sourceSweep.h: Specification for breadth-first searches from up to 64
+// sources of a frozenGraph at once, a level at a time.
+//
+// Each source gets one bit of a machine word.  Bit b of a node's 'seen'
+// word is set once source b has reached it, and of its 'frontier' word if
+// that happened at the last level; at each level every node ORs together
+// its neighbors' frontier words and keeps the bits it hadn't seen, so one
+// pass over the edges advances all the searches.
+//
+// The sweep itself only keeps the words.  What the searches are for is up
+// to a visitor, which is handed each node reached at a level along with
+// the bits of the sources that just reached it: hopDistances counts them,
+// and exactDistances writes them into rows of distances.  A level can be
+// advanced over disjoint ranges of nodes by different threads at once,
+// each with a visitor of its own; the next level starts only once they
+// have all finished.
+//
+// A sourceSweep isn't otherwise safe to share between threads; give each
+// thread its own.
+
+#ifndef _SOURCE_SWEEP_H
+#define _SOURCE_SWEEP_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+// Sources per sweep [bits in a word].
+
+#define SWEEP_SOURCES 64
+
+class sourceSweep {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      sourceSweep( const frozenGraph& frozen );
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Distance of the nodes the next advance finds from the sources that
+      // reach them [1 after start].
+
+      int level;
+
+      // -------------------
+      // Mutator functions.
+      // -------------------
+
+      // Start searching from sources[0 .. count - 1], count <=
+      // SWEEP_SOURCES; bit b stands for sources[b].
+
+      void start( const int* sources, int count );
+
+      // Find which of the nodes [begin, end) the sources reach at this
+      // level, calling visitor(node, bits) for each with the bits of the
+      // sources that reach it.  Returns whether any were reached.
+
+      template <class visitor_t>
+      bool advance( int begin, int end, visitor_t& visitor );
+
+      // Move on to the next level, once every range has been advanced.
+
+      void nextLevel( void );
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      int nodeSize( void ) const {
+         return seen.size();
+      }
+
+   private:
+
+      // ---------------------
+      // Private data members.
+      // ---------------------
+
+      const frozenGraph& frozen;
+
+      unsigned long long everySource;
+
+      vector<unsigned long long> seen;
+      vector<unsigned long long> frontier;
+      vector<unsigned long long> nextFrontier;
+};
+
+template <class visitor_t>
+bool sourceSweep::advance( int begin, int end, visitor_t& visitor ) {
+
+   bool reached = false;
+
+   for ( int u = begin; u < end; u++ ) {
+
+      nextFrontier[u] = 0;
+
+      // Nothing more can reach a node every source has.
+
+      if ( seen[u] == everySource ) {
+         continue;
+      }
+
+      unsigned long long reach = 0;
+
+      for ( int j = frozen.offsets[u]; j < frozen.offsets[u + 1]; j++ ) {
+         reach |= frontier[ frozen.adjacency[j] ];
+      }
+
+      reach &= ~seen[u];
+
+      if ( reach == 0 ) {
+         continue;
+      }
+
+      seen[u] |= reach;
+      nextFrontier[u] = reach;
+      reached = true;
+
+      visitor(u, reach);
+   }
+
+   return reached;
+}
+
+#endif
@@ -0,0 +1,212 @@
+// thorupZwick.cc: Definitions for choosing landmarks by Thorup and Zwick's
+// sampling.
+
+#include "thorupZwick.h"
+#include "ballSearch.h"
+#include "parallel.h"
+#include "../rand/randomc.h"
+
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
+
+// ----------------
+// Cluster sizes.
+// ----------------
+
+// One thread's view of the cluster searches.  Threads take batches of
+// CLUSTER_BATCH nodes from 'nextNode' until there are none left, and
+// search from each with a ballSearch of their own, no further than one
+// short of its distance to the centers, counting every node reached.
+
+typedef struct {
+
+   const frozenGraph* frozen;
+   const vector<int>* centerDistance;
+   int* nextNode;
+
+   vector<int> counts;
+
+} clusterJob;
+
+static void* clusterMain( void* arg ) {
+
+   clusterJob* job = (clusterJob*) arg;
+   const frozenGraph& frozen = *(job->frozen);
+   const vector<int>& centerDistance = *(job->centerDistance);
+
+   int n = frozen.nodeSize();
+
+   ballSearch search( frozen );
+
+   vector<int> ball;
+
+   job->counts.assign(n, 0);
+
+   while ( true ) {
+
+      int first = __atomic_fetch_add(job->nextNode, CLUSTER_BATCH,
+                                     __ATOMIC_RELAXED);
+
+      if ( first >= n ) {
+         break;
+      }
+
+      int last = min(first + CLUSTER_BATCH, n);
+
+      for ( int v = first; v < last; v++ ) {
+
+         // A center is in no cluster.
+
+         if ( centerDistance[v] == 0 ) {
+            continue;
+         }
+
+         int radius = ( centerDistance[v] > 0 ) ? centerDistance[v] - 1
+                                                : INT_MAX;
+
+         search.find(v, radius, ball);
+
+         for ( unsigned int j = 0; j < ball.size(); j++ ) {
+            job->counts[ ball[j] ]++;
+         }
+      }
+   }
+
+   return NULL;
+}
+
+void clusterSizes( const frozenGraph& frozen, const vector<int>& centers,
+                   vector<int>& sizes ) {
+
+   int n = frozen.nodeSize();
+
+   // Distance from every node to the nearest center, by one search from
+   // them all.
+
+   vector<int> centerDistance( n, -1 );
+   vector<int> queue;
+
+   for ( unsigned int i = 0; i < centers.size(); i++ ) {
+
+      if ( centerDistance[ centers[i] ] < 0 ) {
+
+         centerDistance[ centers[i] ] = 0;
+         queue.push_back(centers[i]);
+      }
+   }
+
+   for ( unsigned int head = 0; head < queue.size(); head++ ) {
+
+      int v = queue[head];
+
+      for ( int j = frozen.offsets[v]; j < frozen.offsets[v + 1]; j++ ) {
+
+         int w = frozen.adjacency[j];
+
+         if ( centerDistance[w] < 0 ) {
+
+            centerDistance[w] = centerDistance[v] + 1;
+            queue.push_back(w);
+         }
+      }
+   }
+
+   // Search from every node, and add up the threads' counts.
+
+   int nextNode = 0;
+
+   vector<clusterJob> jobs( jobCount(n, CLUSTER_BATCH) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].frozen = &frozen;
+      jobs[i].centerDistance = &centerDistance;
+      jobs[i].nextNode = &nextNode;
+   }
+
+   runJobs(jobs, clusterMain);
+
+   sizes.assign(n, 0);
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      for ( int w = 0; w < n; w++ ) {
+         sizes[w] += jobs[i].counts[w];
+      }
+
+      vector<int>().swap( jobs[i].counts );
+   }
+}
+
+// ---------
+// Sampling.
+// ---------
+
+void thorupZwickCore( const frozenGraph& frozen, unsigned int seed,
+                      vector<int>& core, vector<int>* rounds ) {
+
+   int n = frozen.nodeSize();
+
+   core.clear();
+
+   if ( rounds != NULL ) {
+      rounds->clear();
+   }
+
+   if ( n == 0 ) {
+      return;
+   }
+
+   TRandomMersenne generator(seed);
+
+   double s = ( n > 1 ) ? sqrt(n / log((double) n)) : 1.0;
+   double threshold = 4 * n / s;
+
+   vector<int> left( n );
+   vector<int> sizes;
+
+   for ( int v = 0; v < n; v++ ) {
+      left[v] = v;
+   }
+
+   while ( !left.empty() ) {
+
+      // Sample the nodes left over.
+
+      int before = core.size();
+
+      if ( left.size() <= s ) {
+         core.insert(core.end(), left.begin(), left.end());
+      } else {
+
+         double probability = s / left.size();
+
+         for ( unsigned int i = 0; i < left.size(); i++ ) {
+
+            if ( generator.Random() < probability ) {
+               core.push_back(left[i]);
+            }
+         }
+      }
+
+      if ( rounds != NULL ) {
+         rounds->push_back(core.size() - before);
+      }
+
+      // Keep over the nodes whose clusters are still too big.
+
+      clusterSizes(frozen, core, sizes);
+
+      vector<int> kept;
+
+      for ( unsigned int i = 0; i < left.size(); i++ ) {
+
+         if ( sizes[ left[i] ] > threshold ) {
+            kept.push_back(left[i]);
+         }
+      }
+
+      left.swap(kept);
+   }
+}
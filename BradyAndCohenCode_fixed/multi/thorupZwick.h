@@ -0,0 +1,52 @@
+// thorupZwick.h: Specification for choosing landmarks by Thorup and
+// Zwick's sampling, as Utils.ThorupAndZwickCoreSelection means to.
+//
+// With s = sqrt(n / ln n), start with no landmarks and every node left
+// over.  Each round samples the nodes left over, each with probability
+// s / [number left over] [all of them, once no more than s are left],
+// adds the sample to the landmarks, and keeps over only the nodes whose
+// clusters are still bigger than 4n / s.  The cluster of w is every node
+// v closer to w than to any landmark: d(v, w) < d(v, A).  Clusters only
+// shrink as landmarks are added, so each round need only look at the
+// nodes left from the last, and the rounds end when none are.
+//
+// [The simulator clears the leftover list before looping over it, so it
+// stops after one round, and takes nothing from a list of s or fewer.
+// It also counts the nodes closer to w than w's own landmark, which is
+// w's ball rather than its cluster.]
+//
+// Cluster sizes are found in bulk through the reverse relation: v is in
+// the cluster of w exactly when w is in v's ball, so a search from every
+// v, cut off short of its distance to the landmarks, counts one toward
+// the cluster of each node it reaches.  That costs the total size of the balls, rather than a
+// full search per node.  The searches are ballSearches, split across
+// threads as the routingScheme's are, with each thread keeping counts of
+// its own.
+
+#ifndef _THORUP_ZWICK_H
+#define _THORUP_ZWICK_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+// Nodes per batch of cluster searches handed to a thread.
+
+#define CLUSTER_BATCH 64
+
+// Set sizes[w] to the number of nodes v of 'frozen' [w included] with
+// d(v, w) less than the distance from v to the nearest of 'centers'.
+
+void clusterSizes( const frozenGraph& frozen, const vector<int>& centers,
+                   vector<int>& sizes );
+
+// Set 'core' to landmarks sampled from 'frozen', in the order sampled.
+// 'rounds', if not NULL, is set to the number of nodes sampled in each
+// round.
+
+void thorupZwickCore( const frozenGraph& frozen, unsigned int seed,
+                      vector<int>& core, vector<int>* rounds );
+
+#endif
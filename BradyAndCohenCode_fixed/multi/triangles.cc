@@ -0,0 +1,309 @@
+// triangles.cc: Definitions for exact triangle counting and clustering
+// coefficients of a frozenGraph.
+
+#include "triangles.h"
+#include "parallel.h"
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// --------------------------
+// Sorted-list intersection.
+// --------------------------
+
+// Add 1 to triangles[w] for each w in both a[0 .. aSize - 1] and
+// b[0 .. bSize - 1], both sorted without repeats, and return how many
+// there were.
+
+static long long intersect( const int* a, int aSize, const int* b, int bSize,
+                            long long* triangles ) {
+
+   long long found = 0;
+   int i = 0;
+   int j = 0;
+
+#ifdef __SSE2__
+
+   // Compare four elements of each list against each other, rotating b's
+   // four through every lane, then step past whichever block ends lower.
+
+   while ( i + 4 <= aSize && j + 4 <= bSize ) {
+
+      __m128i blockA = _mm_loadu_si128( (const __m128i*) (a + i) );
+      __m128i blockB = _mm_loadu_si128( (const __m128i*) (b + j) );
+
+      __m128i match = _mm_cmpeq_epi32(blockA, blockB);
+
+      match = _mm_or_si128( match, _mm_cmpeq_epi32(blockA,
+                               _mm_shuffle_epi32(blockB, 0x39)) );
+      match = _mm_or_si128( match, _mm_cmpeq_epi32(blockA,
+                               _mm_shuffle_epi32(blockB, 0x4E)) );
+      match = _mm_or_si128( match, _mm_cmpeq_epi32(blockA,
+                               _mm_shuffle_epi32(blockB, 0x93)) );
+
+      int lanes = _mm_movemask_ps( _mm_castsi128_ps(match) );
+
+      for ( int k = 0; lanes != 0; k++, lanes >>= 1 ) {
+
+         if ( lanes & 1 ) {
+            __atomic_add_fetch(&triangles[ a[i + k] ], 1, __ATOMIC_RELAXED);
+            found++;
+         }
+      }
+
+      int lastA = a[i + 3];
+      int lastB = b[j + 3];
+
+      if ( lastA <= lastB ) {
+         i += 4;
+      }
+
+      if ( lastB <= lastA ) {
+         j += 4;
+      }
+   }
+
+#endif
+
+   while ( i < aSize && j < bSize ) {
+
+      if ( a[i] < b[j] ) {
+
+         i++;
+
+      } else if ( b[j] < a[i] ) {
+
+         j++;
+
+      } else {
+
+         __atomic_add_fetch(&triangles[ a[i] ], 1, __ATOMIC_RELAXED);
+         found++;
+         i++;
+         j++;
+      }
+   }
+
+   return found;
+}
+
+// ----------------------
+// Oriented simple graph.
+// ----------------------
+
+// Out-neighbors of node u in the oriented simple graph are
+// outNeighbors[outOffsets[u] .. outOffsets[u + 1] - 1], by dense index.
+
+typedef struct {
+
+   vector<int> outOffsets;
+   vector<int> outNeighbors;
+
+} orientedGraph;
+
+// Node u comes before v in the orientation if it has lower degree, or the
+// same degree and a lower index.
+
+static inline bool before( const vector<int>& degree, int u, int v ) {
+   return degree[u] < degree[v] || ( degree[u] == degree[v] && u < v );
+}
+
+static void orient( const frozenGraph& frozen, vector<int>& degree,
+                    orientedGraph& oriented ) {
+
+   int n = frozen.nodeSize();
+
+   // First the distinct neighbors of each node, sorted, without the node
+   // itself.
+
+   vector<int> offsets( n + 1, 0 );
+   vector<int> neighbors;
+
+   neighbors.reserve( frozen.adjacency.size() );
+
+   for ( int u = 0; u < n; u++ ) {
+
+      int start = neighbors.size();
+
+      for ( int j = frozen.offsets[u]; j < frozen.offsets[u + 1]; j++ ) {
+
+         if ( frozen.adjacency[j] != u ) {
+            neighbors.push_back(frozen.adjacency[j]);
+         }
+      }
+
+      sort( neighbors.begin() + start, neighbors.end() );
+      neighbors.erase( unique(neighbors.begin() + start, neighbors.end()),
+                       neighbors.end() );
+
+      offsets[u + 1] = neighbors.size();
+   }
+
+   degree.resize(n);
+
+   for ( int u = 0; u < n; u++ ) {
+      degree[u] = offsets[u + 1] - offsets[u];
+   }
+
+   // Then keep only the neighbors each node comes before.
+
+   oriented.outOffsets.assign( n + 1, 0 );
+   oriented.outNeighbors.clear();
+   oriented.outNeighbors.reserve( neighbors.size() / 2 );
+
+   for ( int u = 0; u < n; u++ ) {
+
+      for ( int j = offsets[u]; j < offsets[u + 1]; j++ ) {
+
+         if ( before(degree, u, neighbors[j]) ) {
+            oriented.outNeighbors.push_back(neighbors[j]);
+         }
+      }
+
+      oriented.outOffsets[u + 1] = oriented.outNeighbors.size();
+   }
+}
+
+// ----------
+// Counting.
+// ----------
+
+// One thread's view of the count.  Threads take batches of nodes from
+// 'nextNode' until there are none left.
+
+typedef struct {
+
+   const orientedGraph* oriented;
+   long long* triangles;
+   int* nextNode;
+   int nodeSize;
+
+   long long found;
+
+} triangleJob;
+
+static void* triangleMain( void* arg ) {
+
+   triangleJob* job = (triangleJob*) arg;
+
+   const vector<int>& outOffsets = job->oriented->outOffsets;
+   const int* outNeighbors = job->oriented->outNeighbors.empty() ?
+                             NULL : &(job->oriented->outNeighbors[0]);
+
+   job->found = 0;
+
+   while ( true ) {
+
+      int first = __atomic_fetch_add(job->nextNode, TRIANGLE_BATCH,
+                                     __ATOMIC_RELAXED);
+
+      if ( first >= job->nodeSize ) {
+         break;
+      }
+
+      int last = min(first + TRIANGLE_BATCH, job->nodeSize);
+
+      for ( int u = first; u < last; u++ ) {
+
+         // Each triangle u -> v -> w with u -> w turns up once, here.
+
+         for ( int j = outOffsets[u]; j < outOffsets[u + 1]; j++ ) {
+
+            int v = outNeighbors[j];
+
+            long long found = intersect(
+               outNeighbors + outOffsets[u], outOffsets[u + 1] - outOffsets[u],
+               outNeighbors + outOffsets[v], outOffsets[v + 1] - outOffsets[v],
+               job->triangles );
+
+            if ( found > 0 ) {
+               __atomic_add_fetch(&job->triangles[u], found, __ATOMIC_RELAXED);
+               __atomic_add_fetch(&job->triangles[v], found, __ATOMIC_RELAXED);
+               job->found += found;
+            }
+         }
+      }
+   }
+
+   return NULL;
+}
+
+void countTriangles( const frozenGraph& frozen, triangleIndex& index ) {
+
+   int n = frozen.nodeSize();
+
+   orientedGraph oriented;
+
+   orient(frozen, index.degree, oriented);
+
+   index.triangles.assign(n, 0);
+   index.total = 0;
+
+   int nextNode = 0;
+
+   vector<triangleJob> jobs( jobCount(oriented.outNeighbors.size(),
+                                      TRIANGLE_BATCH) );
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+
+      jobs[i].oriented = &oriented;
+      jobs[i].triangles = n > 0 ? &index.triangles[0] : NULL;
+      jobs[i].nextNode = &nextNode;
+      jobs[i].nodeSize = n;
+   }
+
+   runJobs(jobs, triangleMain);
+
+   for ( unsigned int i = 0; i < jobs.size(); i++ ) {
+      index.total += jobs[i].found;
+   }
+}
+
+// ------------------
+// Accessor functions.
+// ------------------
+
+long long triangleIndex::wedges( void ) const {
+
+   long long count = 0;
+
+   for ( unsigned int i = 0; i < degree.size(); i++ ) {
+      count += (long long) degree[i] * (degree[i] - 1) / 2;
+   }
+
+   return count;
+}
+
+double triangleIndex::globalClustering( void ) const {
+
+   long long paths = wedges();
+
+   return ( paths > 0 ) ? 3.0 * total / paths : 0.0;
+}
+
+double triangleIndex::localClustering( int node ) const {
+
+   if ( degree[node] < 2 ) {
+      return 0.0;
+   }
+
+   return triangles[node] / ( (double) degree[node] * (degree[node] - 1) / 2 );
+}
+
+double triangleIndex::averageClustering( void ) const {
+
+   if ( degree.empty() ) {
+      return 0.0;
+   }
+
+   double sum = 0.0;
+
+   for ( unsigned int i = 0; i < degree.size(); i++ ) {
+      sum += localClustering(i);
+   }
+
+   return sum / degree.size();
+}
@@ -0,0 +1,79 @@
+// triangles.h: Specification for exact triangle counting and clustering
+// coefficients of a frozenGraph.
+//
+// Triangles are counted in the simple graph underneath the multiGraph:
+// loops are dropped and each set of parallel edges counts as one edge, so
+// three nodes form at most one triangle and a node's degree here is its
+// number of distinct neighbors other than itself.  [The analyzer's cycle
+// counts go the other way and count every loop and parallel edge, since
+// they're about the multigraph's structure; clustering is about who
+// neighbors whom.]
+//
+// Each edge is oriented from the endpoint of lower degree to the higher
+// [ties by dense index], which leaves every node with few out-neighbors,
+// and each triangle is then found exactly once, as the intersection of
+// the out-neighbor lists at the two ends of one of its edges.  Lists are
+// intersected by merging, four elements at a time with SSE2 where it's
+// available.  Nodes are split across threads in small batches taken as
+// each thread finishes its last.
+
+#ifndef _TRIANGLES_H
+#define _TRIANGLES_H
+
+#include <vector>
+
+#include "frozenGraph.h"
+
+using namespace std;
+
+// Nodes per batch handed to a thread.
+
+#define TRIANGLE_BATCH 256
+
+class triangleIndex {
+
+   public:
+
+      // --------------------
+      // Public data members.
+      // --------------------
+
+      // Triangles through each node [by dense index], and each node's
+      // number of distinct neighbors.
+
+      vector<long long> triangles;
+      vector<int> degree;
+
+      // Total number of triangles.
+
+      long long total;
+
+      // ------------------
+      // Accessor functions.
+      // ------------------
+
+      // Number of paths of length 2 [wedges]: the sum over nodes of
+      // degree * (degree - 1) / 2.
+
+      long long wedges( void ) const;
+
+      // 3 * triangles / wedges [transitivity], or 0 if there are no wedges.
+
+      double globalClustering( void ) const;
+
+      // Local clustering coefficient of a node: triangles through it over
+      // pairs of its neighbors, or 0 if it has fewer than two neighbors.
+
+      double localClustering( int node ) const;
+
+      // Mean local clustering over all nodes, those of degree < 2
+      // included as 0.
+
+      double averageClustering( void ) const;
+};
+
+// Count the triangles of 'frozen'.
+
+void countTriangles( const frozenGraph& frozen, triangleIndex& index );
+
+#endif
@@ -0,0 +1,356 @@
+// updateLog.cc: Definitions for the compact binary update log.
+
+#include "updateLog.h"
+
+#include <cstdio>
+#include <cstring>
+
+// Number of operands per update, indexed by opcode.
+
+static const int operandCount[] = { 0, 0, 1, 2, 2, 0 };
+
+// Zigzag coding maps small differences of either sign to small unsigned
+// values: 0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+
+static unsigned int zigzag( int value ) {
+   return ((unsigned int) value << 1) ^ (unsigned int) (value >> 31);
+}
+
+static int unzigzag( unsigned int value ) {
+   return (int) (value >> 1) ^ -(int) (value & 1);
+}
+
+// -------------
+// Constructors.
+// -------------
+
+updateLogWriter::updateLogWriter() {
+
+   runOpcode = 0;
+   runCount = 0;
+   lastFirst = 0;
+}
+
+// -----------------
+// File management.
+// -----------------
+
+bool updateLogWriter::open( const char* filename ) {
+
+   close();
+
+   if ( !output.open(filename) ) {
+      return false;
+   }
+
+   output.put(UPDATE_LOG_MAGIC, strlen(UPDATE_LOG_MAGIC));
+
+   runOpcode = 0;
+   runCount = 0;
+   runOperands.clear();
+   lastFirst = 0;
+
+   return true;
+}
+
+void updateLogWriter::close( void ) {
+
+   if ( !output.isOpen() ) {
+      return;
+   }
+
+   endRun();
+   output.close();
+}
+
+// Log the outcome of one recorded update.  See updateRecorder.h for which
+// fields each opcode fills in.
+
+void updateLogWriter::write( const updateRecord& u ) {
+
+   switch ( u.opcode ) {
+
+   case UPDATE_ADD_NODE:
+
+      append(LOG_ADD_NODE);
+      break;
+
+   case UPDATE_DELETE_NODE:
+
+      append(LOG_DELETE_NODE, u.node_1);
+      break;
+
+   case UPDATE_DELETE_RANDOM_NODE:
+   case UPDATE_DELETE_RANDOM_NODE_BY_ATTRIBUTE:
+
+      append(LOG_DELETE_NODE, u._node_1);
+      break;
+
+   case UPDATE_ADD_EDGE:
+
+      append(LOG_ADD_EDGE, u.node_1, u.node_2);
+      break;
+
+   case UPDATE_ADD_RANDOM_EDGE_FROM_NODE:
+   case UPDATE_ADD_RANDOM_EDGE_FROM_NODE_BY_ATTRIBUTE:
+
+      // The given node is the first endpoint; only the second is resolved.
+
+      if ( u._node_2 != -1 ) {
+         append(LOG_ADD_EDGE, u.node_1, u._node_2);
+      }
+      break;
+
+   case UPDATE_ADD_RANDOM_EDGE:
+   case UPDATE_ADD_RANDOM_EDGE_BY_ATTRIBUTE:
+   case UPDATE_ADD_RANDOM_EDGE_BETWEEN_ATTRIBUTES:
+   case UPDATE_ADD_RANDOM_NEW_EDGE:
+
+      append(LOG_ADD_EDGE, u._node_1, u._node_2);
+      break;
+
+   case UPDATE_DELETE_EDGE:
+
+      append(LOG_DELETE_EDGE, u.node_1, u.node_2);
+      break;
+
+   case UPDATE_DELETE_EDGE_BY_ID:
+   case UPDATE_DELETE_RANDOM_EDGE:
+   case UPDATE_DELETE_RANDOM_EDGE_FROM_NODE:
+   case UPDATE_DELETE_RANDOM_EDGE_BY_ATTRIBUTE:
+
+      // Edge IDs don't survive a round trip through a snapshot, so even a
+      // deletion by ID is logged by its endpoints.
+
+      append(LOG_DELETE_EDGE, u._node_1, u._node_2);
+      break;
+
+   case UPDATE_INC_TIME:
+
+      append(LOG_INC_TIME);
+      break;
+
+   default:
+      break;
+
+   } // end switch ( opcode )
+}
+
+void updateLogWriter::endRun( void ) {
+
+   if ( runCount == 0 ) {
+      return;
+   }
+
+   output.put( (char) runOpcode );
+   putVarint(runCount);
+
+   for ( unsigned int i = 0; i < runOperands.size(); i++ ) {
+      putVarint(runOperands[i]);
+   }
+
+   runOpcode = 0;
+   runCount = 0;
+   runOperands.clear();
+}
+
+// ------------------------
+// Private member functions.
+// ------------------------
+
+void updateLogWriter::append( int opcode ) {
+
+   if ( opcode != runOpcode || runCount == UPDATE_LOG_MAX_RUN ) {
+      endRun();
+      runOpcode = opcode;
+   }
+
+   runCount++;
+}
+
+void updateLogWriter::append( int opcode, int operand ) {
+
+   if ( operand < 0 ) {
+      return;
+   }
+
+   append(opcode);
+   runOperands.push_back( zigzag(operand - lastFirst) );
+
+   lastFirst = operand;
+}
+
+void updateLogWriter::append( int opcode, int operand_1, int operand_2 ) {
+
+   if ( operand_1 < 0 || operand_2 < 0 ) {
+      return;
+   }
+
+   append(opcode);
+   runOperands.push_back( zigzag(operand_1 - lastFirst) );
+   runOperands.push_back(operand_2);
+
+   lastFirst = operand_1;
+}
+
+void updateLogWriter::putVarint( unsigned int value ) {
+
+   while ( value >= 0x80 ) {
+      output.put( (char) ((value & 0x7f) | 0x80) );
+      value >>= 7;
+   }
+
+   output.put( (char) value );
+}
+
+// ----------------
+// Replay.
+// ----------------
+
+// Decode one varint at 'position', advancing it.  Returns false if the
+// data runs out first.
+
+static bool getVarint( const vector<unsigned char>& data,
+                        unsigned int& position, unsigned int& value ) {
+
+   value = 0;
+
+   for ( int shift = 0; shift < 35; shift += 7 ) {
+
+      if ( position >= data.size() ) {
+         return false;
+      }
+
+      unsigned char byte = data[position++];
+
+      value |= (unsigned int) (byte & 0x7f) << shift;
+
+      if ( !(byte & 0x80) ) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+long replayUpdateLog( const char* filename, multiGraph* G ) {
+
+   // Slurp the whole file; logs are small.
+
+   FILE* file = fopen(filename, "rb");
+
+   if ( file == NULL ) {
+      return -1;
+   }
+
+   vector<unsigned char> data;
+   unsigned char block[65536];
+   size_t length;
+
+   while ( (length = fread(block, 1, sizeof(block), file)) > 0 ) {
+      data.insert(data.end(), block, block + length);
+   }
+
+   fclose(file);
+
+   unsigned int magicLength = strlen(UPDATE_LOG_MAGIC);
+
+   if ( data.size() < magicLength
+         || memcmp(&data[0], UPDATE_LOG_MAGIC, magicLength) != 0 ) {
+      return -1;
+   }
+
+   long applied = 0;
+
+   unsigned int position = magicLength;
+
+   vector<int> operands;
+
+   int lastFirst = 0;
+
+   while ( position < data.size() ) {
+
+      int opcode = data[position++];
+
+      if ( opcode < LOG_ADD_NODE || opcode > LOG_INC_TIME ) {
+         return -1;
+      }
+
+      unsigned int count;
+
+      if ( !getVarint(data, position, count) ) {
+         return -1;
+      }
+
+      // The writer never builds a longer run, and every operand takes at
+      // least a byte, so a count beyond either is damage; catch it before
+      // it turns into a huge allocation.
+
+      int width = operandCount[opcode];
+
+      if ( count == 0 || count > UPDATE_LOG_MAX_RUN
+            || (size_t) count * width > data.size() - position ) {
+         return -1;
+      }
+
+      // Decode the whole run before applying any of it.
+
+      operands.resize( (size_t) count * width );
+
+      for ( unsigned int i = 0; i < operands.size(); i++ ) {
+
+         unsigned int value;
+
+         if ( !getVarint(data, position, value) ) {
+            return -1;
+         }
+
+         if ( i % width == 0 ) {
+            lastFirst += unzigzag(value);
+            operands[i] = lastFirst;
+         } else {
+            operands[i] = value;
+         }
+      }
+
+      switch ( opcode ) {
+
+      case LOG_ADD_NODE:
+
+         G->addNodes(count);
+         break;
+
+      case LOG_DELETE_NODE:
+
+         G->deleteNodes(operands);
+         break;
+
+      case LOG_ADD_EDGE:
+
+         G->addEdges(operands);
+         break;
+
+      case LOG_DELETE_EDGE:
+
+         // Which edge goes depends on what's left between the endpoints,
+         // so these stay one at a time.
+
+         for ( unsigned int i = 0; i < operands.size(); i += 2 ) {
+            G->deleteEdge(operands[i], operands[i + 1]);
+         }
+         break;
+
+      case LOG_INC_TIME:
+
+         for ( unsigned int i = 0; i < count; i++ ) {
+            G->incTime();
+         }
+         break;
+
+      } // end switch ( opcode )
+
+      applied += count;
+   }
+
+   return applied;
+}
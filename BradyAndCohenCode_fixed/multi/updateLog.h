@@ -0,0 +1,137 @@
+// updateLog.h: Specification for the compact binary update log, an
+// alternative to recording update sequences as XML.
+//
+// Every update is logged by its outcome rather than by the call that
+// produced it: a random edge addition is logged as the edge that was
+// actually added, a random node deletion as the node that was actually
+// deleted, and so on.  Replaying a log therefore doesn't depend on the
+// random number generator, and comes down to five operations:
+//
+//    LOG_ADD_NODE                      [no operands]
+//    LOG_DELETE_NODE    ID
+//    LOG_ADD_EDGE       node_1 node_2
+//    LOG_DELETE_EDGE    node_1 node_2  [delete _some_ edge between them]
+//    LOG_INC_TIME                      [no operands]
+//
+// Random operations that failed [changed nothing] aren't logged at all.
+//
+// File layout: the 8-byte header UPDATE_LOG_MAGIC, then a sequence of
+// runs.  A run is one opcode byte, the number of updates in the run, and
+// that many operand lists, back to back.  Counts and operands are LEB128
+// varints [7 bits per byte, high bit set on all but the last].
+// Consecutive updates with the same opcode share a run, which is what lets
+// the replay hand each run to a single bulk graph operation.
+//
+// An update's first operand is stored as the [zigzag-encoded] difference
+// from the previous update's first operand, whatever its opcode; the
+// second operand is stored as is.  A growing graph keeps naming its newest
+// node first, so most first operands take a single byte.
+
+#ifndef _UPDATE_LOG_H
+#define _UPDATE_LOG_H
+
+#include <vector>
+
+#include "multiGraph.h"
+#include "outputBuffer.h"
+#include "updateRecorder.h"
+
+using namespace std;
+
+#define UPDATE_LOG_MAGIC "MGUPLOG1"
+
+// Longest run the writer will build before starting a new one, so the
+// pending run [and the replay's decoding buffer] stays small.
+
+#define UPDATE_LOG_MAX_RUN 65536
+
+enum logOpcode {
+
+   LOG_ADD_NODE = 1,
+   LOG_DELETE_NODE,
+   LOG_ADD_EDGE,
+   LOG_DELETE_EDGE,
+   LOG_INC_TIME
+};
+
+class updateLogWriter {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Create a closed log.  Call open() before writing.
+
+      updateLogWriter();
+
+      // --------------
+      // Destructor.
+      // --------------
+
+      ~updateLogWriter() {
+         close();
+      }
+
+      // Open a log file for writing, overwriting any preexisting file with
+      // this name, and write the header.  Returns false if the file
+      // couldn't be opened.
+
+      bool open( const char* filename );
+
+      bool isOpen() const {
+         return output.isOpen();
+      }
+
+      // Finish the pending run and close the file.
+
+      void close( void );
+
+      // Log the outcome of one recorded update.
+
+      void write( const updateRecord& update );
+
+      // Finish the pending run, so everything written so far is in the
+      // output buffer.
+
+      void endRun( void );
+
+   private:
+
+      // Not copyable.
+
+      updateLogWriter( const updateLogWriter& );
+      updateLogWriter& operator=( const updateLogWriter& );
+
+      outputBuffer output;
+
+      // The run being built: its opcode [0 if none], length, and operands.
+
+      int runOpcode;
+      int runCount;
+      vector<unsigned int> runOperands;
+
+      // First operand of the last update logged, for delta coding.
+
+      int lastFirst;
+
+      // Add one update to the pending run, starting a new run if the opcode
+      // changes.  IDs are never negative, so an update naming a negative ID
+      // can't have changed anything and is dropped.
+
+      void append( int opcode );
+      void append( int opcode, int operand );
+      void append( int opcode, int operand_1, int operand_2 );
+
+      void putVarint( unsigned int value );
+};
+
+// Apply every update in a binary log to G, one bulk operation per run.
+// Returns the number of updates applied, or -1 if the file couldn't be
+// read, isn't an update log, or is truncated [in which case everything
+// before the damage has still been applied].
+
+long replayUpdateLog( const char* filename, multiGraph* G );
+
+#endif
@@ -0,0 +1,414 @@
+// updateRecorder.cc: Definitions for the recording pipeline behind
+// multiGraphManager's update sequences.
+
+#include "updateRecorder.h"
+#include "updateLog.h"
+
+#include <sched.h>
+#include <sys/time.h>
+
+#define RING_MASK (RECORDER_RING_SIZE - 1)
+
+// Wake a sleeping writer once the ring is this full.  Below that it picks
+// records up on its own polling interval, so a slow producer doesn't pay
+// for a wakeup on every push.
+
+#define WAKE_THRESHOLD (RECORDER_RING_SIZE / 4)
+
+// How long [in microseconds] the writer sleeps on an empty ring before
+// checking again.
+
+#define WRITER_POLL_USEC 1000
+
+// Seed a record with 'unused' markers for every field.
+
+void initUpdate( updateRecord& update, updateOpcode opcode ) {
+
+   update.opcode = opcode;
+   update.structure = 0;
+
+   update.attribute_1 = '\0';
+   update.attribute_2 = '\0';
+
+   update.node_1 = -1;
+   update.node_2 = -1;
+   update._node_1 = -1;
+   update._node_2 = -1;
+
+   update.value_1 = 0;
+   update.value_2 = 0;
+}
+
+// -------------
+// Constructors.
+// -------------
+
+updateRecorder::updateRecorder() {
+
+   output = NULL;
+   log = NULL;
+   ring = NULL;
+
+   head = 0;
+   tail = 0;
+
+   running = false;
+   stopping = 0;
+   sleeping = 0;
+}
+
+// Start the writer thread.
+
+void updateRecorder::start( void ) {
+
+   if ( running ) {
+      return;
+   }
+
+   if ( ring == NULL ) {
+      ring = new updateRecord[RECORDER_RING_SIZE];
+   }
+
+   head = 0;
+   tail = 0;
+   stopping = 0;
+   sleeping = 0;
+
+   pthread_mutex_init(&lock, NULL);
+   pthread_cond_init(&wakeup, NULL);
+
+   if ( pthread_create(&writerThread, NULL, writerMain, this) == 0 ) {
+
+      running = true;
+
+   } else {
+
+      // No thread to be had; keep recording synchronously.
+
+      pthread_cond_destroy(&wakeup);
+      pthread_mutex_destroy(&lock);
+   }
+}
+
+// Drain everything pushed so far and stop the writer thread.
+
+void updateRecorder::stop( void ) {
+
+   if ( !running ) {
+      return;
+   }
+
+   __atomic_store_n(&stopping, 1, __ATOMIC_SEQ_CST);
+   wakeWriter();
+
+   pthread_join(writerThread, NULL);
+
+   pthread_cond_destroy(&wakeup);
+   pthread_mutex_destroy(&lock);
+
+   running = false;
+}
+
+// Record an update.
+
+void updateRecorder::push( const updateRecord& update ) {
+
+   if ( !running ) {
+      serialize(update);
+      return;
+   }
+
+   unsigned long position = head;
+
+   // Back-pressure: if the writer has fallen a full ring behind, make sure
+   // it's awake and give it the CPU until there's room.
+
+   while ( position - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)
+            >= RECORDER_RING_SIZE ) {
+
+      wakeWriter();
+      sched_yield();
+   }
+
+   ring[position & RING_MASK] = update;
+
+   __atomic_store_n(&head, position + 1, __ATOMIC_SEQ_CST);
+
+   if ( __atomic_load_n(&sleeping, __ATOMIC_SEQ_CST)
+         && position + 1 - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)
+            >= WAKE_THRESHOLD ) {
+
+      wakeWriter();
+   }
+}
+
+// Block until every record pushed so far has been serialized.
+
+void updateRecorder::drain( void ) {
+
+   if ( !running ) {
+      return;
+   }
+
+   wakeWriter();
+
+   while ( __atomic_load_n(&tail, __ATOMIC_ACQUIRE) != head ) {
+      sched_yield();
+   }
+}
+
+// ------------------------
+// Private member functions.
+// ------------------------
+
+void updateRecorder::wakeWriter( void ) {
+
+   pthread_mutex_lock(&lock);
+   pthread_cond_signal(&wakeup);
+   pthread_mutex_unlock(&lock);
+}
+
+// Writer thread: serialize records in batches as they arrive, sleeping
+// while the ring is empty.  Exits once told to stop and fully drained.
+
+void* updateRecorder::writerMain( void* arg ) {
+
+   updateRecorder* self = (updateRecorder*) arg;
+
+   unsigned long position = self->tail;
+
+   while ( true ) {
+
+      unsigned long available = __atomic_load_n(&self->head, __ATOMIC_ACQUIRE);
+
+      if ( position != available ) {
+
+         while ( position != available ) {
+
+            self->serialize( self->ring[position & RING_MASK] );
+            position++;
+         }
+
+         // Publish progress only after the batch is in the output buffer,
+         // so drain() can't return early.
+
+         __atomic_store_n(&self->tail, position, __ATOMIC_RELEASE);
+         continue;
+      }
+
+      if ( __atomic_load_n(&self->stopping, __ATOMIC_SEQ_CST) ) {
+         break;
+      }
+
+      // Nothing to do.  Announce we're asleep before re-checking the ring,
+      // so a producer that fills it past the threshold is sure to see the
+      // flag and wake us.
+
+      pthread_mutex_lock(&self->lock);
+
+      __atomic_store_n(&self->sleeping, 1, __ATOMIC_SEQ_CST);
+
+      if ( __atomic_load_n(&self->head, __ATOMIC_SEQ_CST) == position
+            && !__atomic_load_n(&self->stopping, __ATOMIC_SEQ_CST) ) {
+
+         struct timeval now;
+         struct timespec deadline;
+
+         gettimeofday(&now, NULL);
+
+         long usec = now.tv_usec + WRITER_POLL_USEC;
+
+         deadline.tv_sec = now.tv_sec + usec / 1000000;
+         deadline.tv_nsec = (usec % 1000000) * 1000;
+
+         pthread_cond_timedwait(&self->wakeup, &self->lock, &deadline);
+      }
+
+      __atomic_store_n(&self->sleeping, 0, __ATOMIC_SEQ_CST);
+
+      pthread_mutex_unlock(&self->lock);
+   }
+
+   return NULL;
+}
+
+void updateRecorder::serialize( const updateRecord& update ) {
+
+   if ( log != NULL ) {
+      log->write(update);
+   } else if ( output != NULL ) {
+      writeXml(update);
+   }
+}
+
+// Serialize one record as an XML update tag, exactly as the wrapped
+// operations used to write it directly.
+
+void updateRecorder::writeXml( const updateRecord& u ) {
+
+   outputBuffer& out = *output;
+
+   switch ( u.opcode ) {
+
+   case UPDATE_ADD_NODE:
+
+      out << "   <addNode/>\n";
+      break;
+
+   case UPDATE_DELETE_NODE:
+
+      out << "   <deleteNode ID=\"" << u.node_1 << "\"/>\n";
+      break;
+
+   case UPDATE_DELETE_RANDOM_NODE:
+
+      if ( u.structure ) {
+         out << "   <deleteRandomNode _ID=\"" << u._node_1 << "\"/>\n";
+      } else {
+         out << "   <deleteRandomNode/>\n";
+      }
+      break;
+
+   case UPDATE_DELETE_RANDOM_NODE_BY_ATTRIBUTE:
+
+      out << "   <deleteRandomNode attribute=\"" << u.attribute_1
+          << "\" value=\"" << u.value_1;
+
+      if ( u.structure ) {
+         out << "\" _ID=\"" << u._node_1;
+      }
+
+      out << "\"/>\n";
+      break;
+
+   case UPDATE_ADD_EDGE:
+
+      out << "   <addEdge node_1=\"" << u.node_1 << "\" "
+          << "node_2=\"" << u.node_2 << "\"/>\n";
+      break;
+
+   case UPDATE_ADD_RANDOM_EDGE:
+
+      if ( u.structure ) {
+         out << "   <addRandomEdge _node_1=\"" << u._node_1 << "\" "
+             << "_node_2=\"" << u._node_2 << "\"/>\n";
+      } else {
+         out << "   <addRandomEdge/>\n";
+      }
+      break;
+
+   case UPDATE_ADD_RANDOM_EDGE_FROM_NODE:
+
+      if ( u.structure ) {
+         out << "   <addRandomEdge node_1=\"" << u.node_1 << "\" "
+             << "_node_2=\"" << u._node_2 << "\"/>\n";
+      } else {
+         out << "   <addRandomEdge node_1=\"" << u.node_1 << "\"/>\n";
+      }
+      break;
+
+   case UPDATE_ADD_RANDOM_EDGE_BY_ATTRIBUTE:
+
+      out << "   <addRandomEdge attribute=\"" << u.attribute_1
+          << "\" value=\"" << u.value_1;
+
+      if ( u.structure ) {
+         out << "\" _node_1=\"" << u._node_1
+             << "\" _node_2=\"" << u._node_2;
+      }
+
+      out << "\"/>\n";
+      break;
+
+   case UPDATE_ADD_RANDOM_EDGE_FROM_NODE_BY_ATTRIBUTE:
+
+      out << "   <addRandomEdge "
+          << "node_1=\"" << u.node_1
+          << "\" attribute=\"" << u.attribute_1
+          << "\" value=\"" << u.value_1;
+
+      if ( u.structure ) {
+         out << "\" _node_2=\"" << u._node_2;
+      }
+
+      out << "\"/>\n";
+      break;
+
+   case UPDATE_ADD_RANDOM_EDGE_BETWEEN_ATTRIBUTES:
+   case UPDATE_ADD_RANDOM_NEW_EDGE:
+
+      if ( u.opcode == UPDATE_ADD_RANDOM_NEW_EDGE ) {
+         out << "   <addRandomNewEdge attribute_1=\"";
+      } else {
+         out << "   <addRandomEdge attribute_1=\"";
+      }
+
+      out << u.attribute_1 << "\" value_1=\""
+          << u.value_1 << "\" attribute_2=\""
+          << u.attribute_2 << "\" value_2=\""
+          << u.value_2;
+
+      if ( u.structure ) {
+         out << "\" _node_1=\"" << u._node_1
+             << "\" _node_2=\"" << u._node_2;
+      }
+
+      out << "\"/>\n";
+      break;
+
+   case UPDATE_DELETE_EDGE:
+
+      out << "   <deleteEdge node_1=\"" << u.node_1
+          << "\" node_2=\"" << u.node_2 << "\"/>\n";
+      break;
+
+   case UPDATE_DELETE_EDGE_BY_ID:
+
+      out << "   <deleteEdge ID=\"" << u.node_1 << "\"/>\n";
+      break;
+
+   case UPDATE_DELETE_RANDOM_EDGE:
+
+      if ( u.structure ) {
+         out << "   <deleteRandomEdge _node_1=\"" << u._node_1
+             << "\" _node_2=\"" << u._node_2 << "\"/>\n";
+      } else {
+         out << "   <deleteRandomEdge/>\n";
+      }
+      break;
+
+   case UPDATE_DELETE_RANDOM_EDGE_FROM_NODE:
+
+      out << "   <deleteRandomEdge node=\"" << u.node_1;
+
+      if ( u.structure ) {
+         out << "\" _node_1=\"" << u._node_1
+             << "\" _node_2=\"" << u._node_2;
+      }
+
+      out << "\"/>\n";
+      break;
+
+   case UPDATE_DELETE_RANDOM_EDGE_BY_ATTRIBUTE:
+
+      out << "   <deleteRandomEdge attribute=\"" << u.attribute_1
+          << "\" value=\"" << u.value_1;
+
+      if ( u.structure ) {
+         out << "\" _node_1=\"" << u._node_1
+             << "\" _node_2=\"" << u._node_2;
+      }
+
+      out << "\"/>\n";
+      break;
+
+   case UPDATE_INC_TIME:
+
+      out << "   <incTime/>\n";
+      break;
+
+   default:
+      break;
+
+   } // end switch ( opcode )
+}
@@ -0,0 +1,179 @@
+// updateRecorder.h: Specification for the recording pipeline behind
+// multiGraphManager's update sequences.
+//
+// Each recorded graph operation is captured as a small fixed-size
+// updateRecord.  Records are either serialized on the spot, or - once
+// start() has been called - pushed through a lock-free single-producer
+// ring buffer to a writer thread, which does the formatting off the
+// mutation path.
+
+#ifndef _UPDATE_RECORDER_H
+#define _UPDATE_RECORDER_H
+
+#include <pthread.h>
+
+#include "outputBuffer.h"
+
+class updateLogWriter;
+
+// Number of records the ring buffer holds.  Must be a power of two.
+
+#define RECORDER_RING_SIZE (1 << 16)
+
+// One opcode per wrapped operation [and per variant of it, where the
+// variants record different fields].
+
+enum updateOpcode {
+
+   UPDATE_ADD_NODE,
+   UPDATE_DELETE_NODE,
+   UPDATE_DELETE_RANDOM_NODE,
+   UPDATE_DELETE_RANDOM_NODE_BY_ATTRIBUTE,
+   UPDATE_ADD_EDGE,
+   UPDATE_ADD_RANDOM_EDGE,
+   UPDATE_ADD_RANDOM_EDGE_FROM_NODE,
+   UPDATE_ADD_RANDOM_EDGE_BY_ATTRIBUTE,
+   UPDATE_ADD_RANDOM_EDGE_FROM_NODE_BY_ATTRIBUTE,
+   UPDATE_ADD_RANDOM_EDGE_BETWEEN_ATTRIBUTES,
+   UPDATE_ADD_RANDOM_NEW_EDGE,
+   UPDATE_DELETE_EDGE,
+   UPDATE_DELETE_EDGE_BY_ID,
+   UPDATE_DELETE_RANDOM_EDGE,
+   UPDATE_DELETE_RANDOM_EDGE_FROM_NODE,
+   UPDATE_DELETE_RANDOM_EDGE_BY_ATTRIBUTE,
+   UPDATE_INC_TIME
+};
+
+// A single recorded update.
+//
+//    node_1, node_2:   caller-supplied node [or edge] IDs, -1 if unused.
+//    _node_1, _node_2: IDs resolved by the graph for random operations
+//                      [deleted node, endpoints of the added/deleted edge;
+//                      also the endpoints for a deletion by edge ID],
+//                      -1 if unused or unsuccessful.
+//    attribute_*, value_*: attribute constraints, '\0' if unused.
+//    structure:        nonzero if the resolved IDs are to be written out,
+//                      i.e. structureInfo was on when this was recorded.
+
+typedef struct {
+
+   unsigned char opcode;
+   unsigned char structure;
+
+   char attribute_1;
+   char attribute_2;
+
+   int node_1;
+   int node_2;
+   int _node_1;
+   int _node_2;
+
+   double value_1;
+   double value_2;
+
+} updateRecord;
+
+// Seed a record with 'unused' markers for every field.
+
+void initUpdate( updateRecord& update, updateOpcode opcode );
+
+class updateRecorder {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Create a synchronous recorder with no output attached.
+
+      updateRecorder();
+
+      // --------------
+      // Destructor.
+      // --------------
+
+      ~updateRecorder() {
+
+         stop();
+         delete [] ring;
+      }
+
+      // Attach the buffer records are serialized into.
+
+      void setOutput( outputBuffer* output ) {
+         this->output = output;
+      }
+
+      // Attach a binary update log.  While one is attached, records go to
+      // it instead of the output buffer; pass NULL to detach.
+
+      void setLog( updateLogWriter* log ) {
+         this->log = log;
+      }
+
+      // Start the writer thread.  From here on push() only copies the record
+      // into the ring buffer.
+
+      void start( void );
+
+      // Drain everything pushed so far and stop the writer thread.  Later
+      // pushes are serialized synchronously again.
+
+      void stop( void );
+
+      // Record an update.  If the writer thread is running and the ring is
+      // full, block until it makes room [back-pressure].
+
+      void push( const updateRecord& update );
+
+      // Block until every record pushed so far has been serialized into the
+      // output buffer [or log].  Anything else writing to that buffer must call this
+      // first.
+
+      void drain( void );
+
+   private:
+
+      // Not copyable.
+
+      updateRecorder( const updateRecorder& );
+      updateRecorder& operator=( const updateRecorder& );
+
+      outputBuffer* output;
+      updateLogWriter* log;
+
+      // Ring buffer.  'head' is only written by the producer, 'tail' only
+      // by the writer thread; both increase without bound and are masked on
+      // access.
+
+      updateRecord* ring;
+
+      volatile unsigned long head;
+      volatile unsigned long tail;
+
+      // Writer thread state.  'sleeping' is set by the writer while it
+      // waits on 'wakeup' for an empty ring to fill.
+
+      bool running;
+      volatile int stopping;
+      volatile int sleeping;
+
+      pthread_t writerThread;
+      pthread_mutex_t lock;
+      pthread_cond_t wakeup;
+
+      // Wake the writer if it's asleep.
+
+      void wakeWriter( void );
+
+      // Serialize one record to the attached log, or else as an XML update
+      // tag in the output buffer.
+
+      void serialize( const updateRecord& update );
+      void writeXml( const updateRecord& update );
+
+      static void* writerMain( void* arg );
+};
+
+#endif
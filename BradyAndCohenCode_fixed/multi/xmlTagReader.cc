@@ -0,0 +1,616 @@
+// xmlTagReader.cc: Definitions for the tag reader behind
+// multiGraphManager's input parsing.
+
+#include "xmlTagReader.h"
+#include "blockCodec.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// Seed some default values to facilitate structure discovery later on.
+
+void initTag( xmlTag& tag ) {
+
+   tag.attribute = '\0';
+   tag.attribute_1 = '\0';
+   tag.attribute_2 = '\0';
+   tag.graphType = '\0';
+
+   tag.color = -1;
+   tag.ID = -1;
+   tag.node = -1;
+   tag._ID = -1;
+   tag.node_1 = -1;
+   tag._node_1 = -1;
+   tag.node_2 = -1;
+   tag._node_2 = -1;
+   tag.nodeID_1 = -1;
+   tag.nodeID_2 = -1;
+   tag.nodeSize = -1;
+   tag.time = -1;
+   tag.nodeIndex = -1;
+   tag.edgeIndex = -1;
+
+   tag.directed = -1;
+   tag.multi = -1;
+
+   // These'll be picked up only if the 'attribute*' fields contain
+   // relevant data, so their seed values don't matter.
+
+   tag.value = 0;
+   tag.value_1 = 0;
+   tag.value_2 = 0;
+
+   // Set to a hopefully unlikely value to serve later as a marker for
+   // whether or not this has been set.
+
+   tag.weight = WEIGHT_INIT;
+}
+
+// Does the [unterminated] attribute name match 'target'?
+
+static bool nameIs( const char* name, int length, const char* target ) {
+
+   return strncmp(name, target, length) == 0 && target[length] == '\0';
+}
+
+static bool isSpace( char c ) {
+
+   return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// -------------
+// Constructors.
+// -------------
+
+xmlTagReader::xmlTagReader() {
+
+   file = NULL;
+
+   buffer = new char[INPUT_BLOCK_SIZE];
+   current = buffer;
+   end = buffer;
+   bufferOffset = 0;
+
+   atEOF = false;
+   lastOffset = -1;
+
+   compressed = false;
+   nextBlock = 0;
+   decodedIndex = 0;
+   decodedPosition = 0;
+}
+
+xmlTagReader::~xmlTagReader() {
+
+   close();
+
+   delete [] buffer;
+}
+
+// -----------------
+// File management.
+// -----------------
+
+bool xmlTagReader::open( const char* filename ) {
+
+   close();
+
+   file = fopen(filename, "rb");
+
+   if ( file == NULL ) {
+      return false;
+   }
+
+   current = buffer;
+   end = buffer;
+   bufferOffset = 0;
+
+   atEOF = false;
+   lastOffset = -1;
+
+   // Check for a compressed file.
+
+   char magic[BLOCK_FILE_MAGIC_SIZE];
+
+   compressed = ( fread(magic, 1, BLOCK_FILE_MAGIC_SIZE, file)
+                     == BLOCK_FILE_MAGIC_SIZE
+                  && memcmp(magic, BLOCK_FILE_MAGIC,
+                            BLOCK_FILE_MAGIC_SIZE) == 0 );
+
+   blocks.clear();
+   decoded.clear();
+   nextBlock = 0;
+   decodedIndex = 0;
+   decodedPosition = 0;
+
+   if ( compressed ) {
+
+      if ( !readBlockTable() ) {
+         close();
+         return false;
+      }
+
+   } else {
+
+      fseeko(file, 0, SEEK_SET);
+   }
+
+   return true;
+}
+
+void xmlTagReader::close( void ) {
+
+   if ( file != NULL ) {
+      fclose(file);
+      file = NULL;
+   }
+}
+
+bool xmlTagReader::seek( long long offset ) {
+
+   if ( file == NULL ) {
+      return false;
+   }
+
+   if ( compressed ) {
+
+      // Find the last block starting at or before the offset, and start
+      // decompressing there.
+
+      unsigned int low = 0;
+      unsigned int high = blocks.size();
+
+      while ( high - low > 1 ) {
+
+         unsigned int middle = (low + high) / 2;
+
+         if ( blocks[middle].rawOffset <= offset ) {
+            low = middle;
+         } else {
+            high = middle;
+         }
+      }
+
+      decoded.clear();
+      decodedIndex = 0;
+      decodedPosition = 0;
+      nextBlock = low;
+
+      if ( !blocks.empty() ) {
+
+         if ( !decodeBatch() ) {
+            return false;
+         }
+
+         long long skip = offset - blocks[low].rawOffset;
+
+         if ( skip > blocks[low].rawLength ) {
+            return false;
+         }
+
+         decodedPosition = skip;
+      }
+
+   } else if ( fseeko(file, offset, SEEK_SET) != 0 ) {
+      return false;
+   }
+
+   current = buffer;
+   end = buffer;
+   bufferOffset = offset;
+
+   atEOF = false;
+
+   return true;
+}
+
+// ---------
+// Reading.
+// ---------
+
+bool xmlTagReader::next( xmlTag& tag ) {
+
+   char* open;
+   char* close;
+
+   // Find a complete tag, refilling the buffer as needed.
+
+   while ( true ) {
+
+      open = (char*) memchr(current, '<', end - current);
+
+      if ( open == NULL ) {
+
+         current = end;
+
+         if ( !refill() ) {
+            return false;
+         }
+
+         continue;
+      }
+
+      current = open;
+
+      close = (char*) memchr(open, '>', end - open);
+
+      if ( close != NULL ) {
+         break;
+      }
+
+      // The tag runs past the end of the buffer.
+
+      if ( !refill() ) {
+         return false;
+      }
+   }
+
+   lastOffset = bufferOffset + (open - buffer);
+   current = close + 1;
+
+   // Grab the tag name.  Save a potential initial / as part of it, i.e.,
+   // the tag name of "</updateSequence>" will be "/updateSequence".
+
+   char* p = open + 1;
+   char* nameStart = p;
+
+   if ( p < close ) {
+      p++;
+   }
+
+   while ( p < close && !isSpace(*p) && !(*p == '/' && p + 1 == close) ) {
+      p++;
+   }
+
+   tag.tagName.assign(nameStart, p - nameStart);
+
+   // Read attribute/value pairs until we run into the end of the tag.
+
+   while ( true ) {
+
+      while ( p < close && isSpace(*p) ) {
+         p++;
+      }
+
+      if ( p >= close || *p == '/' ) {
+         break;
+      }
+
+      const char* attributeName = p;
+
+      while ( p < close && *p != '=' ) {
+         p++;
+      }
+
+      int nameLength = p - attributeName;
+
+      // Skip the equals-sign & quote mark before the value.
+
+      p++;
+
+      if ( p < close && *p == '\"' ) {
+         p++;
+      }
+
+      const char* value = p;
+
+      while ( p < close && *p != '\"' ) {
+         p++;
+      }
+
+      int valueLength = p - value;
+
+      // Skip the quote mark after the value.
+
+      p++;
+
+      setAttribute(tag, attributeName, nameLength, value, valueLength);
+   }
+
+   return true;
+}
+
+// ------------------------
+// Private member functions.
+// ------------------------
+
+bool xmlTagReader::refill( void ) {
+
+   if ( file == NULL || atEOF ) {
+      return false;
+   }
+
+   int remaining = end - current;
+
+   if ( remaining == INPUT_BLOCK_SIZE ) {
+
+      // A single tag the size of the whole buffer; give up on the file.
+
+      return false;
+   }
+
+   memmove(buffer, current, remaining);
+
+   bufferOffset += current - buffer;
+   current = buffer;
+   end = buffer + remaining;
+
+   int length = readInput(end, INPUT_BLOCK_SIZE - remaining);
+
+   if ( length == 0 ) {
+      atEOF = true;
+      return false;
+   }
+
+   end += length;
+
+   return true;
+}
+
+int xmlTagReader::readInput( char* dest, int length ) {
+
+   if ( !compressed ) {
+      return fread(dest, 1, length, file);
+   }
+
+   int copied = 0;
+
+   while ( copied < length ) {
+
+      if ( decodedIndex == decoded.size() ) {
+
+         if ( nextBlock == blocks.size() || !decodeBatch() ) {
+            break;
+         }
+      }
+
+      vector<char>& block = decoded[decodedIndex];
+
+      int chunk = min( length - copied,
+                       (int) (block.size() - decodedPosition) );
+
+      memcpy(dest + copied, &block[decodedPosition], chunk);
+
+      copied += chunk;
+      decodedPosition += chunk;
+
+      if ( decodedPosition == block.size() ) {
+         decodedIndex++;
+         decodedPosition = 0;
+      }
+   }
+
+   return copied;
+}
+
+// Walk the frame headers, noting where each block's data lives.
+
+bool xmlTagReader::readBlockTable( void ) {
+
+   long long rawOffset = 0;
+   long long fileOffset = BLOCK_FILE_MAGIC_SIZE;
+
+   char header[BLOCK_HEADER_SIZE];
+
+   while ( true ) {
+
+      size_t length = fread(header, 1, BLOCK_HEADER_SIZE, file);
+
+      if ( length == 0 ) {
+         return true;
+      }
+
+      if ( length != BLOCK_HEADER_SIZE ) {
+         return false;
+      }
+
+      blockEntry entry;
+
+      readBlockHeader(header, entry.rawLength, entry.packedLength);
+
+      if ( entry.rawLength <= 0 || entry.packedLength <= 0
+            || entry.packedLength > entry.rawLength ) {
+         return false;
+      }
+
+      entry.rawOffset = rawOffset;
+      entry.fileOffset = fileOffset;
+
+      blocks.push_back(entry);
+
+      rawOffset += entry.rawLength;
+      fileOffset += BLOCK_HEADER_SIZE + entry.packedLength;
+
+      if ( fseeko(file, fileOffset, SEEK_SET) != 0 ) {
+         return false;
+      }
+   }
+}
+
+// One block to decompress.
+
+typedef struct {
+
+   const char* packed;
+   int packedLength;
+   char* raw;
+   int rawLength;
+   bool ok;
+
+} decodeJob;
+
+static void* decodeMain( void* arg ) {
+
+   decodeJob* job = (decodeJob*) arg;
+
+   job->ok = unpackBlock(job->packed, job->packedLength, job->raw,
+                         job->rawLength);
+
+   return NULL;
+}
+
+bool xmlTagReader::decodeBatch( void ) {
+
+   int count = min( (int) (blocks.size() - nextBlock),
+                    jobCount(DECODE_BATCH_MAX, 1) );
+
+   if ( count <= 0 ) {
+      return false;
+   }
+
+   // Read the compressed data in one pass [the frames are contiguous],
+   // then decompress the blocks side by side.
+
+   const blockEntry& first = blocks[nextBlock];
+   const blockEntry& last = blocks[nextBlock + count - 1];
+
+   long long span = last.fileOffset + BLOCK_HEADER_SIZE + last.packedLength
+                    - first.fileOffset;
+
+   vector<char> frames(span);
+
+   if ( fseeko(file, first.fileOffset, SEEK_SET) != 0
+         || fread(&frames[0], 1, span, file) != (size_t) span ) {
+      return false;
+   }
+
+   decoded.resize(count);
+
+   vector<decodeJob> jobs(count);
+
+   for ( int i = 0; i < count; i++ ) {
+
+      const blockEntry& entry = blocks[nextBlock + i];
+
+      decoded[i].resize(entry.rawLength);
+
+      jobs[i].packed = &frames[ entry.fileOffset - first.fileOffset
+                                + BLOCK_HEADER_SIZE ];
+      jobs[i].packedLength = entry.packedLength;
+      jobs[i].raw = &decoded[i][0];
+      jobs[i].rawLength = entry.rawLength;
+   }
+
+   runJobs(jobs, decodeMain);
+
+   bool ok = true;
+
+   for ( int i = 0; i < count; i++ ) {
+      ok = ok && jobs[i].ok;
+   }
+
+   nextBlock += count;
+   decodedIndex = 0;
+   decodedPosition = 0;
+
+   return ok;
+}
+
+// Insert the value, typed appropriately, into the proper field in the
+// xmlTag structure.  Values aren't terminated, but they're always followed
+// by a quote mark, which stops atoi() and atof() just the same.
+
+void xmlTagReader::setAttribute( xmlTag& tag, const char* name,
+      int nameLength, const char* value, int valueLength ) {
+
+   char first = ( valueLength > 0 ) ? value[0] : '\0';
+
+   if ( nameIs(name, nameLength, "attribute") ) {
+
+      tag.attribute = first;
+
+   } else if ( nameIs(name, nameLength, "attribute_1") ) {
+
+      tag.attribute_1 = first;
+
+   } else if ( nameIs(name, nameLength, "attribute_2") ) {
+
+      tag.attribute_2 = first;
+
+   } else if ( nameIs(name, nameLength, "graphType") ) {
+
+      tag.graphType = first;
+
+   } else if ( nameIs(name, nameLength, "color") ) {
+
+      tag.color = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "ID") ) {
+
+      tag.ID = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "_ID") ) {
+
+      tag._ID = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "node") ) {
+
+      tag.node = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "node_1") ) {
+
+      tag.node_1 = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "_node_1") ) {
+
+      tag._node_1 = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "node_2") ) {
+
+      tag.node_2 = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "_node_2") ) {
+
+      tag._node_2 = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "nodeID_1") ) {
+
+      tag.nodeID_1 = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "nodeID_2") ) {
+
+      tag.nodeID_2 = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "nodeSize") ) {
+
+      tag.nodeSize = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "time") ) {
+
+      tag.time = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "nodeIndex") ) {
+
+      tag.nodeIndex = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "edgeIndex") ) {
+
+      tag.edgeIndex = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "directed") ) {
+
+      tag.directed = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "multi") ) {
+
+      tag.multi = atoi(value);
+
+   } else if ( nameIs(name, nameLength, "value") ) {
+
+      tag.value = atof(value);
+
+   } else if ( nameIs(name, nameLength, "value_1") ) {
+
+      tag.value_1 = atof(value);
+
+   } else if ( nameIs(name, nameLength, "value_2") ) {
+
+      tag.value_2 = atof(value);
+
+   } else if ( nameIs(name, nameLength, "weight") ) {
+
+      tag.weight = atof(value);
+   }
+}
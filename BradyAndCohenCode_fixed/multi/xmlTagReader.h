@@ -0,0 +1,194 @@
+// xmlTagReader.h: Specification for the tag reader behind
+// multiGraphManager's input parsing.
+//
+// The files we read are a flat sequence of simple tags, one per line, so
+// rather than a general XML parser this just scans a block buffer for the
+// next '<' ... '>' and picks the attributes we know about straight out of
+// it.  Every tag's byte offset is available, and the reader can seek, which
+// is what lets multiGraphManager jump into the middle of a file.
+//
+// Block-compressed files [see blockCodec.h] are recognized by their header
+// and decompressed on the fly, a batch of blocks at a time with one thread
+// per block.  Offsets are always offsets into the uncompressed data.
+
+#ifndef _XML_TAG_READER_H
+#define _XML_TAG_READER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "parallel.h"
+
+using namespace std;
+
+// Size of each input block.  A single tag must fit in one block.
+
+#define INPUT_BLOCK_SIZE (1 << 20)
+
+// Most compressed blocks decompressed at once [one per thread].
+
+#define DECODE_BATCH_MAX THREADS_MAX
+
+// Marker for a weight that was never set.
+
+#define WEIGHT_INIT 42.87597
+
+typedef struct {
+
+   string tagName;
+
+   char attribute;
+   char attribute_1;
+   char attribute_2;
+   char graphType;
+
+   int color;
+   int  ID;
+   int _ID;
+   int node;
+   int  node_1;
+   int _node_1;
+   int  node_2;
+   int _node_2;
+   int  nodeID_1;
+   int  nodeID_2;
+   int nodeSize;
+   int time;
+   int nodeIndex;
+   int edgeIndex;
+
+   short directed;
+   short multi;
+
+   double value;
+   double value_1;
+   double value_2;
+   double weight;
+
+} xmlTag;
+
+// Seed some default values to facilitate structure discovery later on.
+
+void initTag( xmlTag& tag );
+
+class xmlTagReader {
+
+   public:
+
+      // -------------
+      // Constructors.
+      // -------------
+
+      // Create a closed reader.  Call open() before reading.
+
+      xmlTagReader();
+
+      // --------------
+      // Destructor.
+      // --------------
+
+      ~xmlTagReader();
+
+      // -----------------
+      // File management.
+      // -----------------
+
+      // Open a file for reading.  Returns false if it couldn't be opened.
+
+      bool open( const char* filename );
+
+      bool isOpen() const {
+         return file != NULL;
+      }
+
+      void close( void );
+
+      // Continue reading from the given byte offset, which should be that
+      // of a tag's opening '<'.  Returns false if the seek failed.
+
+      bool seek( long long offset );
+
+      // ---------
+      // Reading.
+      // ---------
+
+      // Read the next tag into 'tag' [reset with initTag() first].  The tag
+      // name keeps any leading '/', e.g. "/snapshot".  Returns false at the
+      // end of the file.
+
+      bool next( xmlTag& tag );
+
+      // Byte offset of the last tag returned by next().
+
+      long long tagOffset( void ) const {
+         return lastOffset;
+      }
+
+   private:
+
+      // Not copyable.
+
+      xmlTagReader( const xmlTagReader& );
+      xmlTagReader& operator=( const xmlTagReader& );
+
+      FILE* file;
+
+      // The block buffer, the unread part of it, and the file offset of its
+      // first byte.
+
+      char* buffer;
+      char* current;
+      char* end;
+      long long bufferOffset;
+
+      bool atEOF;
+
+      long long lastOffset;
+
+      // Compressed files: where each block's data starts, uncompressed and
+      // in the file [its frame header], and how long it is either way.
+
+      typedef struct {
+
+         long long rawOffset;
+         long long fileOffset;
+         int rawLength;
+         int packedLength;
+
+      } blockEntry;
+
+      bool compressed;
+      vector<blockEntry> blocks;
+
+      // The next block to decompress, the current batch of decompressed
+      // blocks, and the unread part of it.
+
+      unsigned int nextBlock;
+      vector< vector<char> > decoded;
+      unsigned int decodedIndex;
+      unsigned int decodedPosition;
+
+      // Move the unread data to the front of the buffer and fill the rest
+      // from the file.  Returns false if nothing more could be read.
+
+      bool refill( void );
+
+      // Read up to 'length' bytes of [uncompressed] input.  Returns the
+      // number read, 0 at the end of the file.
+
+      int readInput( char* dest, int length );
+
+      // Compressed files: build the block table, and decompress the next
+      // batch of blocks.
+
+      bool readBlockTable( void );
+      bool decodeBatch( void );
+
+      // Store one attribute/value pair in the tag, if it's one we know.
+
+      void setAttribute( xmlTag& tag, const char* name, int nameLength,
+                         const char* value, int valueLength );
+};
+
+#endif
@@ -3,20 +3,54 @@
 #include "util.h"
 
 #include <time.h>
+#include <pthread.h>
 #include "rand/randomc.h"
 
 
+// Every thread gets a generator of its own on first use, so threads [e.g.
+// the analyzer's batch workers, replaying files with random updates] never
+// share the twister's state.  Each is seeded with the time plus the number
+// of generators made before it, so threads started in the same second
+// still draw different numbers; a thread's generator is deleted when the
+// thread exits.
+
+static pthread_key_t generatorKey;
+static pthread_once_t generatorKeyOnce = PTHREAD_ONCE_INIT;
+static unsigned int generatorCount = 0;
+
+static void deleteGenerator( void* generator ) {
+
+   delete (TRandomMersenne*) generator;
+}
+
+static void makeGeneratorKey( void ) {
+
+   pthread_key_create(&generatorKey, deleteGenerator);
+}
+
 // Return a random integer between 0 and INT_MAX.
 
 int randomNumber() {
 
-   // Instantiate a "Mersenne twister" generator with a timestamp seed.
+   // Instantiate this thread's "Mersenne twister" generator with a
+   // timestamp seed, if it hasn't one yet.
+
+   static __thread TRandomMersenne* generatorInstance = NULL;
+
+   if ( generatorInstance == NULL ) {
 
-   static TRandomMersenne generatorInstance(time(0));
+      unsigned int count = __atomic_fetch_add(&generatorCount, 1,
+                                              __ATOMIC_RELAXED);
+
+      generatorInstance = new TRandomMersenne(time(0) + count);
+
+      pthread_once(&generatorKeyOnce, makeGeneratorKey);
+      pthread_setspecific(generatorKey, generatorInstance);
+   }
 
    // Get an integer in the specified range & return it.
 
-   int value = generatorInstance.IRandom(0, (INT_MAX - 1));
+   int value = generatorInstance->IRandom(0, (INT_MAX - 1));
 
    return(value);
 }
@@ -21,7 +21,8 @@ using namespace __gnu_cxx; // This might be necessary for older GCC versions
 // Utility functions.
 // ------------------
 
-// Return a random integer between 0 and INT_MAX.
+// Return a random integer between 0 and INT_MAX.  Safe to call from
+// several threads at once: each draws from a generator of its own.
 
 int randomNumber();
 